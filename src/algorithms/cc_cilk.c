@@ -2,7 +2,7 @@
  * @file cc_cilk.c
  * @brief Optimized OpenCilk implementations for computing connected components.
  *
- * This module implements two parallel algorithms for finding connected
+ * This module implements six parallel algorithms for finding connected
  * components in an undirected graph using OpenCilk:
  *
  * - Label Propagation (variant 0): Iteratively propagates minimum labels
@@ -11,16 +11,40 @@
  * - Union-Find with Rem's Algorithm (variant 1): Lock-free parallel
  *   union-find using compare-and-swap operations and dynamic task scheduling.
  *
- * Both algorithms return the count of unique connected components.
+ * - Afforest (variant 2): union-find that links a few sampled neighbours
+ *   of every vertex first, finds the giant component by sampling, and then
+ *   only links the edges that leave it.
+ *
+ * - FastSV (variant 3): Shiloach-Vishkin style hooking and shortcutting
+ *   on parent and grandparent arrays, converging in O(log n) rounds
+ *   where label propagation needs as many sweeps as the diameter.
+ *
+ * - Frontier label propagation (variant 5): label propagation that only
+ *   relaxes the columns of nodes whose label changed in the previous
+ *   round, switching between a queue and a bitmap of them.
+ *
+ * - Pointer-jumping label propagation (variant 6): label propagation
+ *   sweeps separated by shortcut rounds (label[v] = label[label[v]])
+ *   that pass labels down whole chains at once.
+ *
+ * All kernels leave every node labelled with the smallest node of its
+ * component; finalize() then counts and sizes the components in parallel.
+ * When the matrix carries compressed row indices (see packed.h), the
+ * kernels decode them on the fly instead of reading row_idx.
  */
 
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <errno.h>
 #include <cilk/cilk.h>
 #include <cilk/cilk_api.h>
 
 #include "connected_components.h"
+#include "mem.h"
+#include "packed.h"
+#include "parallel.h"
+#include "error.h"
 
 /* ========================================================================== */
 /*                           UNION-FIND UTILITIES                             */
@@ -38,10 +62,10 @@
  * @param x Node index to find the root for
  * @return Root of the set containing x
  */
-static inline uint32_t
-find_compress(uint32_t *label, uint32_t x)
+static inline csc_idx_t
+find_compress(csc_idx_t *label, csc_idx_t x)
 {
-	uint32_t root = x;
+	csc_idx_t root = x;
 	
 	/* Find the root */
 	while (label[root] != root)
@@ -49,7 +73,7 @@ find_compress(uint32_t *label, uint32_t x)
 	
 	/* Compress the path */
 	while (x != root) {
-		uint32_t next = label[x];
+		csc_idx_t next = label[x];
 		if (label[x] == next)
 			break;  /* Already compressed */
 		label[x] = root;
@@ -72,7 +96,7 @@ find_compress(uint32_t *label, uint32_t x)
  * @param b Second node
  */
 static inline void
-union_rem(uint32_t *label, uint32_t a, uint32_t b)
+union_rem(csc_idx_t *label, csc_idx_t a, csc_idx_t b)
 {
 	const int MAX_RETRIES = 10;
 	
@@ -86,12 +110,12 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 		
 		/* Canonical ordering: smaller index as root */
 		if (a > b) {
-			uint32_t temp = a;
+			csc_idx_t temp = a;
 			a = b;
 			b = temp;
 		}
 		
-		uint32_t expected = b;
+		csc_idx_t expected = b;
 		if (__atomic_compare_exchange_n(&label[b], &expected, a,
 		                                0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 			return;
@@ -105,7 +129,7 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 	b = find_compress(label, b);
 	if (a != b) {
 		if (a > b) {
-			uint32_t temp = a;
+			csc_idx_t temp = a;
 			a = b;
 			b = temp;
 		}
@@ -123,59 +147,89 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
  * Algorithm phases:
  * 1. Initialize each node as its own root (parallel with cilk_for)
  * 2. Perform parallel union operations on edges
- * 3. Flatten all paths to roots for accurate counting (parallel)
- * 4. Count roots in parallel using atomic increments
+ * 3. Point every node straight at its root (parallel)
  *
  * @param matrix Sparse CSC binary matrix representing graph
- * @return Number of connected components, or -1 on error
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (1)
  */
-static int
-cc_union_find(const CSCBinaryMatrix *matrix)
+static unsigned int
+cc_union_find(const CSCBinaryMatrix *matrix, csc_idx_t *label)
 {
-	if (!matrix || matrix->nrows == 0)
-		return 0;
+	const csc_idx_t n = (csc_idx_t)matrix->nrows;
 	
-	const uint32_t n = (uint32_t)matrix->nrows;
-	uint32_t *label = malloc(n * sizeof(uint32_t));
-	if (!label)
-		return -1;
-	
-	/* Initialize: each node as its own parent */
-	cilk_for (uint32_t i = 0; i < n; i++)
+	/* Initialize: each node as its own parent (in parallel, so first touch
+	 * spreads the pages over the workers that steal the iterations) */
+	cilk_for (csc_idx_t i = 0; i < n; i++)
 		label[i] = i;
 	
 	/* Process all edges: union connected nodes */
-	cilk_for (uint32_t col = 0; col < matrix->ncols; col++) {
-		uint32_t start = matrix->col_ptr[col];
-		uint32_t end = matrix->col_ptr[col + 1];
+	cilk_for (csc_idx_t col = 0; col < matrix->ncols; col++) {
+		if (matrix->packed) {
+			CSCPackedIter it;
+			csc_idx_t row;
+
+			csc_packed_col(matrix->packed, col, &it);
+			while (csc_packed_next(&it, &row))
+				if (row < n)
+					union_rem(label, row, col);
+			continue;
+		}
+
+		csc_ptr_t start = matrix->col_ptr[col];
+		csc_ptr_t end = matrix->col_ptr[col + 1];
 		
-		for (uint32_t j = start; j < end; j++) {
-			uint32_t row = matrix->row_idx[j];
+		for (csc_ptr_t j = start; j < end; j++) {
+			csc_idx_t row = matrix->row_idx[j];
 			if (row < n)
 				union_rem(label, row, col);
 		}
 	}
 	
-	/* Final compression pass: flatten all paths */
-	cilk_for (uint32_t i = 0; i < n; i++)
-		find_compress(label, i);
-	
-	/* Count roots (each root represents one component) */
-	uint32_t count = 0;
-	cilk_for (uint32_t i = 0; i < n; i++) {
-		if (label[i] == i) {
-			__atomic_fetch_add(&count, 1, __ATOMIC_RELAXED);
-		}
+	/* Flatten all trees. Concurrent writes only ever store a root, so
+	 * every chain a worker follows still ends at one */
+	cilk_for (csc_idx_t i = 0; i < n; i++) {
+		csc_idx_t root = label[i];
+		while (label[root] != root)
+			root = label[root];
+		label[i] = root;
 	}
-	
-	free(label);
-	return (int)count;
+
+	return 1;
 }
 
 /* ========================================================================== */
 /*                       LABEL PROPAGATION ALGORITHM                          */
 /* ========================================================================== */
 
+/**
+ * @brief Relaxes one edge (row, col) towards the smaller label.
+ *
+ * @param label Label array
+ * @param col Column node of the edge
+ * @param row Row node of the edge
+ * @return 1 if the labels differed (one of them was lowered), 0 otherwise
+ */
+static inline uint8_t
+relax_edge(csc_idx_t *label, size_t col, csc_idx_t row)
+{
+	csc_idx_t label_col = label[col];
+	csc_idx_t label_row = label[row];
+	
+	if (label_col == label_row)
+		return 0;
+
+	csc_idx_t min_label = label_col < label_row ? label_col : label_row;
+	
+	/* Update labels with relaxed atomics */
+	if (label_col != min_label)
+		__atomic_store_n(&label[col], min_label, __ATOMIC_RELAXED);
+	else
+		__atomic_store_n(&label[row], min_label, __ATOMIC_RELAXED);
+	
+	return 1;
+}
+
 /**
  * @brief Computes connected components using parallel label propagation.
  *
@@ -184,53 +238,42 @@ cc_union_find(const CSCBinaryMatrix *matrix)
  * 2. Iterate over all edges in parallel, propagating minimum labels
  * 3. Use relaxed atomic operations to update labels
  * 4. Repeat until no labels change (convergence)
- * 5. Count unique components using bitmap with hardware popcount
  *
  * Key optimization: Per-column processing with per-worker local change
  * flags minimizes atomic operations while maintaining correctness.
  *
  * @param matrix Sparse CSC binary matrix representing graph
- * @return Number of connected components, or -1 on error
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (sweeps until no label changed)
  */
-static int
-cc_label_propagation(const CSCBinaryMatrix *matrix)
+static unsigned int
+cc_label_propagation(const CSCBinaryMatrix *matrix, csc_idx_t *label)
 {
-	if (!matrix || matrix->nrows == 0)
-		return 0;
-	
-	uint32_t *label = malloc(sizeof(uint32_t) * matrix->nrows);
-	if (!label)
-		return -1;
-	
 	/* Initialize: each node labeled with its own index */
-	for (size_t i = 0; i < matrix->nrows; i++)
+	cilk_for (size_t i = 0; i < matrix->nrows; i++)
 		label[i] = i;
 	
 	/* Iterate until convergence */
 	uint8_t finished;
+	unsigned int sweeps = 0;
 	do {
 		finished = 1;
+		sweeps++;
 		
 		/* Per-column processing with per-worker local change flag */
 		cilk_for (size_t col = 0; col < matrix->ncols; col++) {
 			uint8_t local_changed = 0;
 			
-			for (uint32_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
-				uint32_t row = matrix->row_idx[j];
-				uint32_t label_col = label[col];
-				uint32_t label_row = label[row];
-				
-				if (label_col != label_row) {
-					uint32_t min_label = label_col < label_row ? label_col : label_row;
-					
-					/* Update labels with relaxed atomics */
-					if (label_col != min_label)
-						__atomic_store_n(&label[col], min_label, __ATOMIC_RELAXED);
-					else
-						__atomic_store_n(&label[row], min_label, __ATOMIC_RELAXED);
-					
-					local_changed = 1;
-				}
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, col, &it);
+				while (csc_packed_next(&it, &row))
+					local_changed |= relax_edge(label, col, row);
+			} else {
+				for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++)
+					local_changed |= relax_edge(label, col, matrix->row_idx[j]);
 			}
 			
 			/* Mark global flag if any change occurred in this worker */
@@ -239,34 +282,1065 @@ cc_label_propagation(const CSCBinaryMatrix *matrix)
 		}
 		
 	} while (!finished);
-	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (matrix->nrows + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
+
+	return sweeps;
+}
+
+/* ========================================================================== */
+/*                           AFFOREST ALGORITHM                               */
+/* ========================================================================== */
+
+/** Neighbours of every vertex linked before the giant component is sampled */
+#define AFFOREST_ROUNDS 2
+
+/** Vertices sampled to find the giant component */
+#define AFFOREST_SAMPLES 1024
+
+/**
+ * @brief Returns the k-th stored row of column @p col, or CSC_IDX_MAX if
+ *        the column has no more than @p k entries.
+ */
+static inline csc_idx_t
+nth_row(const CSCBinaryMatrix *matrix, csc_idx_t col, unsigned int k)
+{
+	if (matrix->packed) {
+		CSCPackedIter it;
+		csc_idx_t row;
+
+		csc_packed_col(matrix->packed, col, &it);
+		for (unsigned int i = 0; csc_packed_next(&it, &row); i++)
+			if (i == k)
+				return row;
+		return CSC_IDX_MAX;
+	}
+
+	csc_ptr_t j = matrix->col_ptr[col] + k;
+	return j < matrix->col_ptr[col + 1] ? matrix->row_idx[j] : CSC_IDX_MAX;
+}
+
+/**
+ * @brief Links edge (row, col) unless both ends are already in the giant
+ *        component.
+ *
+ * @param label Array of parent pointers
+ * @param n Number of nodes
+ * @param row Row node of the edge
+ * @param col Column node of the edge
+ * @param col_in_giant Whether col was in the giant component
+ * @param giant Root of the giant component
+ */
+static inline void
+link_edge(csc_idx_t *label, csc_idx_t n, csc_idx_t row, csc_idx_t col,
+          int col_in_giant, csc_idx_t giant)
+{
+	if (row >= n)
+		return;
+	if (col_in_giant && label[row] == giant)
+		return;
+	union_rem(label, row, col);
+}
+
+/**
+ * @brief Points every node straight at its root, in parallel.
+ */
+static void
+compress_all(csc_idx_t *label, csc_idx_t n)
+{
+	cilk_for (csc_idx_t i = 0; i < n; i++) {
+		csc_idx_t root = label[i];
+		while (label[root] != root)
+			root = label[root];
+		label[i] = root;
+	}
+}
+
+/**
+ * @brief Returns the most frequent root among AFFOREST_SAMPLES nodes drawn
+ *        with a fixed-seed xorshift generator.
+ *
+ * @param label Flat label array (every node holding its root)
+ * @param n Number of nodes (> 0)
+ */
+static csc_idx_t
+sample_frequent_root(const csc_idx_t *label, csc_idx_t n)
+{
+	csc_idx_t sample[AFFOREST_SAMPLES];
+	uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+	for (unsigned int i = 0; i < AFFOREST_SAMPLES; i++) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		sample[i] = label[state % n];
+	}
+	qsort(sample, AFFOREST_SAMPLES, sizeof(csc_idx_t), csc_idx_cmp);
+
+	/* Longest run of the sorted sample */
+	csc_idx_t best = sample[0];
+	unsigned int best_run = 0;
+	for (unsigned int i = 0; i < AFFOREST_SAMPLES; ) {
+		unsigned int j = i + 1;
+		while (j < AFFOREST_SAMPLES && sample[j] == sample[i])
+			j++;
+		if (j - i > best_run) {
+			best_run = j - i;
+			best = sample[i];
+		}
+		i = j;
+	}
+
+	return best;
+}
+
+/**
+ * @brief Tells whether @p col is stored in column @p row, by binary search
+ *        over the sorted rows of a normalized matrix.
+ */
+static inline int
+has_entry(const CSCBinaryMatrix *matrix, csc_idx_t row, csc_idx_t col)
+{
+	csc_ptr_t lo = matrix->col_ptr[row];
+	csc_ptr_t hi = matrix->col_ptr[row + 1];
+
+	while (lo < hi) {
+		csc_ptr_t mid = lo + (hi - lo) / 2;
+		if (matrix->row_idx[mid] < col)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < matrix->col_ptr[row + 1] && matrix->row_idx[lo] == col;
+}
+
+/**
+ * @brief Tells whether every edge of a matrix is stored in both of its
+ *        columns, so that a node's column lists all of its neighbours.
+ *
+ * Afforest then skips giant component columns whole and frontier label
+ * propagation relaxes the active columns only.
+ *
+ * Only unpacked, square matrices with full storage qualify. A matrix
+ * mirrored by construction (a fully expanded symmetric input) is taken as
+ * is; a normalized one is checked (O(nnz log degree), once per plan); for
+ * any other matrix the answer is 0, which is always safe.
+ */
+static int
+edges_mirrored(const CSCBinaryMatrix *matrix)
+{
+	if (matrix->half || matrix->packed || matrix->nrows != matrix->ncols)
+		return 0;
+	if (matrix->mirrored)
+		return 1;
+	if (!matrix->normalized)
+		return 0;
+
+	int mirrored = 1;
+	cilk_for (csc_idx_t col = 0; col < matrix->ncols; col++) {
+		for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+			if (!__atomic_load_n(&mirrored, __ATOMIC_RELAXED))
+				break;
+			if (!has_entry(matrix, matrix->row_idx[j], col))
+				__atomic_store_n(&mirrored, 0, __ATOMIC_RELAXED);
+		}
 	}
+
+	return mirrored;
+}
+
+/**
+ * @brief Computes connected components with Afforest-style sampling.
+ *
+ * Algorithm phases:
+ * 1. Initialize each node as its own root (parallel with cilk_for)
+ * 2. Link the first AFFOREST_ROUNDS neighbours of every column, flattening
+ *    the trees after each round; on graphs with a giant component this
+ *    already puts most nodes into it
+ * 3. Sample the labels to find the root of the giant component
+ * 4. Link the remaining edges, skipping those whose ends are both in the
+ *    giant component: they need neither a find nor a CAS
+ * 5. Point every node straight at its root (parallel)
+ *
+ * When every edge is stored in both of its columns (@p mirrored), the
+ * columns of giant component nodes are skipped whole: their edges into
+ * other components are linked from the other side. Otherwise an edge may
+ * be stored in one column only (general or half-stored matrices), so
+ * those columns are still read and their edges out of the giant
+ * component linked.
+ *
+ * @param matrix Sparse CSC binary matrix representing graph
+ * @param mirrored Whether every edge is stored in both of its columns
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (1)
+ */
+static unsigned int
+cc_afforest(const CSCBinaryMatrix *matrix, int mirrored, csc_idx_t *label)
+{
+	const csc_idx_t n = (csc_idx_t)matrix->nrows;
+
+	cilk_for (csc_idx_t i = 0; i < n; i++)
+		label[i] = i;
+
+	/* Sampled neighbours: one edge per column and round */
+	for (unsigned int r = 0; r < AFFOREST_ROUNDS; r++) {
+		cilk_for (csc_idx_t col = 0; col < matrix->ncols; col++) {
+			csc_idx_t row = nth_row(matrix, col, r);
+			if (row < n)
+				union_rem(label, row, col);
+		}
+		compress_all(label, n);
+	}
+
+	const csc_idx_t giant = sample_frequent_root(label, n);
+
+	/* Remaining edges */
+	cilk_for (csc_idx_t col = 0; col < matrix->ncols; col++) {
+		int col_in_giant = (label[col] == giant);
+		if (col_in_giant && mirrored)
+			continue;
+
+		if (matrix->packed) {
+			CSCPackedIter it;
+			csc_idx_t row;
+			unsigned int k = 0;
+
+			csc_packed_col(matrix->packed, col, &it);
+			while (csc_packed_next(&it, &row))
+				if (k++ >= AFFOREST_ROUNDS)
+					link_edge(label, n, row, col, col_in_giant, giant);
+			continue;
+		}
+
+		csc_ptr_t end = matrix->col_ptr[col + 1];
+		for (csc_ptr_t j = matrix->col_ptr[col] + AFFOREST_ROUNDS; j < end; j++)
+			link_edge(label, n, matrix->row_idx[j], col, col_in_giant, giant);
+	}
+
+	compress_all(label, n);
+
+	return 1;
+}
+
+/* ========================================================================== */
+/*                             FASTSV ALGORITHM                               */
+/* ========================================================================== */
+
+/**
+ * @brief Lowers *p to @p value if it is smaller (atomic minimum).
+ */
+static inline void
+write_min(csc_idx_t *p, csc_idx_t value)
+{
+	csc_idx_t cur = __atomic_load_n(p, __ATOMIC_RELAXED);
+
+	while (value < cur &&
+	       !__atomic_compare_exchange_n(p, &cur, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+/**
+ * @brief Hooks one edge (u, v) the FastSV way.
+ *
+ * The end with the larger grandparent takes the smaller one twice:
+ * stochastic hooking lowers its parent's parent, aggressive hooking its
+ * own parent. Parents never exceed their node, so equal grandparents
+ * leave nothing for the edge to do that shortcutting does not.
+ *
+ * @param parent Parent array (f)
+ * @param grand Grandparent array of the previous round (gf)
+ * @param u First node
+ * @param v Second node
+ */
+static inline void
+hook_edge(csc_idx_t *parent, const csc_idx_t *grand, csc_idx_t u, csc_idx_t v)
+{
+	csc_idx_t gu = grand[u];
+	csc_idx_t gv = grand[v];
+
+	if (gu == gv)
+		return;
+	if (gu < gv) {
+		csc_idx_t t = u;
+		u = v;
+		v = t;
+		gv = gu;
+	}
+	write_min(&parent[__atomic_load_n(&parent[u], __ATOMIC_RELAXED)], gv);
+	write_min(&parent[u], gv);
+}
+
+/**
+ * @brief Computes connected components with FastSV.
+ *
+ * Every round:
+ * 1. Hook: for every edge, stochastic and aggressive hooking (hook_edge())
+ * 2. Shortcut: parent[v] = min(parent[v], grand[v])
+ * 3. Recompute grand[v] = parent[parent[v]]; stop when no grandparent
+ *    changed
+ *
+ * Parents only decrease and every round at least halves the distance
+ * between a node and the minimum of its component, so the rounds grow
+ * with log n rather than the diameter. The converged parents hold the
+ * smallest node of every component.
+ *
+ * @param matrix Sparse CSC binary matrix representing graph
+ * @param label Parent array of matrix->nrows entries (overwritten)
+ * @param grand Grandparent array of matrix->nrows entries (overwritten)
+ * @return Rounds until the grandparents converged
+ */
+static unsigned int
+cc_fastsv(const CSCBinaryMatrix *matrix, csc_idx_t *label, csc_idx_t *grand)
+{
+	const csc_idx_t n = (csc_idx_t)matrix->nrows;
+	unsigned int rounds = 0;
+	int changed;
+
+	cilk_for (csc_idx_t i = 0; i < n; i++) {
+		label[i] = i;
+		grand[i] = i;
+	}
+
+	do {
+		rounds++;
+		changed = 0;
+
+		/* Hook */
+		cilk_for (csc_idx_t col = 0; col < matrix->ncols; col++) {
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, col, &it);
+				while (csc_packed_next(&it, &row))
+					if (row < n)
+						hook_edge(label, grand, row, col);
+				continue;
+			}
+
+			for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+				csc_idx_t row = matrix->row_idx[j];
+				if (row < n)
+					hook_edge(label, grand, row, col);
+			}
+		}
+
+		/* Shortcut */
+		cilk_for (csc_idx_t i = 0; i < n; i++)
+			if (grand[i] < label[i])
+				label[i] = grand[i];
+
+		/* Grandparents */
+		cilk_for (csc_idx_t i = 0; i < n; i++) {
+			csc_idx_t g = label[label[i]];
+			if (g != grand[i]) {
+				grand[i] = g;
+				if (!__atomic_load_n(&changed, __ATOMIC_RELAXED))
+					__atomic_store_n(&changed, 1, __ATOMIC_RELAXED);
+			}
+		}
+	} while (changed);
+
+	return rounds;
+}
+
+/* ========================================================================== */
+/*                  POINTER-JUMPING LABEL PROPAGATION                         */
+/* ========================================================================== */
+
+/**
+ * @brief Relaxes one edge (row, col) towards the smaller label, and hooks
+ *        the larger label's own label under the smaller one too.
+ *
+ * Every label is a node of the same component no larger than the node
+ * it labels, so the hook only lowers the label of a node of the same
+ * component. It lets the next shortcut rounds pass the smaller label to
+ * every node that still points at the larger one.
+ *
+ * @return 1 if the labels differed, 0 otherwise
+ */
+static inline uint8_t
+jump_edge(csc_idx_t *label, csc_idx_t col, csc_idx_t row)
+{
+	csc_idx_t label_col = __atomic_load_n(&label[col], __ATOMIC_RELAXED);
+	csc_idx_t label_row = __atomic_load_n(&label[row], __ATOMIC_RELAXED);
+
+	if (label_col == label_row)
+		return 0;
+
+	if (label_col > label_row) {
+		__atomic_store_n(&label[col], label_row, __ATOMIC_RELAXED);
+		write_min(&label[label_col], label_row);
+	} else {
+		__atomic_store_n(&label[row], label_col, __ATOMIC_RELAXED);
+		write_min(&label[label_row], label_col);
+	}
+	return 1;
+}
+
+/**
+ * @brief Relaxes and hooks every edge once, in parallel (see jump_edge()).
+ *
+ * @return 1 if any label changed, 0 otherwise
+ */
+static int
+jump_sweep(const CSCBinaryMatrix *matrix, csc_idx_t *label)
+{
+	const csc_idx_t n = matrix->nrows;
+	uint8_t changed = 0;
 	
-	/* Bitmap construction: set bit for each unique label */
-	for (size_t i = 0; i < matrix->nrows; i++) {
-		uint32_t val = label[i];
-		size_t word = val >> 6;            /* Divide by 64 */
-		uint64_t bit = 1ULL << (val & 63); /* Modulo 64 */
-		bitmap[word] |= bit;
+	cilk_for (csc_idx_t col = 0; col < matrix->ncols; col++) {
+		uint8_t local_changed = 0;
+		
+		if (matrix->packed) {
+			CSCPackedIter it;
+			csc_idx_t row;
+
+			csc_packed_col(matrix->packed, col, &it);
+			while (csc_packed_next(&it, &row))
+				if (row < n)
+					local_changed |= jump_edge(label, col, row);
+		} else {
+			for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+				csc_idx_t row = matrix->row_idx[j];
+				if (row < n)
+					local_changed |= jump_edge(label, col, row);
+			}
+		}
+		
+		if (local_changed)
+			changed = 1;
 	}
 	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++) {
-		count += __builtin_popcountll(bitmap[i]);
+	return changed;
+}
+
+/**
+ * @brief Points every node at its label's label until no label changes.
+ *
+ * Every label is a node of the same component no larger than the node
+ * it labels, so label[label[v]] is one too and never larger than
+ * label[v]. One round therefore halves every chain of labels, and the
+ * rounds stop once every node points at a node labelled with itself.
+ *
+ * @param label Label array of @p n entries
+ * @param n Number of nodes
+ * @return Shortcut rounds, the last of which changed nothing
+ */
+static unsigned int
+shortcut_labels(csc_idx_t *label, const size_t n)
+{
+	unsigned int rounds = 0;
+	uint8_t jumped;
+	
+	do {
+		jumped = 0;
+		rounds++;
+		
+		cilk_for (size_t i = 0; i < n; i++) {
+			csc_idx_t parent = __atomic_load_n(&label[i], __ATOMIC_RELAXED);
+			csc_idx_t grand = __atomic_load_n(&label[parent], __ATOMIC_RELAXED);
+			if (grand < parent) {
+				__atomic_store_n(&label[i], grand, __ATOMIC_RELAXED);
+				jumped = 1;
+			}
+		}
+	} while (jumped);
+	
+	return rounds;
+}
+
+/**
+ * @brief Computes connected components with label propagation sweeps
+ *        separated by pointer-jumping shortcut rounds.
+ *
+ * Algorithm steps:
+ * 1. Initialize each node with its own index as label
+ * 2. Sweep every edge once, propagating minimum labels and hooking the
+ *    larger label's own label under the smaller one (jump_edge())
+ * 3. If a label changed, shortcut the labels until stable
+ *    (label[v] = label[label[v]]) and sweep again
+ *
+ * The hooks link the labels into trees, and the shortcut rounds pass a
+ * root's label to every node below it at once, so long paths need a
+ * number of sweeps closer to the logarithm of their diameter than to
+ * the diameter itself.
+ *
+ * @param matrix Sparse CSC binary matrix representing graph
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @param shortcuts Set to the number of shortcut rounds run
+ * @return Passes over the edges (sweeps until no label changed)
+ */
+static unsigned int
+cc_pointer_jumping(const CSCBinaryMatrix *matrix, csc_idx_t *label, unsigned int *shortcuts)
+{
+	/* Initialize: each node labeled with its own index */
+	cilk_for (size_t i = 0; i < matrix->nrows; i++)
+		label[i] = i;
+	
+	unsigned int sweeps = 0;
+	*shortcuts = 0;
+	for (;;) {
+		sweeps++;
+		if (!jump_sweep(matrix, label))
+			break;
+		*shortcuts += shortcut_labels(label, matrix->nrows);
 	}
 	
-	free(bitmap);
-	free(label);
+	return sweeps;
+}
+
+/* ========================================================================== */
+/*                       FRONTIER LABEL PROPAGATION                           */
+/* ========================================================================== */
+
+/** Rounds whose frontier holds at most 1/FRONTIER_SPARSE of the nodes walk
+ *  its queue; larger frontiers scan its bitmap */
+#define FRONTIER_SPARSE 20
+
+/** Frontier entries or bitmap words per cilk_for iteration */
+#define FRONTIER_CHUNK 64
+
+/** Nodes a thread activates before appending them to the shared queue */
+#define FRONTIER_BUFFER 256
+
+/**
+ * @struct frontier_t
+ * @brief Active nodes of the current and the next round, each kept both as
+ *        a bitmap and as a queue.
+ */
+typedef struct {
+	uint64_t *bits[2];   /* Bitmaps of (nrows + 63) / 64 words */
+	csc_idx_t *queue[2]; /* Queues of nrows entries, each node at most once */
+} frontier_t;
+
+/**
+ * @struct activated_t
+ * @brief One thread's view of the next round's frontier: the nodes it
+ *        activated and has not appended to the shared queue yet.
+ */
+typedef struct {
+	uint64_t *bits;                  /* Next round's bitmap */
+	csc_idx_t *queue;                /* Next round's queue */
+	size_t *tail;                    /* Entries of queue in use (advanced atomically) */
+	csc_idx_t node[FRONTIER_BUFFER]; /* Activated nodes */
+	unsigned int count;              /* Entries of node in use */
+} activated_t;
+
+/**
+ * @brief Appends a thread's activated nodes to the next round's queue with
+ *        one atomic increment of its tail.
+ */
+static inline void
+flush_activated(activated_t *a)
+{
+	size_t at = __atomic_fetch_add(a->tail, a->count, __ATOMIC_RELAXED);
+
+	memcpy(a->queue + at, a->node, a->count * sizeof(csc_idx_t));
+	a->count = 0;
+}
+
+/**
+ * @brief Adds node @p v to the next round's frontier unless it is there
+ *        already.
+ */
+static inline void
+activate(activated_t *a, csc_idx_t v)
+{
+	uint64_t mask = (uint64_t)1 << (v & 63);
+
+	if (__atomic_load_n(&a->bits[v >> 6], __ATOMIC_RELAXED) & mask)
+		return;
+	if (__atomic_fetch_or(&a->bits[v >> 6], mask, __ATOMIC_RELAXED) & mask)
+		return;
+
+	a->node[a->count++] = v;
+	if (a->count == FRONTIER_BUFFER)
+		flush_activated(a);
+}
+
+/**
+ * @brief Relaxes one edge (row, col) towards the smaller label and
+ *        activates the node whose label was lowered.
+ */
+static inline void
+propagate_edge(csc_idx_t *label, csc_idx_t col, csc_idx_t row, activated_t *a)
+{
+	csc_idx_t label_col = __atomic_load_n(&label[col], __ATOMIC_RELAXED);
+	csc_idx_t label_row = __atomic_load_n(&label[row], __ATOMIC_RELAXED);
+
+	if (label_col > label_row) {
+		__atomic_store_n(&label[col], label_row, __ATOMIC_RELAXED);
+		activate(a, col);
+	} else if (label_row > label_col) {
+		__atomic_store_n(&label[row], label_col, __ATOMIC_RELAXED);
+		activate(a, row);
+	}
+}
+
+/**
+ * @brief Relaxes every edge of column @p col (see propagate_edge()).
+ */
+static inline void
+propagate_column(const CSCBinaryMatrix *matrix, csc_idx_t *label, csc_idx_t col,
+                 activated_t *a)
+{
+	const csc_idx_t n = (csc_idx_t)matrix->nrows;
+
+	if (col >= matrix->ncols)
+		return;
+
+	if (matrix->packed) {
+		CSCPackedIter it;
+		csc_idx_t row;
+
+		csc_packed_col(matrix->packed, col, &it);
+		while (csc_packed_next(&it, &row))
+			if (row < n)
+				propagate_edge(label, col, row, a);
+		return;
+	}
+
+	for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+		csc_idx_t row = matrix->row_idx[j];
+		if (row < n)
+			propagate_edge(label, col, row, a);
+	}
+}
+
+/**
+ * @brief Computes connected components with frontier-driven label
+ *        propagation.
+ *
+ * Algorithm steps:
+ * 1. Initialize each node with its own index; every node is active
+ * 2. Relax the columns of the active nodes only. A node whose label is
+ *    lowered becomes active in the next round, once (bitmap test-and-set)
+ * 3. Repeat until no node is active
+ *
+ * The matrix must be mirrored: every active node's column then holds all
+ * of its edges, and every edge whose labels may differ has an end that
+ * was lowered in the previous round. Late rounds therefore cost
+ * O(active edges) instead of O(nnz). The next round's active nodes are
+ * kept both as a bitmap and as a queue: rounds with at most
+ * 1/FRONTIER_SPARSE of the nodes active walk the queue, denser rounds
+ * scan the bitmap a word at a time and skip empty words. Every cilk_for
+ * iteration covers FRONTIER_CHUNK entries or words and appends its
+ * activated nodes once. A lowered label
+ * may be overwritten by a larger one from a stale read, but its node is
+ * active then and the next round lowers it again.
+ *
+ * @param matrix Sparse CSC binary matrix representing graph (mirrored)
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @param frontier Bitmaps and queues of the plan (overwritten)
+ * @return Rounds until no node was active
+ */
+static unsigned int
+cc_frontier_propagation(const CSCBinaryMatrix *matrix, csc_idx_t *label, frontier_t *frontier)
+{
+	const csc_idx_t n = (csc_idx_t)matrix->nrows;
+	const size_t words = ((size_t)n + 63) / 64;
+	unsigned int rounds = 0;
+	size_t count = n;
+	int cur = 0;
+
+	/* Initialize: each node its own label, all active */
+	cilk_for (csc_idx_t i = 0; i < n; i++)
+		label[i] = i;
+	cilk_for (size_t w = 0; w < words; w++) {
+		frontier->bits[0][w] = ~(uint64_t)0;
+		frontier->bits[1][w] = 0;
+	}
+	if (n & 63)
+		frontier->bits[0][words - 1] = ((uint64_t)1 << (n & 63)) - 1;
+
+	while (count > 0) {
+		uint64_t *bits = frontier->bits[cur];
+		csc_idx_t *queue = frontier->queue[cur];
+		const int sparse = count <= n / FRONTIER_SPARSE;
+		const size_t items = sparse ? count : words;
+		size_t tail = 0;
+
+		rounds++;
+
+		cilk_for (size_t chunk = 0; chunk < (items + FRONTIER_CHUNK - 1) / FRONTIER_CHUNK; chunk++) {
+			activated_t a = {
+				.bits = frontier->bits[cur ^ 1],
+				.queue = frontier->queue[cur ^ 1],
+				.tail = &tail,
+				.count = 0
+			};
+			size_t begin = chunk * FRONTIER_CHUNK;
+			size_t end = begin + FRONTIER_CHUNK < items ? begin + FRONTIER_CHUNK : items;
+
+			if (sparse) {
+				for (size_t q = begin; q < end; q++)
+					propagate_column(matrix, label, queue[q], &a);
+			} else {
+				for (size_t w = begin; w < end; w++)
+					for (uint64_t word = bits[w]; word; word &= word - 1)
+						propagate_column(matrix, label, w * 64 + __builtin_ctzll(word), &a);
+			}
+
+			if (a.count)
+				flush_activated(&a);
+		}
+
+		/* Clear this round's bitmap for the round after next */
+		if (sparse) {
+			cilk_for (size_t q = 0; q < count; q++)
+				__atomic_store_n(&bits[queue[q] >> 6], 0, __ATOMIC_RELAXED);
+		} else {
+			cilk_for (size_t w = 0; w < words; w++)
+				bits[w] = 0;
+		}
+
+		count = tail;
+		cur ^= 1;
+	}
+
+	return rounds;
+}
+
+/* ========================================================================== */
+/*                              PREPARED PLANS                                */
+/* ========================================================================== */
+
+/**
+ * @struct CCPlan
+ * @brief Buffers reused by every run of an OpenCilk plan.
+ *
+ * The Cilk runtime keeps its workers between runs by itself. The
+ * finalization splits the nodes into a few blocks per worker, so that
+ * stealing evens out blocks of unequal cost.
+ */
+struct CCPlan {
+	const CSCBinaryMatrix *matrix; /* Matrix the plan runs on */
+	unsigned int variant;          /* Algorithm selection */
+	int mirrored;                  /* Every edge stored in both columns (variants 2 and 5) */
+	csc_idx_t *grand;              /* Grandparent array (FastSV only, nrows entries) */
+	frontier_t frontier;           /* Active nodes (frontier label propagation on mirrored matrices) */
+	unsigned int n_blocks;         /* Node blocks of the finalization */
+	csc_idx_t *label;              /* Label array (nrows entries) */
+	csc_idx_t *size;               /* Component size by root, then dense id by root (nrows entries) */
+	size_t *offset;                /* Roots before each block (n_blocks + 1 entries) */
+	CCSummary *partial;            /* Per-block statistics (n_blocks entries) */
+	CCSummary summary;             /* Statistics of the last run */
+};
+
+/** Finalization blocks per Cilk worker */
+#define BLOCKS_PER_WORKER 4
+
+/**
+ * @copydoc cc_plan_create()
+ */
+CCPlan *
+cc_plan_create(const CSCBinaryMatrix *matrix,
+               const unsigned int n_threads __attribute__((unused)),
+               const unsigned int algorithm_variant)
+{
+	if (!matrix)
+		return NULL;
+	if (algorithm_variant == 4 || algorithm_variant > 6) {
+		print_error(__func__, "variant not implemented by this backend", 0);
+		return NULL;
+	}
+
+	CCPlan *plan = calloc(1, sizeof(*plan));
+	if (!plan) {
+		print_error(__func__, "calloc() failed", errno);
+		return NULL;
+	}
+	plan->matrix = matrix;
+	plan->variant = algorithm_variant;
+	plan->n_blocks = BLOCKS_PER_WORKER * (unsigned int)__cilkrts_get_nworkers();
+
+	const size_t n = matrix->nrows;
+	csc_idx_t *label = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+	csc_idx_t *size = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+	plan->label = label;
+	plan->size = size;
+	if (!label || !size) {
+		print_error(__func__, "mem_alloc() failed", errno);
+		cc_plan_destroy(plan);
+		return NULL;
+	}
+
+	plan->offset = calloc(plan->n_blocks + 1, sizeof(size_t));
+	plan->partial = calloc(plan->n_blocks, sizeof(CCSummary));
+	if (!plan->offset || !plan->partial) {
+		print_error(__func__, "calloc() failed", errno);
+		cc_plan_destroy(plan);
+		return NULL;
+	}
+
+	if (algorithm_variant == 2 || algorithm_variant == 5)
+		plan->mirrored = edges_mirrored(matrix);
+
+	if (algorithm_variant == 3) {
+		plan->grand = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+		if (!plan->grand) {
+			print_error(__func__, "mem_alloc() failed", errno);
+			cc_plan_destroy(plan);
+			return NULL;
+		}
+
+		cilk_for (size_t i = 0; i < n; i++)
+			plan->grand[i] = i;
+	}
+
+	/* Without mirrored storage, frontier label propagation sweeps every column */
+	if (algorithm_variant == 5 && plan->mirrored) {
+		const size_t words = (n + 63) / 64;
+
+		for (int k = 0; k < 2; k++) {
+			plan->frontier.bits[k] = mem_alloc(words * sizeof(uint64_t), &matrix->mem, CSC_ACCESS_RANDOM);
+			plan->frontier.queue[k] = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_SEQUENTIAL);
+			if (!plan->frontier.bits[k] || !plan->frontier.queue[k]) {
+				print_error(__func__, "mem_alloc() failed", errno);
+				cc_plan_destroy(plan);
+				return NULL;
+			}
+		}
+
+		cilk_for (size_t w = 0; w < words; w++) {
+			plan->frontier.bits[0][w] = 0;
+			plan->frontier.bits[1][w] = 0;
+		}
+		cilk_for (size_t i = 0; i < n; i++) {
+			plan->frontier.queue[0][i] = i;
+			plan->frontier.queue[1][i] = i;
+		}
+	}
+
+	/* Fault the pages in now, spread over the workers like the kernels' initialization */
+	cilk_for (size_t i = 0; i < n; i++) {
+		label[i] = i;
+		size[i] = 0;
+	}
+
+	return plan;
+}
+
+/**
+ * @brief Counts the components of a flat labelling and measures their sizes.
+ *
+ * Block b is [par_block_begin(n, B, b), par_block_begin(n, B, b + 1)).
+ * Each block counts its roots (nodes labelled with themselves) and the
+ * prefix sum over the blocks gives every block the dense id of its first
+ * root. Sizes are accumulated by runs of equal labels, so a block adds to
+ * a shared counter once per run rather than once per node.
+ *
+ * @param plan Plan whose size array, offsets and summary are filled
+ * @param label Labels, every node holding the smallest node of its component
+ * @return Number of connected components
+ */
+static size_t
+finalize(CCPlan *plan, const csc_idx_t *label)
+{
+	const size_t n = plan->matrix->nrows;
+	const unsigned int B = plan->n_blocks;
+	csc_idx_t *size = plan->size;
+	size_t *offset = plan->offset;
+	CCSummary *partial = plan->partial;
+
+	/* Clear the sizes and count the roots of each block */
+	cilk_for (unsigned int b = 0; b < B; b++) {
+		size_t begin = par_block_begin(n, B, b);
+		size_t end = par_block_begin(n, B, b + 1);
+		size_t roots = 0;
+
+		for (size_t i = begin; i < end; i++) {
+			size[i] = 0;
+			roots += (label[i] == i);
+		}
+		offset[b + 1] = roots;
+	}
+
+	/* Accumulate the sizes */
+	cilk_for (unsigned int b = 0; b < B; b++) {
+		size_t begin = par_block_begin(n, B, b);
+		size_t end = par_block_begin(n, B, b + 1);
+
+		for (size_t i = begin; i < end; ) {
+			csc_idx_t root = label[i];
+			size_t j = i + 1;
+			while (j < end && label[j] == root)
+				j++;
+			__atomic_fetch_add(&size[root], (csc_idx_t)(j - i), __ATOMIC_RELAXED);
+			i = j;
+		}
+	}
+
+	/* Largest component and size histogram of each block */
+	cilk_for (unsigned int b = 0; b < B; b++) {
+		size_t begin = par_block_begin(n, B, b);
+		size_t end = par_block_begin(n, B, b + 1);
+		CCSummary *p = &partial[b];
+
+		memset(p, 0, sizeof(*p));
+		for (size_t i = begin; i < end; i++) {
+			if (label[i] != i)
+				continue;
+			if (size[i] > p->largest)
+				p->largest = size[i];
+			p->size_histogram[cc_size_bucket(size[i])]++;
+		}
+	}
+
+	/* Prefix sum over the blocks */
+	CCSummary *sum = &plan->summary;
+	memset(sum, 0, sizeof(*sum));
+	offset[0] = 0;
+	for (unsigned int b = 0; b < B; b++) {
+		offset[b + 1] += offset[b];
+		if (partial[b].largest > sum->largest)
+			sum->largest = partial[b].largest;
+		for (unsigned int k = 0; k < CC_SIZE_BUCKETS; k++)
+			sum->size_histogram[k] += partial[b].size_histogram[k];
+	}
+	sum->components = offset[B];
+
+	return sum->components;
+}
+
+/**
+ * @brief Runs the plan's kernel on @p label, then finalize(), and records
+ *        the kernel's passes over the edges.
+ */
+static int
+plan_run(CCPlan *plan, csc_idx_t *label)
+{
+	if (plan->matrix->nrows == 0) {
+		memset(&plan->summary, 0, sizeof(plan->summary));
+		return 0;
+	}
+
+	unsigned int rounds;
+	unsigned int shortcuts = 0;
+	unsigned int fallback = 0;
+
+	switch (plan->variant) {
+	case 0:
+		rounds = cc_label_propagation(plan->matrix, label);
+		break;
+	case 1:
+		rounds = cc_union_find(plan->matrix, label);
+		break;
+	case 2:
+		rounds = cc_afforest(plan->matrix, plan->mirrored, label);
+		fallback = !plan->mirrored;
+		break;
+	case 3:
+		rounds = cc_fastsv(plan->matrix, label, plan->grand);
+		break;
+	case 5:
+		if (plan->mirrored)
+			rounds = cc_frontier_propagation(plan->matrix, label, &plan->frontier);
+		else
+			rounds = cc_label_propagation(plan->matrix, label);
+		fallback = !plan->mirrored;
+		break;
+	case 6:
+		rounds = cc_pointer_jumping(plan->matrix, label, &shortcuts);
+		break;
+	default:
+		return -1;
+	}
+	size_t count = finalize(plan, label);
+	plan->summary.rounds = rounds;
+	plan->summary.shortcut_rounds = shortcuts;
+	plan->summary.fallback = fallback;
 	return (int)count;
 }
 
+/**
+ * @copydoc cc_plan_execute()
+ */
+int
+cc_plan_execute(CCPlan *plan)
+{
+	if (!plan)
+		return -1;
+
+	return plan_run(plan, plan->label);
+}
+
+/**
+ * @copydoc cc_plan_labels()
+ */
+int
+cc_plan_labels(CCPlan *plan, csc_idx_t *labels)
+{
+	if (!plan || !labels)
+		return -1;
+
+	return plan_run(plan, labels);
+}
+
+/**
+ * @copydoc cc_plan_dense_labels()
+ */
+int
+cc_plan_dense_labels(CCPlan *plan, csc_idx_t *labels)
+{
+	if (!plan || !labels)
+		return -1;
+
+	int count = plan_run(plan, labels);
+	if (count <= 0)
+		return count;
+
+	const size_t n = plan->matrix->nrows;
+	const unsigned int B = plan->n_blocks;
+	csc_idx_t *id = plan->size;  /* The sizes are summarized already */
+	const size_t *offset = plan->offset;
+
+	/* Number the roots of each block from its offset */
+	cilk_for (unsigned int b = 0; b < B; b++) {
+		size_t begin = par_block_begin(n, B, b);
+		size_t end = par_block_begin(n, B, b + 1);
+		csc_idx_t next = (csc_idx_t)offset[b];
+
+		for (size_t i = begin; i < end; i++)
+			if (labels[i] == i)
+				id[i] = next++;
+	}
+
+	cilk_for (size_t i = 0; i < n; i++)
+		labels[i] = id[labels[i]];
+
+	return count;
+}
+
+/**
+ * @copydoc cc_plan_summary()
+ */
+const CCSummary *
+cc_plan_summary(const CCPlan *plan)
+{
+	return &plan->summary;
+}
+
+/**
+ * @copydoc cc_plan_destroy()
+ */
+void
+cc_plan_destroy(CCPlan *plan)
+{
+	if (!plan)
+		return;
+
+	mem_free(plan->label, &plan->matrix->mem);
+	mem_free(plan->size, &plan->matrix->mem);
+	mem_free(plan->grand, &plan->matrix->mem);
+	for (int k = 0; k < 2; k++) {
+		mem_free(plan->frontier.bits[k], &plan->matrix->mem);
+		mem_free(plan->frontier.queue[k], &plan->matrix->mem);
+	}
+	free(plan->offset);
+	free(plan->partial);
+	free(plan);
+}
+
 /* ========================================================================== */
 /*                              PUBLIC INTERFACE                              */
 /* ========================================================================== */
@@ -275,30 +1349,50 @@ cc_label_propagation(const CSCBinaryMatrix *matrix)
  * @brief Computes connected components using OpenCilk parallel algorithms.
  *
  * This is the main entry point for OpenCilk connected components computation.
- * It dispatches to one of two algorithm implementations based on the variant
- * parameter.
+ * It runs a one-shot plan, which dispatches to one of the algorithm
+ * implementations based on the variant parameter.
  *
  * Supported variants:
  *   0: Label propagation
  *   1: Union-find with Rem's algorithm
+ *   2: Afforest (sampled union-find skipping the giant component)
+ *   3: FastSV (hooking and shortcutting in O(log n) rounds)
+ *   5: Frontier label propagation (relaxes only the active columns)
+ *   6: Pointer-jumping label propagation (shortcut rounds between sweeps)
  *
  * @param matrix Sparse binary matrix in CSC format
  * @param n_threads Unused (Cilk manages threads automatically)
- * @param algorithm_variant Algorithm selection (0 or 1)
+ * @param algorithm_variant Algorithm selection (0 to 3, 5 or 6)
  * @return Number of connected components, or -1 on error
  */
 int
 cc_cilk(const CSCBinaryMatrix *matrix,
-        const unsigned int n_threads __attribute__((unused)),
+        const unsigned int n_threads,
         const unsigned int algorithm_variant)
 {
-	switch (algorithm_variant) {
-	case 0:
-		return cc_label_propagation(matrix);
-	case 1:
-		return cc_union_find(matrix);
-	default:
-		break;
-	}
-	return -1;
+	CCPlan *plan = cc_plan_create(matrix, n_threads, algorithm_variant);
+	if (!plan)
+		return -1;
+
+	int count = cc_plan_execute(plan);
+	cc_plan_destroy(plan);
+	return count;
+}
+
+/**
+ * @copydoc cc_labels()
+ */
+int
+cc_labels(const CSCBinaryMatrix *matrix,
+          unsigned int n_threads,
+          unsigned int algorithm_variant,
+          csc_idx_t *labels)
+{
+	CCPlan *plan = cc_plan_create(matrix, n_threads, algorithm_variant);
+	if (!plan)
+		return -1;
+
+	int count = cc_plan_labels(plan, labels);
+	cc_plan_destroy(plan);
+	return count;
 }
@@ -2,27 +2,52 @@
  * @file cc_pthreads.c
  * @brief Optimized parallel algorithms for computing connected components using Pthreads.
  *
- * This module implements two parallel algorithms for finding connected
+ * This module implements six parallel algorithms for finding connected
  * components in an undirected graph using Pthreads:
  *
  * - Label Propagation (variant 0): Iterative parallel label propagation
- *   with optimized atomic updates and bitmap-based counting.
+ *   with optimized atomic updates.
  *
  * - Union-Find with Rem's Algorithm (variant 1): Lock-free parallel
  *   union-find using compare-and-swap (CAS) operations and path compression.
  *
+ * - FastSV (variant 3): Shiloach-Vishkin style hooking and shortcutting
+ *   on parent and grandparent arrays, converging in O(log n) rounds
+ *   where label propagation needs as many sweeps as the diameter.
+ *
+ * - Multistep (variant 4): direction-optimizing BFS from the node with
+ *   the most edges, then union-find over the nodes it did not reach.
+ *
+ * - Frontier label propagation (variant 5): label propagation that only
+ *   relaxes the columns of nodes whose label changed in the previous
+ *   round, switching between a queue and a bitmap of them.
+ *
+ * - Pointer-jumping label propagation (variant 6): label propagation
+ *   sweeps separated by shortcut rounds (label[v] = label[label[v]])
+ *   that pass labels down whole chains at once.
+ *
  * Key optimizations:
  * - Label propagation: Conditional atomics to reduce contention
- * - Union-find: Dynamic work scheduling with atomic column counter
+ * - Union-find: Dynamic work scheduling with atomic column counter, or
+ *   static edge-balanced column blocks on pinned threads (CSC_NUMA_LOCAL)
  * - Both: Large chunks to reduce scheduling overhead
+ * - Both: Decode compressed row indices on the fly when present (packed.h)
+ * - Both: Worker threads started once per plan and reused by every phase
+ * - Both: Components counted, numbered and sized by the same threads, in
+ *   their own label slices (finalize())
  */
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <errno.h>
 #include <pthread.h>
 #include <stdatomic.h>
 
 #include "connected_components.h"
+#include "mem.h"
+#include "packed.h"
+#include "error.h"
 
 /* ========================================================================== */
 /*                           UNION-FIND UTILITIES                             */
@@ -40,10 +65,10 @@
  * @param x Node index to find the root for
  * @return Root of the set containing x
  */
-static inline uint32_t
-find_compress(uint32_t *label, uint32_t x)
+static inline csc_idx_t
+find_compress(csc_idx_t *label, csc_idx_t x)
 {
-	uint32_t root = x;
+	csc_idx_t root = x;
 	
 	/* Find the root */
 	while (label[root] != root)
@@ -51,7 +76,7 @@ find_compress(uint32_t *label, uint32_t x)
 	
 	/* Compress the path */
 	while (x != root) {
-		uint32_t next = label[x];
+		csc_idx_t next = label[x];
 		if (label[x] == next)
 			break;  /* Already compressed */
 		label[x] = root;
@@ -74,7 +99,7 @@ find_compress(uint32_t *label, uint32_t x)
  * @param b Second node
  */
 static inline void
-union_rem(uint32_t *label, uint32_t a, uint32_t b)
+union_rem(csc_idx_t *label, csc_idx_t a, csc_idx_t b)
 {
 	const int MAX_RETRIES = 10;
 	
@@ -88,12 +113,12 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 		
 		/* Canonical ordering: smaller index as root */
 		if (a > b) {
-			uint32_t temp = a;
+			csc_idx_t temp = a;
 			a = b;
 			b = temp;
 		}
 		
-		uint32_t expected = b;
+		csc_idx_t expected = b;
 		if (__atomic_compare_exchange_n(&label[b], &expected, a,
 		                                0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 			return;
@@ -107,7 +132,7 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 	b = find_compress(label, b);
 	if (a != b) {
 		if (a > b) {
-			uint32_t temp = a;
+			csc_idx_t temp = a;
 			a = b;
 			b = temp;
 		}
@@ -115,6 +140,235 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
 	}
 }
 
+/* ========================================================================== */
+/*                               WORKER POOL                                  */
+/* ========================================================================== */
+
+struct pool;
+
+/**
+ * @struct pool_slot_t
+ * @brief Identity of one pool worker.
+ */
+typedef struct {
+	struct pool *pool;  /* Owning pool */
+	unsigned int id;    /* Share this worker runs, in [1, n_threads) */
+} pool_slot_t;
+
+/**
+ * @struct pool_t
+ * @brief Worker threads kept alive across the phases and runs of a plan.
+ *
+ * The caller runs share 0 of every task and workers 1..n_workers the
+ * others. Shares whose worker could not be started are run by the caller
+ * too, so a task always completes; like par_run(), tasks must therefore
+ * not wait on each other. A pinned pool keeps the thread of share i on
+ * the CPU of mem_pin_thread(i) until pool_stop().
+ */
+typedef struct pool {
+	pthread_mutex_t lock;
+	pthread_cond_t start;       /* Broadcast when a task is posted */
+	pthread_cond_t done;        /* Signalled when the last worker finishes */
+	unsigned long generation;   /* Tasks posted so far */
+	unsigned int pending;       /* Workers still running the current task */
+	int quit;                   /* Set by pool_stop() */
+	int pin;                    /* Threads pinned with mem_pin_thread() */
+	void *(*fn)(void *);        /* Current task */
+	char *args;                 /* Argument of share 0 */
+	size_t stride;              /* Bytes between the arguments of consecutive shares (0: shared) */
+	unsigned int n_threads;     /* Shares per task */
+	unsigned int n_workers;     /* Workers started (at most n_threads - 1) */
+	pthread_t *threads;         /* Worker threads */
+	pool_slot_t *slots;         /* Worker identities */
+} pool_t;
+
+/**
+ * @brief Worker loop: runs its share of every posted task until stopped.
+ *
+ * @param arg Pointer to the worker's pool_slot_t
+ * @return NULL
+ */
+static void *
+pool_worker(void *arg)
+{
+	pool_slot_t *slot = arg;
+	pool_t *pool = slot->pool;
+	unsigned long seen = 0;
+
+	if (pool->pin)
+		mem_pin_thread(slot->id);
+
+	pthread_mutex_lock(&pool->lock);
+	for (;;) {
+		while (pool->generation == seen && !pool->quit)
+			pthread_cond_wait(&pool->start, &pool->lock);
+		if (pool->quit)
+			break;
+
+		seen = pool->generation;
+		void *(*fn)(void *) = pool->fn;
+		void *share = pool->args + slot->id * pool->stride;
+		pthread_mutex_unlock(&pool->lock);
+
+		fn(share);
+
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->pending == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+/**
+ * @brief Starts the workers of a pool of @p n_threads shares.
+ *
+ * Fewer workers than requested is not an error (see pool_t).
+ *
+ * @param pool Pool to initialize
+ * @param n_threads Shares per task
+ * @param pin Pin the calling thread and the workers (mem_pin_thread())
+ * @return 0 on success, -1 on error
+ */
+static int
+pool_start(pool_t *pool, unsigned int n_threads, int pin)
+{
+	memset(pool, 0, sizeof(*pool));
+	pool->n_threads = n_threads;
+	pool->pin = pin;
+	pool->threads = malloc(n_threads * sizeof(pthread_t));
+	pool->slots = malloc(n_threads * sizeof(pool_slot_t));
+	if (!pool->threads || !pool->slots) {
+		free(pool->threads);
+		free(pool->slots);
+		return -1;
+	}
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+
+	if (pin)
+		mem_pin_thread(0);
+	for (unsigned int i = 1; i < n_threads; i++) {
+		pool->slots[i].pool = pool;
+		pool->slots[i].id = i;
+		if (pthread_create(&pool->threads[i], NULL, pool_worker, &pool->slots[i]) != 0)
+			break;
+		pool->n_workers++;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Runs @p fn once per share and waits for all of them.
+ *
+ * Share i gets @p args + i * @p stride; a @p stride of 0 gives every share
+ * the same argument.
+ */
+static void
+pool_run(pool_t *pool, void *(*fn)(void *), void *args, size_t stride)
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->fn = fn;
+	pool->args = args;
+	pool->stride = stride;
+	pool->pending = pool->n_workers;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	fn(args);
+	for (unsigned int i = pool->n_workers + 1; i < pool->n_threads; i++)
+		fn((char *)args + i * stride);  /* Shares of workers that could not start */
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending > 0)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief Stops and joins the workers of a pool started by pool_start(),
+ *        and gives a pinned caller back its affinity.
+ */
+static void
+pool_stop(pool_t *pool)
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (unsigned int i = 1; i <= pool->n_workers; i++)
+		pthread_join(pool->threads[i], NULL);
+	if (pool->pin)
+		mem_unpin_thread();
+
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->start);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->threads);
+	free(pool->slots);
+}
+
+/* ========================================================================== */
+/*                     LABEL INITIALIZATION WORKER THREAD                     */
+/* ========================================================================== */
+
+/**
+ * @struct init_labels_args_t
+ * @brief Arguments for initializing a slice of the label array.
+ */
+typedef struct {
+	csc_idx_t *label;   /* Label array */
+	csc_idx_t begin;    /* Start index of the slice */
+	csc_idx_t end;      /* End index of the slice (exclusive) */
+} init_labels_args_t;
+
+/**
+ * @brief Worker function: makes every node of a slice its own label.
+ *
+ * @param arg Pointer to init_labels_args_t
+ * @return NULL
+ */
+static void *
+init_labels_worker(void *arg)
+{
+	init_labels_args_t *args = arg;
+	
+	for (csc_idx_t i = args->begin; i < args->end; i++)
+		args->label[i] = i;
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: points every node of a slice straight at its root.
+ *
+ * Concurrent writes only ever store a root, so every chain a thread
+ * follows still ends at the right one.
+ *
+ * @param arg Pointer to init_labels_args_t
+ * @return NULL
+ */
+static void *
+flatten_labels_worker(void *arg)
+{
+	init_labels_args_t *args = arg;
+	
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		csc_idx_t root = args->label[i];
+		while (args->label[root] != root)
+			root = args->label[root];
+		args->label[i] = root;
+	}
+	
+	return NULL;
+}
+
 /* ========================================================================== */
 /*                       UNION-FIND WORKER THREAD                             */
 /* ========================================================================== */
@@ -124,21 +378,46 @@ union_rem(uint32_t *label, uint32_t a, uint32_t b)
  * @brief Arguments for the union-find worker thread.
  *
  * Each thread uses these arguments to perform unions on a dynamically
- * scheduled chunk of columns from the sparse matrix.
+ * scheduled chunk of columns from the sparse matrix, or, without a
+ * counter, on its own static block of columns.
  */
 typedef struct {
 	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
-	uint32_t *label;               /* Label array representing disjoint sets */
-	atomic_uint *next_col;         /* Atomic counter for dynamic column scheduling */
-	uint32_t num_cols;             /* Total number of columns in the matrix */
+	csc_idx_t *label;              /* Label array representing disjoint sets */
+	atomic_size_t *next_col;       /* Atomic counter for dynamic column scheduling (NULL: static block) */
+	csc_idx_t num_cols;            /* Total number of columns in the matrix */
+	csc_idx_t begin;               /* Start column of the static block */
+	csc_idx_t end;                 /* End column of the static block (exclusive) */
 } union_find_args_t;
 
+/**
+ * @brief Unions every edge of the columns [@p begin, @p end).
+ */
+static void
+union_cols(const CSCBinaryMatrix *matrix, csc_idx_t *label, csc_idx_t begin, csc_idx_t end)
+{
+	for (csc_idx_t c = begin; c < end; c++) {
+		if (matrix->packed) {
+			CSCPackedIter it;
+			csc_idx_t row;
+
+			csc_packed_col(matrix->packed, c, &it);
+			while (csc_packed_next(&it, &row))
+				union_rem(label, row, c);
+			continue;
+		}
+
+		for (csc_ptr_t j = matrix->col_ptr[c]; j < matrix->col_ptr[c + 1]; j++)
+			union_rem(label, matrix->row_idx[j], c);
+	}
+}
+
 /**
  * @brief Worker function for parallel union-find.
  *
  * Each thread grabs a chunk of columns from the global atomic counter
  * and performs union operations on all edges in those columns using
- * lock-free CAS operations.
+ * lock-free CAS operations. Without a counter it unions its static block.
  *
  * @param arg Pointer to union_find_args_t structure containing arguments
  * @return NULL
@@ -147,307 +426,2093 @@ static void *
 union_find_worker(void *arg)
 {
 	union_find_args_t *args = arg;
-	const uint32_t CHUNK_SIZE = 4096;
+	const csc_idx_t CHUNK_SIZE = 4096;
+
+	if (!args->next_col) {
+		union_cols(args->matrix, args->label, args->begin, args->end);
+		return NULL;
+	}
 	
 	while (1) {
 		/* Grab next chunk of columns */
-		uint32_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
+		csc_idx_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
 		if (col >= args->num_cols)
 			break;
 		
-		uint32_t end_col = col + CHUNK_SIZE;
+		csc_idx_t end_col = col + CHUNK_SIZE;
 		if (end_col > args->num_cols)
 			end_col = args->num_cols;
 		
 		/* Process all edges in this chunk */
-		for (uint32_t c = col; c < end_col; c++) {
-			uint32_t start = args->matrix->col_ptr[c];
-			uint32_t end = args->matrix->col_ptr[c + 1];
-			
-			for (uint32_t j = start; j < end; j++) {
-				uint32_t row = args->matrix->row_idx[j];
-				union_rem(args->label, row, c);
-			}
-		}
+		union_cols(args->matrix, args->label, col, end_col);
 	}
 	
 	return NULL;
 }
 
 /* ========================================================================== */
-/*                       COUNT ROOTS WORKER THREAD                            */
+/*                     MIRRORED STORAGE WORKER THREAD                         */
 /* ========================================================================== */
 
 /**
- * @struct count_roots_args_t
- * @brief Arguments for counting roots in a subset of the label array.
- *
- * Each thread counts the number of roots in its assigned range.
+ * @struct mirrored_args_t
+ * @brief Arguments for checking a slice of columns for mirrored storage.
  */
 typedef struct {
-	uint32_t *label;    /* Label array representing disjoint sets */
-	uint32_t begin;     /* Start index of the range */
-	uint32_t end;       /* End index of the range (exclusive) */
-	uint32_t local;     /* Thread-local count of roots */
-} count_roots_args_t;
+	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
+	csc_idx_t begin;               /* Start column of the slice */
+	csc_idx_t end;                 /* End column of the slice (exclusive) */
+	int *mirrored;                 /* Shared flag, cleared when an edge is stored
+	                                  in one column only */
+} mirrored_args_t;
 
 /**
- * @brief Worker function to count roots in a given range.
- *
- * Each thread iterates over its assigned slice of the label array and
- * counts how many elements are roots (label[i] == i).
+ * @brief Tells whether @p col is stored in column @p row, by binary search
+ *        over the sorted rows of a normalized matrix.
+ */
+static inline int
+has_entry(const CSCBinaryMatrix *matrix, csc_idx_t row, csc_idx_t col)
+{
+	csc_ptr_t lo = matrix->col_ptr[row];
+	csc_ptr_t hi = matrix->col_ptr[row + 1];
+
+	while (lo < hi) {
+		csc_ptr_t mid = lo + (hi - lo) / 2;
+		if (matrix->row_idx[mid] < col)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < matrix->col_ptr[row + 1] && matrix->row_idx[lo] == col;
+}
+
+/**
+ * @brief Worker function: checks that every edge of a slice of columns is
+ *        stored in both of its columns, clearing the shared flag otherwise.
  *
- * @param arg Pointer to count_roots_args_t
+ * @param arg Pointer to mirrored_args_t
  * @return NULL
  */
 static void *
-count_roots_worker(void *arg)
+mirrored_worker(void *arg)
 {
-	count_roots_args_t *args = arg;
-	uint32_t count = 0;
+	mirrored_args_t *args = arg;
+	const CSCBinaryMatrix *matrix = args->matrix;
 	
-	for (uint32_t i = args->begin; i < args->end; i++)
-		if (args->label[i] == i)
-			count++;
+	for (csc_idx_t col = args->begin; col < args->end; col++) {
+		if (!__atomic_load_n(args->mirrored, __ATOMIC_RELAXED))
+			break;
+		for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+			if (!has_entry(matrix, matrix->row_idx[j], col)) {
+				__atomic_store_n(args->mirrored, 0, __ATOMIC_RELAXED);
+				return NULL;
+			}
+		}
+	}
 	
-	args->local = count;
 	return NULL;
 }
 
 /* ========================================================================== */
-/*                         UNION-FIND ALGORITHM                               */
+/*                      FINALIZATION WORKER THREADS                           */
 /* ========================================================================== */
 
 /**
- * @brief Computes connected components using parallel union-find.
+ * @struct finalize_args_t
+ * @brief Arguments for finalizing a slice of a flat label array.
  *
- * Algorithm phases:
- * 1. Initialize each node as its own root
- * 2. Perform parallel union operations on edges using multiple threads
- * 3. Flatten all paths to roots for accurate counting
- * 4. Count roots in parallel using thread-local accumulation
+ * Roots are the nodes labelled with themselves. The size array holds the
+ * size of every component at its root, and after cc_plan_dense_labels()
+ * numbered the roots, their dense ids.
+ */
+typedef struct {
+	csc_idx_t *label;   /* Label array, every node holding its root */
+	csc_idx_t *size;    /* Size (then dense id) by root */
+	csc_idx_t begin;    /* Start index of the slice */
+	csc_idx_t end;      /* End index of the slice (exclusive) */
+	size_t roots;       /* Roots in the slice */
+	size_t first;       /* Dense id of the first root of the slice */
+	CCSummary summary;  /* Statistics of the roots in the slice */
+} finalize_args_t;
+
+/**
+ * @brief Worker function: clears the sizes of a slice and counts its roots.
  *
- * @param matrix Sparse CSC binary matrix representing graph
- * @param n_threads Number of Pthreads to use
- * @return Number of connected components, or -1 on error
+ * @param arg Pointer to finalize_args_t
+ * @return NULL
  */
-static int
-cc_union_find(const CSCBinaryMatrix *matrix, unsigned int n_threads)
+static void *
+count_roots_worker(void *arg)
 {
-	if (!matrix || matrix->nrows == 0)
-		return 0;
+	finalize_args_t *args = arg;
+	size_t roots = 0;
 	
-	const uint32_t n = matrix->nrows;
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		args->size[i] = 0;
+		roots += (args->label[i] == i);
+	}
 	
-	uint32_t *label = malloc(n * sizeof(uint32_t));
-	if (!label)
-		return -1;
+	args->roots = roots;
+	return NULL;
+}
+
+/**
+ * @brief Worker function: adds the nodes of a slice to their components' sizes.
+ *
+ * Runs of equal labels are added with one atomic operation, so a slice
+ * inside the giant component costs one shared update per run rather than
+ * one per node.
+ *
+ * @param arg Pointer to finalize_args_t
+ * @return NULL
+ */
+static void *
+accumulate_sizes_worker(void *arg)
+{
+	finalize_args_t *args = arg;
 	
-	/* Initialize: each node as its own parent */
-	for (uint32_t i = 0; i < n; i++)
-		label[i] = i;
+	for (csc_idx_t i = args->begin; i < args->end; ) {
+		csc_idx_t root = args->label[i];
+		csc_idx_t j = i + 1;
+		while (j < args->end && args->label[j] == root)
+			j++;
+		__atomic_fetch_add(&args->size[root], j - i, __ATOMIC_RELAXED);
+		i = j;
+	}
 	
-	/* Process all edges: union connected nodes */
-	atomic_uint next_col;
-	atomic_store(&next_col, 0);
+	return NULL;
+}
+
+/**
+ * @brief Worker function: largest component and size histogram of the
+ *        roots of a slice.
+ *
+ * @param arg Pointer to finalize_args_t
+ * @return NULL
+ */
+static void *
+summarize_worker(void *arg)
+{
+	finalize_args_t *args = arg;
+	CCSummary *sum = &args->summary;
 	
-	pthread_t threads[n_threads];
-	union_find_args_t args = {
-		.matrix = matrix,
-		.label = label,
-		.next_col = &next_col,
-		.num_cols = matrix->ncols
-	};
+	memset(sum, 0, sizeof(*sum));
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		if (args->label[i] != i)
+			continue;
+		if (args->size[i] > sum->largest)
+			sum->largest = args->size[i];
+		sum->size_histogram[cc_size_bucket(args->size[i])]++;
+	}
+	sum->components = args->roots;
 	
-	for (unsigned i = 0; i < n_threads; i++)
-		pthread_create(&threads[i], NULL, union_find_worker, &args);
-	for (unsigned i = 0; i < n_threads; i++)
-		pthread_join(threads[i], NULL);
+	return NULL;
+}
+
+/**
+ * @brief Worker function: numbers the roots of a slice from its first id.
+ *
+ * @param arg Pointer to finalize_args_t
+ * @return NULL
+ */
+static void *
+number_roots_worker(void *arg)
+{
+	finalize_args_t *args = arg;
+	csc_idx_t next = args->first;
 	
-	/* Final compression pass: flatten all paths */
-	for (uint32_t i = 0; i < n; i++)
-		find_compress(label, i);
+	for (csc_idx_t i = args->begin; i < args->end; i++)
+		if (args->label[i] == i)
+			args->size[i] = next++;
 	
-	/* Count roots (each root represents one component) */
-	uint32_t total = 0;
-	uint32_t chunk = (n + n_threads - 1) / n_threads;
-	count_roots_args_t count_args[n_threads];
+	return NULL;
+}
+
+/**
+ * @brief Worker function: replaces the labels of a slice by their roots' ids.
+ *
+ * @param arg Pointer to finalize_args_t
+ * @return NULL
+ */
+static void *
+relabel_worker(void *arg)
+{
+	finalize_args_t *args = arg;
 	
-	for (unsigned i = 0; i < n_threads; i++) {
-		count_args[i].label = label;
-		count_args[i].begin = i * chunk;
-		count_args[i].end = (count_args[i].begin + chunk > n ? n : count_args[i].begin + chunk);
-		pthread_create(&threads[i], NULL, count_roots_worker, &count_args[i]);
-	}
-	for (unsigned i = 0; i < n_threads; i++) {
-		pthread_join(threads[i], NULL);
-		total += count_args[i].local;
-	}
+	for (csc_idx_t i = args->begin; i < args->end; i++)
+		args->label[i] = args->size[args->label[i]];
 	
-	free(label);
-	return (int)total;
+	return NULL;
 }
 
 /* ========================================================================== */
-/*                   LABEL PROPAGATION WORKER THREAD                          */
+/*                          FASTSV WORKER THREADS                             */
 /* ========================================================================== */
 
 /**
- * @struct label_propagation_args_t
- * @brief Arguments for the label propagation worker thread.
+ * @struct fastsv_args_t
+ * @brief Arguments for one thread of a FastSV round.
  *
- * Each thread processes a subset of columns and updates labels atomically.
+ * The hooking phase schedules columns dynamically through @c next_col;
+ * the other phases work on the thread's own slice of nodes.
  */
 typedef struct {
 	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
-	uint32_t *label;               /* Label array */
-	atomic_uint *next_col;         /* Atomic column counter for dynamic scheduling */
-	atomic_uint *global_change;    /* Atomic flag indicating if any label changed */
-} label_propagation_args_t;
+	csc_idx_t *parent;             /* Parent array (f) */
+	csc_idx_t *grand;              /* Grandparent array (gf) */
+	atomic_size_t *next_col;       /* Atomic column counter for dynamic scheduling */
+	atomic_uint *changed;          /* Set when a grandparent changed */
+	csc_idx_t begin;               /* Start index of the slice */
+	csc_idx_t end;                 /* End index of the slice (exclusive) */
+} fastsv_args_t;
 
 /**
- * @brief Worker function for optimized parallel label propagation.
+ * @brief Lowers *p to @p value if it is smaller (atomic minimum).
+ */
+static inline void
+write_min(csc_idx_t *p, csc_idx_t value)
+{
+	csc_idx_t cur = __atomic_load_n(p, __ATOMIC_RELAXED);
+
+	while (value < cur &&
+	       !__atomic_compare_exchange_n(p, &cur, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+/**
+ * @brief Hooks one edge (u, v) the FastSV way.
  *
- * Each thread grabs a chunk of columns dynamically, then iterates over all
- * edges in the chunk, updating the labels of connected nodes to the minimum
- * value using conditional atomic stores. Sets a global flag if any label
- * changed.
+ * The end with the larger grandparent takes the smaller one twice:
+ * stochastic hooking lowers its parent's parent, aggressive hooking its
+ * own parent. Parents never exceed their node, so equal grandparents
+ * leave nothing for the edge to do that shortcutting does not.
  *
- * Key optimization: Only performs atomic stores when the value actually
- * changes, dramatically reducing atomic operation overhead and contention.
+ * @param parent Parent array (f)
+ * @param grand Grandparent array of the previous round (gf)
+ * @param u First node
+ * @param v Second node
+ */
+static inline void
+hook_edge(csc_idx_t *parent, const csc_idx_t *grand, csc_idx_t u, csc_idx_t v)
+{
+	csc_idx_t gu = grand[u];
+	csc_idx_t gv = grand[v];
+
+	if (gu == gv)
+		return;
+	if (gu < gv) {
+		csc_idx_t t = u;
+		u = v;
+		v = t;
+		gv = gu;
+	}
+	write_min(&parent[__atomic_load_n(&parent[u], __ATOMIC_RELAXED)], gv);
+	write_min(&parent[u], gv);
+}
+
+/**
+ * @brief Worker function: makes every node of a slice its own parent and
+ *        grandparent.
  *
- * @param arg Pointer to label_propagation_args_t structure
+ * @param arg Pointer to fastsv_args_t
  * @return NULL
  */
 static void *
-label_propagation_worker(void *arg)
+fastsv_init_worker(void *arg)
 {
-	label_propagation_args_t *args = arg;
-	const uint32_t CHUNK_SIZE = 4096;  /* Larger chunks for less overhead */
+	fastsv_args_t *args = arg;
+	
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		args->parent[i] = i;
+		args->grand[i] = i;
+	}
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: hooks the edges of dynamically scheduled chunks
+ *        of columns.
+ *
+ * @param arg Pointer to fastsv_args_t
+ * @return NULL
+ */
+static void *
+fastsv_hook_worker(void *arg)
+{
+	fastsv_args_t *args = arg;
+	const CSCBinaryMatrix *matrix = args->matrix;
+	const csc_idx_t CHUNK_SIZE = 4096;
 	
 	while (1) {
 		/* Grab next chunk of columns */
-		uint32_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
-		if (col >= args->matrix->ncols)
+		csc_idx_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
+		if (col >= matrix->ncols)
 			break;
 		
-		uint32_t end_col = col + CHUNK_SIZE;
-		if (end_col > args->matrix->ncols)
-			end_col = args->matrix->ncols;
-		
-		uint8_t changed = 0;
+		csc_idx_t end_col = col + CHUNK_SIZE;
+		if (end_col > matrix->ncols)
+			end_col = matrix->ncols;
 		
-		/* Process all edges in this chunk */
-		for (uint32_t c = col; c < end_col; c++) {
-			for (uint32_t j = args->matrix->col_ptr[c]; j < args->matrix->col_ptr[c + 1]; j++) {
-				uint32_t row = args->matrix->row_idx[j];
-				uint32_t label_col = args->label[c];
-				uint32_t label_row = args->label[row];
-				
-				if (label_col != label_row) {
-					uint32_t min_label = label_col < label_row ? label_col : label_row;
-					
-					/* Conditional atomic stores: only update if value changes */
-					if (label_col > min_label) {
-						__atomic_store_n(&args->label[c], min_label, __ATOMIC_RELAXED);
-						changed = 1;
-					}
-					if (label_row > min_label) {
-						__atomic_store_n(&args->label[row], min_label, __ATOMIC_RELAXED);
-						changed = 1;
-					}
-				}
+		for (csc_idx_t c = col; c < end_col; c++) {
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, c, &it);
+				while (csc_packed_next(&it, &row))
+					hook_edge(args->parent, args->grand, row, c);
+				continue;
 			}
+
+			for (csc_ptr_t j = matrix->col_ptr[c]; j < matrix->col_ptr[c + 1]; j++)
+				hook_edge(args->parent, args->grand, matrix->row_idx[j], c);
 		}
-		
-		/* Update global change flag if any local changes occurred */
-		if (changed)
-			atomic_store(args->global_change, 1);
 	}
 	
 	return NULL;
 }
 
-/* ========================================================================== */
-/*                       LABEL PROPAGATION ALGORITHM                          */
-/* ========================================================================== */
-
 /**
- * @brief Computes connected components using optimized parallel label propagation.
+ * @brief Worker function: shortcuts every node of a slice to its
+ *        grandparent if that is smaller than its parent.
+ *
+ * @param arg Pointer to fastsv_args_t
+ * @return NULL
+ */
+static void *
+fastsv_shortcut_worker(void *arg)
+{
+	fastsv_args_t *args = arg;
+	
+	for (csc_idx_t i = args->begin; i < args->end; i++)
+		if (args->grand[i] < args->parent[i])
+			args->parent[i] = args->grand[i];
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: recomputes the grandparents of a slice and sets
+ *        the shared flag if any of them changed.
+ *
+ * @param arg Pointer to fastsv_args_t
+ * @return NULL
+ */
+static void *
+fastsv_grand_worker(void *arg)
+{
+	fastsv_args_t *args = arg;
+	uint8_t changed = 0;
+	
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		csc_idx_t g = args->parent[args->parent[i]];
+		if (g != args->grand[i]) {
+			args->grand[i] = g;
+			changed = 1;
+		}
+	}
+	
+	if (changed)
+		atomic_store(args->changed, 1);
+	return NULL;
+}
+
+/* ========================================================================== */
+/*                        MULTISTEP WORKER THREADS                            */
+/* ========================================================================== */
+
+/** Depth of a node the BFS has not reached */
+#define MULTISTEP_UNREACHED CSC_IDX_MAX
+
+/** Top-down steps turn bottom-up once the frontier's edges exceed this
+ *  fraction (1/ALPHA) of the edges of unreached nodes */
+#define MULTISTEP_ALPHA 15
+
+/** Bottom-up steps turn top-down again once the frontier holds fewer than
+ *  this fraction (1/BETA) of the nodes */
+#define MULTISTEP_BETA 18
+
+/** Nodes a thread discovers before appending them to the shared queue */
+#define MULTISTEP_BUFFER 256
+
+/**
+ * @struct multistep_step_t
+ * @brief State shared by the threads of one Multistep phase.
+ */
+typedef struct {
+	atomic_size_t next;  /* Next queue entry or column to claim */
+	size_t head;         /* Start of the frontier in the queue */
+	size_t end;          /* End of the frontier */
+	size_t tail;         /* End of the queue (advanced atomically) */
+	csc_idx_t level;     /* Depth of the frontier */
+	csc_idx_t smallest;  /* Smallest reached node */
+} multistep_step_t;
+
+/**
+ * @struct multistep_args_t
+ * @brief Arguments for one thread of a Multistep phase.
+ *
+ * The BFS steps and the union-find phase schedule queue entries, nodes or
+ * columns dynamically through the shared step; the other phases work on
+ * the thread's own slice of nodes.
+ */
+typedef struct {
+	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
+	csc_idx_t *label;              /* Label array */
+	csc_idx_t *depth;              /* BFS depth of every node */
+	csc_idx_t *queue;              /* Reached nodes in BFS order */
+	multistep_step_t *step;        /* Shared state of the current phase */
+	csc_idx_t begin;               /* Start index of the slice */
+	csc_idx_t end;                 /* End index of the slice (exclusive) */
+	csc_idx_t best;                /* Node of the slice with the most entries,
+	                                  then its smallest reached node */
+	csc_ptr_t best_degree;         /* Entries stored in the column of best */
+	size_t edges;                  /* Entries of the nodes discovered in the step */
+} multistep_args_t;
+
+/**
+ * @struct discovered_t
+ * @brief Nodes discovered by one thread in one BFS step, not yet appended
+ *        to the queue.
+ */
+typedef struct {
+	csc_idx_t node[MULTISTEP_BUFFER]; /* Discovered nodes */
+	unsigned int count;               /* Entries of node in use */
+} discovered_t;
+
+/**
+ * @brief Returns the number of entries stored in column @p v (0 for nodes
+ *        without a column).
+ */
+static inline csc_ptr_t
+col_degree(const CSCBinaryMatrix *matrix, csc_idx_t v)
+{
+	return v < matrix->ncols ? matrix->col_ptr[v + 1] - matrix->col_ptr[v] : 0;
+}
+
+/**
+ * @brief Appends a thread's discovered nodes to the queue with one atomic
+ *        increment of its tail.
+ */
+static inline void
+flush_discovered(multistep_args_t *args, discovered_t *d)
+{
+	size_t at = __atomic_fetch_add(&args->step->tail, d->count, __ATOMIC_RELAXED);
+
+	memcpy(args->queue + at, d->node, d->count * sizeof(csc_idx_t));
+	d->count = 0;
+}
+
+/**
+ * @brief Records node @p v as discovered by this thread.
+ */
+static inline void
+discover(multistep_args_t *args, discovered_t *d, csc_idx_t v)
+{
+	d->node[d->count++] = v;
+	args->edges += col_degree(args->matrix, v);
+	if (d->count == MULTISTEP_BUFFER)
+		flush_discovered(args, d);
+}
+
+/**
+ * @brief Claims an unreached node for depth @p level; 1 if this thread won it.
+ */
+static inline int
+claim(csc_idx_t *depth, csc_idx_t v, csc_idx_t level)
+{
+	csc_idx_t unreached = MULTISTEP_UNREACHED;
+
+	return __atomic_load_n(&depth[v], __ATOMIC_RELAXED) == MULTISTEP_UNREACHED &&
+	       __atomic_compare_exchange_n(&depth[v], &unreached, level, 0,
+	                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Worker function: initializes the labels and depths of a slice and
+ *        finds its node with the most stored entries.
+ *
+ * @param arg Pointer to multistep_args_t
+ * @return NULL
+ */
+static void *
+multistep_init_worker(void *arg)
+{
+	multistep_args_t *args = arg;
+	
+	args->best = args->begin;
+	args->best_degree = 0;
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		args->label[i] = i;
+		args->depth[i] = MULTISTEP_UNREACHED;
+
+		csc_ptr_t degree = col_degree(args->matrix, i);
+		if (degree > args->best_degree) {
+			args->best_degree = degree;
+			args->best = i;
+		}
+	}
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: one top-down BFS step over dynamically scheduled
+ *        chunks of the frontier; every frontier node claims the unreached
+ *        rows of its column.
+ *
+ * @param arg Pointer to multistep_args_t
+ * @return NULL
+ */
+static void *
+multistep_top_down_worker(void *arg)
+{
+	multistep_args_t *args = arg;
+	multistep_step_t *step = args->step;
+	const CSCBinaryMatrix *matrix = args->matrix;
+	const csc_idx_t n = matrix->nrows;
+	const size_t CHUNK_SIZE = 64;
+	discovered_t d = { .count = 0 };
+	
+	args->edges = 0;
+	while (1) {
+		size_t q = step->head + atomic_fetch_add(&step->next, CHUNK_SIZE);
+		if (q >= step->end)
+			break;
+		
+		size_t end_q = q + CHUNK_SIZE < step->end ? q + CHUNK_SIZE : step->end;
+		
+		for (; q < end_q; q++) {
+			csc_idx_t v = args->queue[q];
+			if (v >= matrix->ncols)
+				continue;
+
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, v, &it);
+				while (csc_packed_next(&it, &row))
+					if (row < n && claim(args->depth, row, step->level + 1))
+						discover(args, &d, row);
+				continue;
+			}
+
+			for (csc_ptr_t j = matrix->col_ptr[v]; j < matrix->col_ptr[v + 1]; j++) {
+				csc_idx_t row = matrix->row_idx[j];
+				if (row < n && claim(args->depth, row, step->level + 1))
+					discover(args, &d, row);
+			}
+		}
+	}
+	
+	if (d.count)
+		flush_discovered(args, &d);
+	return NULL;
+}
+
+/**
+ * @brief Worker function: one bottom-up BFS step over dynamically
+ *        scheduled chunks of nodes; every unreached node looks for a
+ *        frontier node in its own column and stops at the first one.
+ *
+ * Only valid when every edge is stored in both of its columns.
+ *
+ * @param arg Pointer to multistep_args_t
+ * @return NULL
+ */
+static void *
+multistep_bottom_up_worker(void *arg)
+{
+	multistep_args_t *args = arg;
+	multistep_step_t *step = args->step;
+	const CSCBinaryMatrix *matrix = args->matrix;
+	const csc_idx_t n = matrix->nrows;
+	const csc_idx_t level = step->level;
+	const csc_idx_t CHUNK_SIZE = 1024;
+	csc_idx_t *depth = args->depth;
+	discovered_t d = { .count = 0 };
+	
+	args->edges = 0;
+	while (1) {
+		csc_idx_t v = atomic_fetch_add(&step->next, CHUNK_SIZE);
+		if (v >= n)
+			break;
+		
+		csc_idx_t end_v = v + CHUNK_SIZE < n ? v + CHUNK_SIZE : n;
+		
+		for (; v < end_v; v++) {
+			if (__atomic_load_n(&depth[v], __ATOMIC_RELAXED) != MULTISTEP_UNREACHED)
+				continue;
+
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, v, &it);
+				while (csc_packed_next(&it, &row)) {
+					if (__atomic_load_n(&depth[row], __ATOMIC_RELAXED) == level) {
+						__atomic_store_n(&depth[v], level + 1, __ATOMIC_RELAXED);
+						discover(args, &d, v);
+						break;
+					}
+				}
+				continue;
+			}
+
+			for (csc_ptr_t j = matrix->col_ptr[v]; j < matrix->col_ptr[v + 1]; j++) {
+				if (__atomic_load_n(&depth[matrix->row_idx[j]], __ATOMIC_RELAXED) == level) {
+					__atomic_store_n(&depth[v], level + 1, __ATOMIC_RELAXED);
+					discover(args, &d, v);
+					break;
+				}
+			}
+		}
+	}
+	
+	if (d.count)
+		flush_discovered(args, &d);
+	return NULL;
+}
+
+/**
+ * @brief Worker function: finds the smallest reached node of a slice
+ *        (CSC_IDX_MAX if none).
+ *
+ * @param arg Pointer to multistep_args_t
+ * @return NULL
+ */
+static void *
+multistep_smallest_worker(void *arg)
+{
+	multistep_args_t *args = arg;
+	
+	args->best = CSC_IDX_MAX;
+	for (csc_idx_t i = args->begin; i < args->end; i++) {
+		if (args->depth[i] != MULTISTEP_UNREACHED) {
+			args->best = i;
+			break;
+		}
+	}
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: labels the reached nodes of a slice with the
+ *        smallest reached node.
+ *
+ * @param arg Pointer to multistep_args_t
+ * @return NULL
+ */
+static void *
+multistep_label_worker(void *arg)
+{
+	multistep_args_t *args = arg;
+	const csc_idx_t smallest = args->step->smallest;
+	
+	for (csc_idx_t i = args->begin; i < args->end; i++)
+		if (args->depth[i] != MULTISTEP_UNREACHED)
+			args->label[i] = smallest;
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: unions the edges of the unreached columns, over
+ *        dynamically scheduled chunks of columns.
+ *
+ * @param arg Pointer to multistep_args_t
+ * @return NULL
+ */
+static void *
+multistep_union_worker(void *arg)
+{
+	multistep_args_t *args = arg;
+	const CSCBinaryMatrix *matrix = args->matrix;
+	const csc_idx_t n = matrix->nrows;
+	const csc_idx_t CHUNK_SIZE = 4096;
+	
+	while (1) {
+		csc_idx_t col = atomic_fetch_add(&args->step->next, CHUNK_SIZE);
+		if (col >= matrix->ncols)
+			break;
+		
+		csc_idx_t end_col = col + CHUNK_SIZE < matrix->ncols ? col + CHUNK_SIZE : matrix->ncols;
+		
+		for (csc_idx_t c = col; c < end_col; c++) {
+			if (args->depth[c] != MULTISTEP_UNREACHED)
+				continue;
+
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, c, &it);
+				while (csc_packed_next(&it, &row))
+					if (row < n)
+						union_rem(args->label, row, c);
+				continue;
+			}
+
+			for (csc_ptr_t j = matrix->col_ptr[c]; j < matrix->col_ptr[c + 1]; j++) {
+				csc_idx_t row = matrix->row_idx[j];
+				if (row < n)
+					union_rem(args->label, row, c);
+			}
+		}
+	}
+	
+	return NULL;
+}
+
+/* ========================================================================== */
+/*                  FRONTIER LABEL PROPAGATION WORKER THREADS                 */
+/* ========================================================================== */
+
+/** Rounds whose frontier holds at most 1/FRONTIER_SPARSE of the nodes walk
+ *  its queue; larger frontiers scan its bitmap */
+#define FRONTIER_SPARSE 20
+
+/** Frontier entries or bitmap words per scheduling chunk */
+#define FRONTIER_CHUNK 64
+
+/** Nodes a thread activates before appending them to the shared queue */
+#define FRONTIER_BUFFER 256
+
+/**
+ * @struct frontier_t
+ * @brief Active nodes of the current and the next round, each kept both as
+ *        a bitmap and as a queue.
+ */
+typedef struct {
+	uint64_t *bits[2];   /* Bitmaps of (nrows + 63) / 64 words */
+	csc_idx_t *queue[2]; /* Queues of nrows entries, each node at most once */
+} frontier_t;
+
+/**
+ * @struct frontier_round_t
+ * @brief State shared by the threads of one frontier round.
+ *
+ * Every phase schedules chunks of FRONTIER_CHUNK queue entries or bitmap
+ * words dynamically through next.
+ */
+typedef struct {
+	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
+	csc_idx_t *label;              /* Label array */
+	uint64_t *bits;                /* This round's bitmap */
+	const csc_idx_t *queue;        /* This round's queue */
+	uint64_t *next_bits;           /* Next round's bitmap */
+	csc_idx_t *next_queue;         /* Next round's queue */
+	size_t count;                  /* Active nodes of this round */
+	size_t words;                  /* Words of each bitmap */
+	int sparse;                    /* Walk the queue rather than the bitmap */
+	atomic_size_t next;            /* Next queue entry or word to claim */
+	size_t tail;                   /* Entries of next_queue in use (advanced atomically) */
+} frontier_round_t;
+
+/**
+ * @struct activated_t
+ * @brief One thread's view of the next round's frontier: the nodes it
+ *        activated and has not appended to the shared queue yet.
+ */
+typedef struct {
+	frontier_round_t *round;         /* Round the nodes were activated in */
+	csc_idx_t node[FRONTIER_BUFFER]; /* Activated nodes */
+	unsigned int count;              /* Entries of node in use */
+} activated_t;
+
+/**
+ * @brief Claims the next chunk of FRONTIER_CHUNK of @p total items.
+ *
+ * @return 1 with [*begin, *end) set, 0 once every item is claimed
+ */
+static inline int
+next_chunk(frontier_round_t *round, size_t total, size_t *begin, size_t *end)
+{
+	*begin = atomic_fetch_add(&round->next, FRONTIER_CHUNK);
+	if (*begin >= total)
+		return 0;
+	*end = (*begin + FRONTIER_CHUNK > total ? total : *begin + FRONTIER_CHUNK);
+	return 1;
+}
+
+/**
+ * @brief Appends a thread's activated nodes to the next round's queue with
+ *        one atomic increment of its tail.
+ */
+static inline void
+flush_activated(activated_t *a)
+{
+	size_t at = __atomic_fetch_add(&a->round->tail, a->count, __ATOMIC_RELAXED);
+
+	memcpy(a->round->next_queue + at, a->node, a->count * sizeof(csc_idx_t));
+	a->count = 0;
+}
+
+/**
+ * @brief Adds node @p v to the next round's frontier unless it is there
+ *        already.
+ */
+static inline void
+activate(activated_t *a, csc_idx_t v)
+{
+	uint64_t *word = &a->round->next_bits[v >> 6];
+	uint64_t mask = (uint64_t)1 << (v & 63);
+
+	if (__atomic_load_n(word, __ATOMIC_RELAXED) & mask)
+		return;
+	if (__atomic_fetch_or(word, mask, __ATOMIC_RELAXED) & mask)
+		return;
+
+	a->node[a->count++] = v;
+	if (a->count == FRONTIER_BUFFER)
+		flush_activated(a);
+}
+
+/**
+ * @brief Relaxes one edge (row, col) towards the smaller label and
+ *        activates the node whose label was lowered.
+ */
+static inline void
+propagate_edge(csc_idx_t *label, csc_idx_t col, csc_idx_t row, activated_t *a)
+{
+	csc_idx_t label_col = __atomic_load_n(&label[col], __ATOMIC_RELAXED);
+	csc_idx_t label_row = __atomic_load_n(&label[row], __ATOMIC_RELAXED);
+
+	if (label_col > label_row) {
+		__atomic_store_n(&label[col], label_row, __ATOMIC_RELAXED);
+		activate(a, col);
+	} else if (label_row > label_col) {
+		__atomic_store_n(&label[row], label_col, __ATOMIC_RELAXED);
+		activate(a, row);
+	}
+}
+
+/**
+ * @brief Relaxes every edge of column @p col (see propagate_edge()).
+ */
+static inline void
+propagate_column(activated_t *a, csc_idx_t col)
+{
+	const CSCBinaryMatrix *matrix = a->round->matrix;
+	csc_idx_t *label = a->round->label;
+	const csc_idx_t n = matrix->nrows;
+
+	if (col >= matrix->ncols)
+		return;
+
+	if (matrix->packed) {
+		CSCPackedIter it;
+		csc_idx_t row;
+
+		csc_packed_col(matrix->packed, col, &it);
+		while (csc_packed_next(&it, &row))
+			if (row < n)
+				propagate_edge(label, col, row, a);
+		return;
+	}
+
+	for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+		csc_idx_t row = matrix->row_idx[j];
+		if (row < n)
+			propagate_edge(label, col, row, a);
+	}
+}
+
+/**
+ * @brief Worker function: activates every node in this round's bitmap and
+ *        clears the next round's.
+ *
+ * @param arg Pointer to the shared frontier_round_t
+ * @return NULL
+ */
+static void *
+frontier_init_worker(void *arg)
+{
+	frontier_round_t *round = arg;
+	const csc_idx_t n = round->matrix->nrows;
+	size_t begin, end;
+	
+	while (next_chunk(round, round->words, &begin, &end)) {
+		for (size_t w = begin; w < end; w++) {
+			round->bits[w] = ~(uint64_t)0;
+			round->next_bits[w] = 0;
+		}
+		if (end == round->words && (n & 63))
+			round->bits[end - 1] = ((uint64_t)1 << (n & 63)) - 1;
+	}
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: relaxes the columns of chunks of this round's
+ *        active nodes, from the queue or from the bitmap.
+ *
+ * @param arg Pointer to the shared frontier_round_t
+ * @return NULL
+ */
+static void *
+frontier_propagate_worker(void *arg)
+{
+	frontier_round_t *round = arg;
+	activated_t a = { .round = round, .count = 0 };
+	size_t begin, end;
+	
+	if (round->sparse) {
+		while (next_chunk(round, round->count, &begin, &end))
+			for (size_t q = begin; q < end; q++)
+				propagate_column(&a, round->queue[q]);
+	} else {
+		while (next_chunk(round, round->words, &begin, &end))
+			for (size_t w = begin; w < end; w++)
+				for (uint64_t word = round->bits[w]; word; word &= word - 1)
+					propagate_column(&a, w * 64 + __builtin_ctzll(word));
+	}
+	
+	if (a.count)
+		flush_activated(&a);
+	
+	return NULL;
+}
+
+/**
+ * @brief Worker function: clears this round's bitmap for the round after
+ *        next, through the queue's words only in sparse rounds.
+ *
+ * @param arg Pointer to the shared frontier_round_t
+ * @return NULL
+ */
+static void *
+frontier_clear_worker(void *arg)
+{
+	frontier_round_t *round = arg;
+	size_t begin, end;
+	
+	if (round->sparse) {
+		while (next_chunk(round, round->count, &begin, &end))
+			for (size_t q = begin; q < end; q++)
+				__atomic_store_n(&round->bits[round->queue[q] >> 6], 0, __ATOMIC_RELAXED);
+	} else {
+		while (next_chunk(round, round->words, &begin, &end))
+			memset(round->bits + begin, 0, (end - begin) * sizeof(uint64_t));
+	}
+	
+	return NULL;
+}
+
+/* ========================================================================== */
+/*                              PREPARED PLAN                                 */
+/* ========================================================================== */
+
+/**
+ * @struct CCPlan
+ * @brief Buffers and workers reused by every run of a Pthreads plan.
+ */
+struct CCPlan {
+	const CSCBinaryMatrix *matrix;   /* Matrix the plan runs on */
+	unsigned int n_threads;          /* Shares per phase */
+	unsigned int variant;            /* Algorithm selection */
+	csc_idx_t *label;                /* Label array (nrows entries) */
+	csc_idx_t *size;                 /* Component size, then dense id, by root (nrows entries) */
+	csc_idx_t *grand;                /* Grandparent array (FastSV only, nrows entries) */
+	csc_idx_t *depth;                /* BFS depths (Multistep only, nrows entries) */
+	csc_idx_t *queue;                /* BFS queue (Multistep only, nrows entries) */
+	int mirrored;                    /* Every edge stored in both columns (variants 4 and 5) */
+	init_labels_args_t *init_args;   /* Per-thread label slices */
+	finalize_args_t *final_args;     /* Per-thread finalization slices */
+	fastsv_args_t *sv_args;          /* Per-thread FastSV slices (FastSV only) */
+	multistep_args_t *ms_args;       /* Per-thread Multistep slices (Multistep only) */
+	union_find_args_t *uf_args;      /* Per-thread column blocks (union-find under CSC_NUMA_LOCAL) */
+	frontier_t frontier;             /* Active nodes (frontier label propagation on mirrored matrices) */
+	CCSummary summary;               /* Statistics of the last run */
+	pool_t pool;                     /* Worker threads */
+	int pool_started;                /* pool needs pool_stop() */
+};
+
+/**
+ * @brief Points the per-thread slices of a plan at the label array @p label.
+ */
+static void
+plan_target(CCPlan *plan, csc_idx_t *label)
+{
+	for (unsigned i = 0; i < plan->n_threads; i++) {
+		plan->init_args[i].label = label;
+		plan->final_args[i].label = label;
+		if (plan->sv_args)
+			plan->sv_args[i].parent = label;
+		if (plan->ms_args)
+			plan->ms_args[i].label = label;
+		if (plan->uf_args)
+			plan->uf_args[i].label = label;
+	}
+}
+
+/**
+ * @brief Tells whether every edge of a plan's matrix is stored in both of
+ *        its columns, as bottom-up BFS steps and frontier label
+ *        propagation need.
+ *
+ * Only unpacked, square matrices with full storage qualify. A matrix
+ * mirrored by construction (a fully expanded symmetric input) is taken as
+ * is; a normalized one is checked (O(nnz log degree), once per plan, in
+ * the label slices); for any other matrix the answer is 0, which is
+ * always safe.
+ */
+static int
+edges_mirrored(CCPlan *plan)
+{
+	const CSCBinaryMatrix *matrix = plan->matrix;
+	int mirrored = 1;
+
+	if (matrix->half || matrix->packed || matrix->nrows != matrix->ncols)
+		return 0;
+	if (matrix->mirrored)
+		return 1;
+	if (!matrix->normalized)
+		return 0;
+
+	mirrored_args_t *args = malloc(plan->n_threads * sizeof(mirrored_args_t));
+	if (!args)
+		return 0;
+	for (unsigned i = 0; i < plan->n_threads; i++) {
+		args[i].matrix = matrix;
+		args[i].begin = plan->init_args[i].begin;
+		args[i].end = plan->init_args[i].end;
+		args[i].mirrored = &mirrored;
+	}
+	pool_run(&plan->pool, mirrored_worker, args, sizeof(mirrored_args_t));
+	free(args);
+
+	return mirrored;
+}
+
+/* ========================================================================== */
+/*                         UNION-FIND ALGORITHM                               */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components using parallel union-find.
+ *
+ * Algorithm phases:
+ * 1. Initialize each node as its own root
+ * 2. Perform parallel union operations on edges using multiple threads,
+ *    in dynamic chunks or in the static column blocks of plan->uf_args
+ * 3. Point every node straight at its root, in parallel slices
+ *
+ * @param plan Plan holding the matrix, slices and workers
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (1)
+ */
+static unsigned int
+cc_union_find(CCPlan *plan, csc_idx_t *label)
+{
+	const CSCBinaryMatrix *matrix = plan->matrix;
+	
+	/* Initialize: each node as its own parent */
+	pool_run(&plan->pool, init_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+	
+	/* Process all edges: union connected nodes */
+	atomic_size_t next_col;
+	atomic_store(&next_col, 0);
+	
+	union_find_args_t args = {
+		.matrix = matrix,
+		.label = label,
+		.next_col = &next_col,
+		.num_cols = matrix->ncols
+	};
+	
+	if (plan->uf_args)
+		pool_run(&plan->pool, union_find_worker, plan->uf_args, sizeof(union_find_args_t));
+	else
+		pool_run(&plan->pool, union_find_worker, &args, 0);
+	
+	/* Flatten all trees */
+	pool_run(&plan->pool, flatten_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+
+	return 1;
+}
+
+/* ========================================================================== */
+/*                   LABEL PROPAGATION WORKER THREAD                          */
+/* ========================================================================== */
+
+/**
+ * @struct label_propagation_args_t
+ * @brief Arguments for the label propagation worker thread.
+ *
+ * Each thread processes a subset of columns and updates labels atomically.
+ */
+typedef struct {
+	const CSCBinaryMatrix *matrix; /* Input CSC binary matrix */
+	csc_idx_t *label;              /* Label array */
+	atomic_size_t *next_col;       /* Atomic column counter for dynamic scheduling */
+	atomic_uint *global_change;    /* Atomic flag indicating if any label changed */
+} label_propagation_args_t;
+
+/**
+ * @brief Relaxes one edge (row, c) towards the smaller label.
+ *
+ * @param label Label array
+ * @param c Column node of the edge
+ * @param row Row node of the edge
+ * @return 1 if a label changed, 0 otherwise
+ */
+static inline uint8_t
+relax_edge(csc_idx_t *label, csc_idx_t c, csc_idx_t row)
+{
+	csc_idx_t label_col = label[c];
+	csc_idx_t label_row = label[row];
+	uint8_t changed = 0;
+	
+	if (label_col != label_row) {
+		csc_idx_t min_label = label_col < label_row ? label_col : label_row;
+		
+		/* Conditional atomic stores: only update if value changes */
+		if (label_col > min_label) {
+			__atomic_store_n(&label[c], min_label, __ATOMIC_RELAXED);
+			changed = 1;
+		}
+		if (label_row > min_label) {
+			__atomic_store_n(&label[row], min_label, __ATOMIC_RELAXED);
+			changed = 1;
+		}
+	}
+	
+	return changed;
+}
+
+/**
+ * @brief Worker function for optimized parallel label propagation.
+ *
+ * Each thread grabs a chunk of columns dynamically, then iterates over all
+ * edges in the chunk, updating the labels of connected nodes to the minimum
+ * value using conditional atomic stores. Sets a global flag if any label
+ * changed.
+ *
+ * Key optimization: Only performs atomic stores when the value actually
+ * changes, dramatically reducing atomic operation overhead and contention.
+ *
+ * @param arg Pointer to label_propagation_args_t structure
+ * @return NULL
+ */
+static void *
+label_propagation_worker(void *arg)
+{
+	label_propagation_args_t *args = arg;
+	const csc_idx_t CHUNK_SIZE = 4096;  /* Larger chunks for less overhead */
+	
+	while (1) {
+		/* Grab next chunk of columns */
+		csc_idx_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
+		if (col >= args->matrix->ncols)
+			break;
+		
+		csc_idx_t end_col = col + CHUNK_SIZE;
+		if (end_col > args->matrix->ncols)
+			end_col = args->matrix->ncols;
+		
+		uint8_t changed = 0;
+		
+		/* Process all edges in this chunk */
+		for (csc_idx_t c = col; c < end_col; c++) {
+			if (args->matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(args->matrix->packed, c, &it);
+				while (csc_packed_next(&it, &row))
+					changed |= relax_edge(args->label, c, row);
+			} else {
+				for (csc_ptr_t j = args->matrix->col_ptr[c]; j < args->matrix->col_ptr[c + 1]; j++)
+					changed |= relax_edge(args->label, c, args->matrix->row_idx[j]);
+			}
+		}
+		
+		/* Update global change flag if any local changes occurred */
+		if (changed)
+			atomic_store(args->global_change, 1);
+	}
+	
+	return NULL;
+}
+
+/* ========================================================================== */
+/*                       LABEL PROPAGATION ALGORITHM                          */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components using optimized parallel label propagation.
  *
  * Algorithm steps:
  * 1. Initialize each node with its own label
  * 2. Iterate until convergence:
  *    - Each thread updates labels of connected nodes with conditional atomics
  *    - A global atomic flag indicates whether any changes occurred
- * 3. Construct a bitmap of unique labels to count components efficiently
  *
  * Key optimization: Only perform atomic stores when values actually change,
  * which dramatically reduces atomic operation overhead.
  *
- * @param matrix Sparse CSC binary matrix representing graph
- * @param n_threads Number of Pthreads to use
- * @return Number of connected components, or -1 on error
+ * @param plan Plan holding the matrix, slices and workers
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (sweeps until no label changed)
+ */
+static unsigned int
+cc_label_propagation(CCPlan *plan, csc_idx_t *label)
+{
+	const CSCBinaryMatrix *matrix = plan->matrix;
+	
+	/* Initialize: each node labeled with its own index */
+	pool_run(&plan->pool, init_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+	
+	/* Iterate until convergence */
+	atomic_uint global_change;
+	
+	unsigned int sweeps = 0;
+	do {
+		sweeps++;
+		atomic_store(&global_change, 0);
+		atomic_size_t next_col;
+		atomic_store(&next_col, 0);
+		
+		label_propagation_args_t args = {
+			.matrix = matrix,
+			.label = label,
+			.next_col = &next_col,
+			.global_change = &global_change
+		};
+		
+		pool_run(&plan->pool, label_propagation_worker, &args, 0);
+		
+	} while (atomic_load(&global_change));
+
+	return sweeps;
+}
+
+/* ========================================================================== */
+/*                      POINTER-JUMPING WORKER THREADS                        */
+/* ========================================================================== */
+
+/**
+ * @brief Relaxes one edge (row, c) towards the smaller label, and hooks
+ *        the larger label's own label under the smaller one too.
+ *
+ * Every label is a node of the same component no larger than the node
+ * it labels, so the hook only lowers the label of a node of the same
+ * component. It lets the next shortcut rounds pass the smaller label to
+ * every node that still points at the larger one.
+ *
+ * @return 1 if the labels differed, 0 otherwise
+ */
+static inline uint8_t
+jump_edge(csc_idx_t *label, csc_idx_t c, csc_idx_t row)
+{
+	csc_idx_t label_col = __atomic_load_n(&label[c], __ATOMIC_RELAXED);
+	csc_idx_t label_row = __atomic_load_n(&label[row], __ATOMIC_RELAXED);
+	
+	if (label_col == label_row)
+		return 0;
+	
+	if (label_col > label_row) {
+		__atomic_store_n(&label[c], label_row, __ATOMIC_RELAXED);
+		write_min(&label[label_col], label_row);
+	} else {
+		__atomic_store_n(&label[row], label_col, __ATOMIC_RELAXED);
+		write_min(&label[label_row], label_col);
+	}
+	return 1;
+}
+
+/**
+ * @brief Worker function: relaxes and hooks every edge of chunks of
+ *        columns (see jump_edge()).
+ *
+ * @param arg Pointer to label_propagation_args_t
+ * @return NULL
+ */
+static void *
+jump_worker(void *arg)
+{
+	label_propagation_args_t *args = arg;
+	const CSCBinaryMatrix *matrix = args->matrix;
+	const csc_idx_t n = matrix->nrows;
+	const csc_idx_t CHUNK_SIZE = 4096;
+	uint8_t changed = 0;
+	
+	while (1) {
+		csc_idx_t col = atomic_fetch_add(args->next_col, CHUNK_SIZE);
+		if (col >= matrix->ncols)
+			break;
+		
+		csc_idx_t end_col = col + CHUNK_SIZE;
+		if (end_col > matrix->ncols)
+			end_col = matrix->ncols;
+		
+		for (csc_idx_t c = col; c < end_col; c++) {
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, c, &it);
+				while (csc_packed_next(&it, &row))
+					if (row < n)
+						changed |= jump_edge(args->label, c, row);
+			} else {
+				for (csc_ptr_t j = matrix->col_ptr[c]; j < matrix->col_ptr[c + 1]; j++) {
+					csc_idx_t row = matrix->row_idx[j];
+					if (row < n)
+						changed |= jump_edge(args->label, c, row);
+				}
+			}
+		}
+	}
+	
+	if (changed)
+		atomic_store(args->global_change, 1);
+	
+	return NULL;
+}
+
+/**
+ * @struct shortcut_args_t
+ * @brief Arguments for the pointer-jumping worker thread, shared by all
+ *        threads of a shortcut round.
+ */
+typedef struct {
+	csc_idx_t *label;              /* Label array */
+	csc_idx_t n;                   /* Number of nodes */
+	atomic_size_t *next;           /* Atomic node counter for dynamic scheduling */
+	atomic_uint *jumped;           /* Atomic flag indicating if any label changed */
+} shortcut_args_t;
+
+/**
+ * @brief Worker function: points every node of chunks of nodes at its
+ *        label's label.
+ *
+ * Every label is a node of the same component no larger than the node
+ * it labels, so label[label[v]] is one too and never larger than
+ * label[v]; concurrent rounds may read either.
+ *
+ * @param arg Pointer to shortcut_args_t
+ * @return NULL
+ */
+static void *
+shortcut_worker(void *arg)
+{
+	shortcut_args_t *args = arg;
+	const csc_idx_t CHUNK_SIZE = 4096;
+	uint8_t jumped = 0;
+	
+	while (1) {
+		csc_idx_t begin = atomic_fetch_add(args->next, CHUNK_SIZE);
+		if (begin >= args->n)
+			break;
+		
+		csc_idx_t end = begin + CHUNK_SIZE;
+		if (end > args->n)
+			end = args->n;
+		
+		for (csc_idx_t i = begin; i < end; i++) {
+			csc_idx_t parent = __atomic_load_n(&args->label[i], __ATOMIC_RELAXED);
+			csc_idx_t grand = __atomic_load_n(&args->label[parent], __ATOMIC_RELAXED);
+			if (grand < parent) {
+				__atomic_store_n(&args->label[i], grand, __ATOMIC_RELAXED);
+				jumped = 1;
+			}
+		}
+	}
+	
+	if (jumped)
+		atomic_store(args->jumped, 1);
+	
+	return NULL;
+}
+
+/* ========================================================================== */
+/*                  POINTER-JUMPING LABEL PROPAGATION ALGORITHM               */
+/* ========================================================================== */
+
+/**
+ * @brief Relaxes and hooks every edge once on the plan's workers.
+ *
+ * @return 1 if any label changed, 0 otherwise
  */
 static int
-cc_label_propagation(const CSCBinaryMatrix *matrix, unsigned int n_threads)
+jump_sweep(CCPlan *plan, csc_idx_t *label)
 {
-	const uint32_t n = matrix->nrows;
-	uint32_t *label = malloc(n * sizeof(uint32_t));
-	if (!label)
-		return -1;
+	atomic_uint global_change;
+	atomic_size_t next_col;
+	
+	atomic_store(&global_change, 0);
+	atomic_store(&next_col, 0);
+	
+	label_propagation_args_t args = {
+		.matrix = plan->matrix,
+		.label = label,
+		.next_col = &next_col,
+		.global_change = &global_change
+	};
+	
+	pool_run(&plan->pool, jump_worker, &args, 0);
+	
+	return atomic_load(&global_change);
+}
+
+/**
+ * @brief Points every node at its label's label until no label changes.
+ *
+ * One round halves every chain of labels; the rounds stop once every
+ * node points at a node labelled with itself.
+ *
+ * @return Shortcut rounds, the last of which changed nothing
+ */
+static unsigned int
+shortcut_labels(CCPlan *plan, csc_idx_t *label)
+{
+	atomic_size_t next;
+	atomic_uint jumped;
+	unsigned int rounds = 0;
+	
+	shortcut_args_t args = {
+		.label = label,
+		.n = plan->matrix->nrows,
+		.next = &next,
+		.jumped = &jumped
+	};
+	
+	do {
+		rounds++;
+		atomic_store(&next, 0);
+		atomic_store(&jumped, 0);
+		pool_run(&plan->pool, shortcut_worker, &args, 0);
+	} while (atomic_load(&jumped));
 	
+	return rounds;
+}
+
+/**
+ * @brief Computes connected components with label propagation sweeps
+ *        separated by pointer-jumping shortcut rounds.
+ *
+ * Algorithm steps:
+ * 1. Initialize each node with its own index as label
+ * 2. Sweep every edge once, propagating minimum labels and hooking the
+ *    larger label's own label under the smaller one (jump_edge())
+ * 3. If a label changed, shortcut the labels until stable
+ *    (label[v] = label[label[v]]) and sweep again
+ *
+ * The hooks link the labels into trees, and the shortcut rounds pass a
+ * root's label to every node below it at once, so long paths need a
+ * number of sweeps closer to the logarithm of their diameter than to
+ * the diameter itself.
+ *
+ * @param plan Plan holding the matrix, slices and workers
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @param shortcuts Set to the number of shortcut rounds run
+ * @return Passes over the edges (sweeps until no label changed)
+ */
+static unsigned int
+cc_pointer_jumping(CCPlan *plan, csc_idx_t *label, unsigned int *shortcuts)
+{
 	/* Initialize: each node labeled with its own index */
-	for (uint32_t i = 0; i < n; i++)
-		label[i] = i;
+	pool_run(&plan->pool, init_labels_worker, plan->init_args, sizeof(init_labels_args_t));
 	
-	/* Iterate until convergence */
-	atomic_uint global_change;
+	unsigned int sweeps = 0;
+	*shortcuts = 0;
+	for (;;) {
+		sweeps++;
+		if (!jump_sweep(plan, label))
+			break;
+		*shortcuts += shortcut_labels(plan, label);
+	}
 	
+	return sweeps;
+}
+
+/* ========================================================================== */
+/*                            FASTSV ALGORITHM                                */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components with FastSV.
+ *
+ * Every round:
+ * 1. Hook: for every edge, stochastic and aggressive hooking (hook_edge())
+ * 2. Shortcut: parent[v] = min(parent[v], grand[v])
+ * 3. Recompute grand[v] = parent[parent[v]]; stop when no grandparent
+ *    changed
+ *
+ * Each phase is one pool_run(), so the pool's wait is the barrier between
+ * them. Parents only decrease and every round at least halves the
+ * distance between a node and the minimum of its component, so the rounds
+ * grow with log n rather than the diameter. The converged parents hold
+ * the smallest node of every component.
+ *
+ * @param plan Plan whose FastSV slices point at the parent array
+ *        (plan_target())
+ * @return Rounds until the grandparents converged
+ */
+static unsigned int
+cc_fastsv(CCPlan *plan)
+{
+	fastsv_args_t *args = plan->sv_args;
+	atomic_size_t next_col;
+	atomic_uint changed;
+	unsigned int rounds = 0;
+
+	for (unsigned i = 0; i < plan->n_threads; i++) {
+		args[i].next_col = &next_col;
+		args[i].changed = &changed;
+	}
+
+	pool_run(&plan->pool, fastsv_init_worker, args, sizeof(fastsv_args_t));
+
 	do {
-		atomic_store(&global_change, 0);
-		atomic_uint next_col;
+		rounds++;
 		atomic_store(&next_col, 0);
-		
-		pthread_t threads[n_threads];
-		label_propagation_args_t args = {
+		atomic_store(&changed, 0);
+
+		pool_run(&plan->pool, fastsv_hook_worker, args, sizeof(fastsv_args_t));
+		pool_run(&plan->pool, fastsv_shortcut_worker, args, sizeof(fastsv_args_t));
+		pool_run(&plan->pool, fastsv_grand_worker, args, sizeof(fastsv_args_t));
+	} while (atomic_load(&changed));
+
+	return rounds;
+}
+
+/* ========================================================================== */
+/*                           MULTISTEP ALGORITHM                              */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components the Multistep way: a BFS from a
+ *        high-degree node, then union-find for what it did not reach.
+ *
+ * Algorithm phases:
+ * 1. Initialize labels and depths, and pick the node with the most stored
+ *    entries as the BFS root (parallel slices)
+ * 2. Direction-optimizing BFS: top-down steps while the frontier is
+ *    small, bottom-up steps (mirrored matrices only) once its edges exceed
+ *    1/MULTISTEP_ALPHA of the unexplored ones, top-down again once it
+ *    shrinks below 1/MULTISTEP_BETA of the nodes. As in Beamer's
+ *    heuristic, only top-down steps count explored edges, so the BFS
+ *    does not flip back and forth in its tail
+ * 3. Label every reached node with the smallest of them
+ * 4. Union-find over the columns of the unreached nodes
+ * 5. Point every node straight at its root, in parallel slices
+ *
+ * Each step is one pool_run(); threads append the nodes they discover to
+ * the shared queue in batches of MULTISTEP_BUFFER.
+ *
+ * The BFS reads the column of every node it reaches, so all rows of a
+ * reached column are reached too and phase 4 skips those columns whole.
+ * Without a mirrored matrix the BFS stays top-down: a node's own column
+ * may then miss some of its edges, and the top-down closure is what
+ * keeps the skip safe. Edges from unreached columns into the BFS
+ * component are linked in phase 4.
+ *
+ * @param plan Plan whose Multistep slices point at the label array
+ *        (plan_target())
+ * @return Passes over the edges (1)
+ */
+static unsigned int
+cc_multistep(CCPlan *plan)
+{
+	const CSCBinaryMatrix *matrix = plan->matrix;
+	const csc_idx_t n = matrix->nrows;
+	multistep_args_t *args = plan->ms_args;
+	multistep_step_t step = { .head = 0 };
+	csc_idx_t root = 0;
+	csc_ptr_t root_degree = 0;
+
+	for (unsigned i = 0; i < plan->n_threads; i++)
+		args[i].step = &step;
+
+	/* Initialize and find the root (ties go to the smaller node) */
+	pool_run(&plan->pool, multistep_init_worker, args, sizeof(multistep_args_t));
+	for (unsigned i = 0; i < plan->n_threads; i++) {
+		if (args[i].best_degree > root_degree) {
+			root_degree = args[i].best_degree;
+			root = args[i].best;
+		}
+	}
+
+	/* Direction-optimizing BFS */
+	size_t frontier_edges = root_degree;
+	size_t unexplored_edges = matrix->nnz - root_degree;
+	size_t last_frontier = 0;
+	int bottom_up = 0;
+
+	plan->depth[root] = 0;
+	plan->queue[0] = root;
+	step.tail = 1;
+	for (step.level = 0; step.head < step.tail; step.level++) {
+		step.end = step.tail;
+		size_t frontier = step.end - step.head;
+
+		if (plan->mirrored && !bottom_up && frontier_edges > unexplored_edges / MULTISTEP_ALPHA)
+			bottom_up = 1;
+		else if (bottom_up && frontier < last_frontier && frontier < n / MULTISTEP_BETA)
+			bottom_up = 0;
+		last_frontier = frontier;
+
+		atomic_store(&step.next, 0);
+		if (bottom_up) {
+			pool_run(&plan->pool, multistep_bottom_up_worker, args, sizeof(multistep_args_t));
+			frontier_edges = 0;
+		} else {
+			pool_run(&plan->pool, multistep_top_down_worker, args, sizeof(multistep_args_t));
+			frontier_edges = 0;
+			for (unsigned i = 0; i < plan->n_threads; i++)
+				frontier_edges += args[i].edges;
+			unexplored_edges -= frontier_edges;
+		}
+		step.head = step.end;
+	}
+
+	/* The smallest reached node labels the BFS component */
+	pool_run(&plan->pool, multistep_smallest_worker, args, sizeof(multistep_args_t));
+	step.smallest = root;
+	for (unsigned i = 0; i < plan->n_threads; i++)
+		if (args[i].best < step.smallest)
+			step.smallest = args[i].best;
+	pool_run(&plan->pool, multistep_label_worker, args, sizeof(multistep_args_t));
+
+	/* Union-find over the rest */
+	atomic_store(&step.next, 0);
+	pool_run(&plan->pool, multistep_union_worker, args, 0);
+
+	/* Flatten all trees */
+	pool_run(&plan->pool, flatten_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+
+	return 1;
+}
+
+/* ========================================================================== */
+/*                     FRONTIER LABEL PROPAGATION ALGORITHM                   */
+/* ========================================================================== */
+
+/**
+ * @brief Computes connected components with frontier-driven label
+ *        propagation.
+ *
+ * Algorithm steps:
+ * 1. Initialize each node with its own index; every node is active
+ * 2. Relax the columns of the active nodes only. A node whose label is
+ *    lowered becomes active in the next round, once (bitmap test-and-set)
+ * 3. Repeat until no node is active
+ *
+ * The matrix must be mirrored: every active node's column then holds all
+ * of its edges, and every edge whose labels may differ has an end that
+ * was lowered in the previous round. Late rounds therefore cost
+ * O(active edges) instead of O(nnz). Rounds with at most
+ * 1/FRONTIER_SPARSE of the nodes active walk the queue, denser rounds
+ * scan the bitmap a word at a time and skip empty words. Each round is
+ * two pool_run() calls: one relaxes, the next clears the round's bitmap.
+ * Rounds of at most FRONTIER_CHUNK active nodes, as in the long tail of
+ * a path, run on the calling thread instead.
+ *
+ * @param plan Plan holding the matrix, slices, frontier and workers
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Rounds until no node was active
+ */
+static unsigned int
+cc_frontier_propagation(CCPlan *plan, csc_idx_t *label)
+{
+	const csc_idx_t n = plan->matrix->nrows;
+	frontier_t *frontier = &plan->frontier;
+	frontier_round_t round = {
+		.matrix = plan->matrix,
+		.label = label,
+		.bits = frontier->bits[0],
+		.next_bits = frontier->bits[1],
+		.words = ((size_t)n + 63) / 64
+	};
+	unsigned int rounds = 0;
+	size_t count = n;
+	int cur = 0;
+
+	/* Initialize: each node its own label, all active */
+	pool_run(&plan->pool, init_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+	atomic_store(&round.next, 0);
+	pool_run(&plan->pool, frontier_init_worker, &round, 0);
+
+	while (count > 0) {
+		rounds++;
+		round.bits = frontier->bits[cur];
+		round.queue = frontier->queue[cur];
+		round.next_bits = frontier->bits[cur ^ 1];
+		round.next_queue = frontier->queue[cur ^ 1];
+		round.count = count;
+		round.sparse = count <= n / FRONTIER_SPARSE;
+		round.tail = 0;
+
+		/* A round of a single chunk runs on this thread alone */
+		atomic_store(&round.next, 0);
+		if (count > FRONTIER_CHUNK)
+			pool_run(&plan->pool, frontier_propagate_worker, &round, 0);
+		else
+			frontier_propagate_worker(&round);
+
+		/* Clear this round's bitmap for the round after next */
+		atomic_store(&round.next, 0);
+		if (count > FRONTIER_CHUNK)
+			pool_run(&plan->pool, frontier_clear_worker, &round, 0);
+		else
+			frontier_clear_worker(&round);
+
+		count = round.tail;
+		cur ^= 1;
+	}
+
+	return rounds;
+}
+
+/* ========================================================================== */
+/*                              PLAN LIFECYCLE                                */
+/* ========================================================================== */
+
+/**
+ * @copydoc cc_plan_create()
+ */
+CCPlan *
+cc_plan_create(const CSCBinaryMatrix *matrix,
+               unsigned int n_threads,
+               unsigned int algorithm_variant)
+{
+	if (!matrix)
+		return NULL;
+	if (algorithm_variant == 2 || algorithm_variant > 6) {
+		print_error(__func__, "variant not implemented by this backend", 0);
+		return NULL;
+	}
+	if (n_threads == 0)
+		n_threads = 1;
+
+	CCPlan *plan = calloc(1, sizeof(*plan));
+	if (!plan) {
+		print_error(__func__, "calloc() failed", errno);
+		return NULL;
+	}
+	plan->matrix = matrix;
+	plan->n_threads = n_threads;
+	plan->variant = algorithm_variant;
+
+	const csc_idx_t n = matrix->nrows;
+
+	plan->label = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+	plan->size = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+	plan->init_args = malloc(n_threads * sizeof(init_labels_args_t));
+	plan->final_args = calloc(n_threads, sizeof(finalize_args_t));
+
+	if (!plan->label || !plan->size || !plan->init_args || !plan->final_args) {
+		print_error(__func__, "malloc() failed", errno);
+		cc_plan_destroy(plan);
+		return NULL;
+	}
+
+	if (algorithm_variant == 3) {
+		plan->grand = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+		plan->sv_args = calloc(n_threads, sizeof(fastsv_args_t));
+		if (!plan->grand || !plan->sv_args) {
+			print_error(__func__, "malloc() failed", errno);
+			cc_plan_destroy(plan);
+			return NULL;
+		}
+	}
+
+	if (algorithm_variant == 4) {
+		plan->depth = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+		plan->queue = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_SEQUENTIAL);
+		plan->ms_args = calloc(n_threads, sizeof(multistep_args_t));
+		if (!plan->depth || !plan->queue || !plan->ms_args) {
+			print_error(__func__, "malloc() failed", errno);
+			cc_plan_destroy(plan);
+			return NULL;
+		}
+	}
+
+	/* Under CSC_NUMA_LOCAL thread i runs on the CPU of thread i of
+	 * csc_mem_place() and owns the nodes of the column block it copied */
+	const int local = matrix->mem.numa == CSC_NUMA_LOCAL;
+
+	if (local && algorithm_variant == 1) {
+		plan->uf_args = calloc(n_threads, sizeof(union_find_args_t));
+		if (!plan->uf_args) {
+			print_error(__func__, "malloc() failed", errno);
+			cc_plan_destroy(plan);
+			return NULL;
+		}
+	}
+
+	if (pool_start(&plan->pool, n_threads, local) != 0) {
+		print_error(__func__, "malloc() failed", errno);
+		cc_plan_destroy(plan);
+		return NULL;
+	}
+	plan->pool_started = 1;
+
+	/* Thread i owns the i-th of n_threads contiguous label slices: equal
+	 * ones, or the column blocks of csc_col_split() under CSC_NUMA_LOCAL
+	 * (the last one also takes any rows past the last column) */
+	csc_idx_t chunk = (n + n_threads - 1) / n_threads;
+	for (unsigned i = 0; i < n_threads; i++) {
+		init_labels_args_t *slice = &plan->init_args[i];
+		slice->label = plan->label;
+		if (local) {
+			size_t begin = csc_col_split(matrix, n_threads, i);
+			size_t end = csc_col_split(matrix, n_threads, i + 1);
+			slice->begin = (begin > n ? n : begin);
+			slice->end = (i + 1 == n_threads || end > n ? n : end);
+		} else {
+			slice->begin = (i * chunk > n ? n : i * chunk);
+			slice->end = (slice->begin + chunk > n ? n : slice->begin + chunk);
+		}
+		plan->final_args[i].label = plan->label;
+		plan->final_args[i].size = plan->size;
+		plan->final_args[i].begin = slice->begin;
+		plan->final_args[i].end = slice->end;
+		if (plan->sv_args) {
+			plan->sv_args[i].matrix = matrix;
+			plan->sv_args[i].parent = plan->label;
+			plan->sv_args[i].grand = plan->grand;
+			plan->sv_args[i].begin = slice->begin;
+			plan->sv_args[i].end = slice->end;
+		}
+		if (plan->ms_args) {
+			plan->ms_args[i].matrix = matrix;
+			plan->ms_args[i].label = plan->label;
+			plan->ms_args[i].depth = plan->depth;
+			plan->ms_args[i].queue = plan->queue;
+			plan->ms_args[i].begin = slice->begin;
+			plan->ms_args[i].end = slice->end;
+		}
+		if (plan->uf_args) {
+			plan->uf_args[i].matrix = matrix;
+			plan->uf_args[i].label = plan->label;
+			plan->uf_args[i].num_cols = matrix->ncols;
+			plan->uf_args[i].begin = csc_col_split(matrix, n_threads, i);
+			plan->uf_args[i].end = csc_col_split(matrix, n_threads, i + 1);
+		}
+	}
+
+	/* Fault the pages in now; under CSC_NUMA_LOCAL every slice is first
+	 * touched by the pool thread that initializes and finalizes it later */
+	pool_run(&plan->pool, init_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+	pool_run(&plan->pool, count_roots_worker, plan->final_args, sizeof(finalize_args_t));
+	if (plan->sv_args)
+		pool_run(&plan->pool, fastsv_init_worker, plan->sv_args, sizeof(fastsv_args_t));
+	if (algorithm_variant == 4 || algorithm_variant == 5)
+		plan->mirrored = edges_mirrored(plan);
+	if (plan->ms_args)
+		pool_run(&plan->pool, multistep_init_worker, plan->ms_args, sizeof(multistep_args_t));
+
+	/* Without mirrored storage, frontier label propagation sweeps every column */
+	if (algorithm_variant == 5 && plan->mirrored) {
+		const size_t words = ((size_t)n + 63) / 64;
+
+		for (int k = 0; k < 2; k++) {
+			plan->frontier.bits[k] = mem_alloc(words * sizeof(uint64_t), &matrix->mem, CSC_ACCESS_RANDOM);
+			plan->frontier.queue[k] = mem_alloc(n * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_SEQUENTIAL);
+			if (!plan->frontier.bits[k] || !plan->frontier.queue[k]) {
+				print_error(__func__, "malloc() failed", errno);
+				cc_plan_destroy(plan);
+				return NULL;
+			}
+
+			/* The queues are filled in the label slices: borrow them */
+			plan_target(plan, plan->frontier.queue[k]);
+			pool_run(&plan->pool, init_labels_worker, plan->init_args, sizeof(init_labels_args_t));
+		}
+		plan_target(plan, plan->label);
+
+		frontier_round_t round = {
 			.matrix = matrix,
-			.label = label,
-			.next_col = &next_col,
-			.global_change = &global_change
+			.bits = plan->frontier.bits[0],
+			.next_bits = plan->frontier.bits[1],
+			.words = words
 		};
-		
-		for (unsigned i = 0; i < n_threads; i++)
-			pthread_create(&threads[i], NULL, label_propagation_worker, &args);
-		for (unsigned i = 0; i < n_threads; i++)
-			pthread_join(threads[i], NULL);
-		
-	} while (atomic_load(&global_change));
-	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (n + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
+		atomic_store(&round.next, 0);
+		pool_run(&plan->pool, frontier_init_worker, &round, 0);
 	}
-	
-	/* Bitmap construction: set bit for each unique label */
-	for (uint32_t i = 0; i < n; i++) {
-		uint32_t val = label[i];
-		bitmap[val >> 6] |= (1ULL << (val & 63));
+
+	return plan;
+}
+
+/**
+ * @brief Counts the components of a flat labelling and measures their sizes.
+ *
+ * Every thread counts the roots of its slice; the prefix sum over the
+ * slices gives every slice the dense id of its first root. The sizes are
+ * accumulated at the roots, then every slice summarizes its own roots.
+ *
+ * @param plan Plan whose slices point at the labels
+ * @return Number of connected components
+ */
+static size_t
+finalize(CCPlan *plan)
+{
+	finalize_args_t *args = plan->final_args;
+	CCSummary *sum = &plan->summary;
+	size_t first = 0;
+
+	pool_run(&plan->pool, count_roots_worker, args, sizeof(finalize_args_t));
+	for (unsigned i = 0; i < plan->n_threads; i++) {
+		args[i].first = first;
+		first += args[i].roots;
 	}
-	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++)
-		count += __builtin_popcountll(bitmap[i]);
-	
-	free(bitmap);
-	free(label);
+
+	pool_run(&plan->pool, accumulate_sizes_worker, args, sizeof(finalize_args_t));
+	pool_run(&plan->pool, summarize_worker, args, sizeof(finalize_args_t));
+
+	memset(sum, 0, sizeof(*sum));
+	for (unsigned i = 0; i < plan->n_threads; i++) {
+		sum->components += args[i].summary.components;
+		if (args[i].summary.largest > sum->largest)
+			sum->largest = args[i].summary.largest;
+		for (unsigned b = 0; b < CC_SIZE_BUCKETS; b++)
+			sum->size_histogram[b] += args[i].summary.size_histogram[b];
+	}
+
+	return sum->components;
+}
+
+/**
+ * @brief Runs the plan's kernel on @p label, then finalize(), and records
+ *        the kernel's passes over the edges.
+ */
+static int
+plan_run(CCPlan *plan, csc_idx_t *label)
+{
+	if (plan->matrix->nrows == 0) {
+		memset(&plan->summary, 0, sizeof(plan->summary));
+		return 0;
+	}
+
+	plan_target(plan, label);
+
+	unsigned int rounds;
+	unsigned int shortcuts = 0;
+	unsigned int fallback = 0;
+
+	switch (plan->variant) {
+	case 0:
+		rounds = cc_label_propagation(plan, label);
+		break;
+	case 1:
+		rounds = cc_union_find(plan, label);
+		break;
+	case 3:
+		rounds = cc_fastsv(plan);
+		break;
+	case 4:
+		rounds = cc_multistep(plan);
+		fallback = !plan->mirrored;
+		break;
+	case 5:
+		if (plan->mirrored)
+			rounds = cc_frontier_propagation(plan, label);
+		else
+			rounds = cc_label_propagation(plan, label);
+		fallback = !plan->mirrored;
+		break;
+	case 6:
+		rounds = cc_pointer_jumping(plan, label, &shortcuts);
+		break;
+	default:
+		return -1;
+	}
+	size_t count = finalize(plan);
+	plan->summary.rounds = rounds;
+	plan->summary.shortcut_rounds = shortcuts;
+	plan->summary.fallback = fallback;
+	return (int)count;
+}
+
+/**
+ * @copydoc cc_plan_execute()
+ */
+int
+cc_plan_execute(CCPlan *plan)
+{
+	if (!plan)
+		return -1;
+
+	return plan_run(plan, plan->label);
+}
+
+/**
+ * @copydoc cc_plan_labels()
+ */
+int
+cc_plan_labels(CCPlan *plan, csc_idx_t *labels)
+{
+	if (!plan || !labels)
+		return -1;
+
+	return plan_run(plan, labels);
+}
+
+/**
+ * @copydoc cc_plan_dense_labels()
+ */
+int
+cc_plan_dense_labels(CCPlan *plan, csc_idx_t *labels)
+{
+	if (!plan || !labels)
+		return -1;
+
+	int count = plan_run(plan, labels);
+	if (count <= 0)
+		return count;
+
+	/* The sizes are summarized already: reuse the array for the ids */
+	pool_run(&plan->pool, number_roots_worker, plan->final_args, sizeof(finalize_args_t));
+	pool_run(&plan->pool, relabel_worker, plan->final_args, sizeof(finalize_args_t));
+
 	return count;
 }
 
+/**
+ * @copydoc cc_plan_summary()
+ */
+const CCSummary *
+cc_plan_summary(const CCPlan *plan)
+{
+	return &plan->summary;
+}
+
+/**
+ * @copydoc cc_plan_destroy()
+ */
+void
+cc_plan_destroy(CCPlan *plan)
+{
+	if (!plan)
+		return;
+
+	if (plan->pool_started)
+		pool_stop(&plan->pool);
+	mem_free(plan->label, &plan->matrix->mem);
+	mem_free(plan->size, &plan->matrix->mem);
+	mem_free(plan->grand, &plan->matrix->mem);
+	mem_free(plan->depth, &plan->matrix->mem);
+	mem_free(plan->queue, &plan->matrix->mem);
+	for (int k = 0; k < 2; k++) {
+		mem_free(plan->frontier.bits[k], &plan->matrix->mem);
+		mem_free(plan->frontier.queue[k], &plan->matrix->mem);
+	}
+	free(plan->init_args);
+	free(plan->final_args);
+	free(plan->sv_args);
+	free(plan->ms_args);
+	free(plan->uf_args);
+	free(plan);
+}
+
 /* ========================================================================== */
 /*                              PUBLIC INTERFACE                              */
 /* ========================================================================== */
@@ -456,16 +2521,20 @@ cc_label_propagation(const CSCBinaryMatrix *matrix, unsigned int n_threads)
  * @brief Computes connected components using Pthreads parallel algorithms.
  *
  * This is the main entry point for Pthreads connected components computation.
- * It dispatches to one of two algorithm implementations based on the variant
- * parameter.
+ * It runs a one-shot plan, which dispatches to one of six algorithm
+ * implementations based on the variant parameter.
  *
  * Supported variants:
  *   0: Label propagation
  *   1: Union-find with Rem's algorithm
+ *   3: FastSV (hooking and shortcutting in O(log n) rounds)
+ *   4: Multistep (BFS from a high-degree node, then union-find)
+ *   5: Frontier label propagation (relaxes only the active columns)
+ *   6: Pointer-jumping label propagation (shortcut rounds between sweeps)
  *
  * @param matrix Sparse binary matrix in CSC format
  * @param n_threads Number of threads to use
- * @param algorithm_variant Algorithm selection (0 or 1)
+ * @param algorithm_variant Algorithm selection (0, 1, 3, 4, 5 or 6)
  * @return Number of connected components, or -1 on error
  */
 int
@@ -473,13 +2542,29 @@ cc_pthreads(const CSCBinaryMatrix *matrix,
             unsigned int n_threads,
             unsigned int algorithm_variant)
 {
-	switch (algorithm_variant) {
-	case 0:
-		return cc_label_propagation(matrix, n_threads);
-	case 1:
-		return cc_union_find(matrix, n_threads);
-	default:
-		break;
-	}
-	return -1;
+	CCPlan *plan = cc_plan_create(matrix, n_threads, algorithm_variant);
+	if (!plan)
+		return -1;
+
+	int count = cc_plan_execute(plan);
+	cc_plan_destroy(plan);
+	return count;
+}
+
+/**
+ * @copydoc cc_labels()
+ */
+int
+cc_labels(const CSCBinaryMatrix *matrix,
+          unsigned int n_threads,
+          unsigned int algorithm_variant,
+          csc_idx_t *labels)
+{
+	CCPlan *plan = cc_plan_create(matrix, n_threads, algorithm_variant);
+	if (!plan)
+		return -1;
+
+	int count = cc_plan_labels(plan, labels);
+	cc_plan_destroy(plan);
+	return count;
 }
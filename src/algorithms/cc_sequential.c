@@ -2,7 +2,7 @@
  * @file cc_sequential.c
  * @brief Optimized sequential algorithms for computing connected components.
  *
- * This module implements two sequential algorithms for finding connected
+ * This module implements three sequential algorithms for finding connected
  * components in an undirected graph represented as a sparse binary matrix:
  *
  * - Label Propagation (variant 0): Iteratively propagates minimum labels
@@ -11,12 +11,22 @@
  * - Union-Find (variant 1): Uses disjoint-set data structure with path
  *   halving optimization. Generally faster and more scalable.
  *
- * Both algorithms return the count of unique connected components.
+ * - Frontier label propagation (variant 5): label propagation that only
+ *   relaxes the columns of nodes whose label changed in the previous
+ *   round.
+ *
+ * All algorithms return the count of unique connected components. When
+ * the matrix carries compressed row indices (see packed.h), the kernels
+ * decode them on the fly instead of reading row_idx.
  */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include "connected_components.h"
+#include "packed.h"
+#include "mem.h"
 #include "error.h"
 
 /* ========================================================================== */
@@ -35,8 +45,8 @@
  * @param i Node to find root for
  * @return Root node (where label[root] == root)
  */
-static inline uint32_t
-find_root_halving(uint32_t *label, uint32_t i)
+static inline csc_idx_t
+find_root_halving(csc_idx_t *label, csc_idx_t i)
 {
 	while (label[i] != i) {
 		label[i] = label[label[i]];  /* Path halving: skip one level */
@@ -59,10 +69,10 @@ find_root_halving(uint32_t *label, uint32_t i)
  * @return 1 if union was performed, 0 if nodes already in same set
  */
 static inline int
-union_nodes_by_index(uint32_t *label, uint32_t i, uint32_t j)
+union_nodes_by_index(csc_idx_t *label, csc_idx_t i, csc_idx_t j)
 {
-	uint32_t root_i = find_root_halving(label, i);
-	uint32_t root_j = find_root_halving(label, j);
+	csc_idx_t root_i = find_root_halving(label, i);
+	csc_idx_t root_j = find_root_halving(label, j);
 	
 	if (root_i == root_j)
 		return 0;
@@ -82,54 +92,87 @@ union_nodes_by_index(uint32_t *label, uint32_t i, uint32_t j)
  * Algorithm steps:
  * 1. Initialize each node as its own parent (singleton sets)
  * 2. For each edge (i,j), union the sets containing i and j
- * 3. Perform final path compression to flatten all trees
- * 4. Count nodes that are their own parent (roots = components)
+ * 3. Flatten all trees, so every node holds its root (the smallest node)
+ *
+ * Counting is left to finalize().
  *
  * @param matrix Sparse binary matrix in CSC format representing graph
- * @return Number of connected components, or -1 on error
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (1)
  */
-static int
-cc_union_find(const CSCBinaryMatrix *matrix)
+static unsigned int
+cc_union_find(const CSCBinaryMatrix *matrix, csc_idx_t *label)
 {
-	uint32_t *label = malloc(matrix->nrows * sizeof(uint32_t));
-	if (!label) {
-		print_error(__func__, "malloc() failed", errno);
-		return -1;
-	}
-	
 	/* Initialize: each node is its own parent */
 	for (size_t i = 0; i < matrix->nrows; i++) {
 		label[i] = i;
 	}
 	
 	/* Process all edges: union connected nodes */
-	for (size_t i = 0; i < matrix->ncols; i++) {
-		for (uint32_t j = matrix->col_ptr[i]; j < matrix->col_ptr[i + 1]; j++) {
-			union_nodes_by_index(label, i, matrix->row_idx[j]);
+	if (matrix->packed) {
+		for (size_t i = 0; i < matrix->ncols; i++) {
+			CSCPackedIter it;
+			csc_idx_t row;
+
+			csc_packed_col(matrix->packed, i, &it);
+			while (csc_packed_next(&it, &row))
+				union_nodes_by_index(label, i, row);
+		}
+	} else {
+		for (size_t i = 0; i < matrix->ncols; i++) {
+			for (csc_ptr_t j = matrix->col_ptr[i]; j < matrix->col_ptr[i + 1]; j++) {
+				union_nodes_by_index(label, i, matrix->row_idx[j]);
+			}
 		}
 	}
 	
-	/* Final compression pass: flatten all paths for accurate counting */
-	for (size_t i = 0; i < matrix->nrows; i++) {
-		find_root_halving(label, i);
-	}
-	
-	/* Count roots (each root represents one component) */
-	uint32_t unique_count = 0;
+	/* Final pass: parents are never larger than their children, so the
+	 * parent of node i already holds its root when i is reached */
 	for (size_t i = 0; i < matrix->nrows; i++) {
-		if (label[i] == i) {
-			unique_count++;
-		}
+		label[i] = label[label[i]];
 	}
-	
-	free(label);
-	return (int)unique_count;
+
+	return 1;
 }
 
 /* ========================================================================== */
 /*                       LABEL PROPAGATION ALGORITHM                          */
 /* ========================================================================== */
 
+/**
+ * @brief Relaxes one edge (row, col) towards the smaller label.
+ *
+ * @param label Label array
+ * @param col Column node of the edge
+ * @param row Row node of the edge
+ * @param col_label Cached label of @p col (updated in place)
+ * @return 1 if a label changed, 0 otherwise
+ */
+static inline int
+relax_edge(csc_idx_t *label, size_t col, csc_idx_t row, csc_idx_t *col_label)
+{
+	csc_idx_t row_label = label[row];
+	int changed = 0;
+
+	if (*col_label != row_label) {
+		csc_idx_t min_label = *col_label < row_label ? *col_label : row_label;
+
+		/* Update column label if needed (and cache it) */
+		if (*col_label > min_label) {
+			label[col] = *col_label = min_label;
+			changed = 1;
+		}
+
+		/* Update row label if needed */
+		if (row_label > min_label) {
+			label[row] = min_label;
+			changed = 1;
+		}
+	}
+
+	return changed;
+}
+
 /**
  * @brief Computes connected components using optimized label propagation.
  *
@@ -137,23 +180,20 @@ cc_union_find(const CSCBinaryMatrix *matrix)
  * 1. Initialize each node with its own index as label
  * 2. Iterate over all edges, propagating minimum labels
  * 3. Use cached column label to reduce redundant reads
- * 4. Repeat until no labels change (convergence)
- * 5. Count unique components using bitmap with hardware popcount
+ * 4. Repeat until no labels change (convergence): every node then holds
+ *    the smallest node of its component
  *
  * Optimization: Cache the column label in the inner loop to avoid
  * redundant memory reads when processing multiple edges in the same column.
+ * Counting is left to finalize().
  *
  * @param matrix Sparse binary matrix in CSC format representing graph
- * @return Number of connected components, or -1 on error
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @return Passes over the edges (sweeps until no label changed)
  */
-static int
-cc_label_propagation(const CSCBinaryMatrix *matrix)
+static unsigned int
+cc_label_propagation(const CSCBinaryMatrix *matrix, csc_idx_t *label)
 {
-	uint32_t *label = malloc(sizeof(uint32_t) * matrix->nrows);
-	if (!label) {
-		return -1;
-	}
-	
 	/* Initialize: each node labeled with its own index */
 	for (size_t i = 0; i < matrix->nrows; i++) {
 		label[i] = i;
@@ -161,61 +201,434 @@ cc_label_propagation(const CSCBinaryMatrix *matrix)
 	
 	/* Iterate until convergence */
 	uint8_t finished;
+	unsigned int sweeps = 0;
 	do {
 		finished = 1;
+		sweeps++;
 		
 		/* Process all edges, propagating minimum labels */
 		for (size_t i = 0; i < matrix->ncols; i++) {
-			uint32_t col_label = label[i];  /* Cache column label */
+			csc_idx_t col_label = label[i];  /* Cache column label */
 			
-			for (uint32_t j = matrix->col_ptr[i]; j < matrix->col_ptr[i + 1]; j++) {
-				uint32_t row = matrix->row_idx[j];
-				uint32_t row_label = label[row];
-				
-				if (col_label != row_label) {
-					uint32_t min_label = col_label < row_label ? col_label : row_label;
-					
-					/* Update column label if needed (and cache it) */
-					if (col_label > min_label) {
-						label[i] = col_label = min_label;
+			if (matrix->packed) {
+				CSCPackedIter it;
+				csc_idx_t row;
+
+				csc_packed_col(matrix->packed, i, &it);
+				while (csc_packed_next(&it, &row))
+					if (relax_edge(label, i, row, &col_label))
 						finished = 0;
-					}
-					
-					/* Update row label if needed */
-					if (row_label > min_label) {
-						label[row] = min_label;
+			} else {
+				for (csc_ptr_t j = matrix->col_ptr[i]; j < matrix->col_ptr[i + 1]; j++)
+					if (relax_edge(label, i, matrix->row_idx[j], &col_label))
 						finished = 0;
-					}
-				}
 			}
 		}
 	} while (!finished);
-	
-	/* Count unique components using a bitmap */
-	size_t bitmap_size = (matrix->nrows + 63) / 64;
-	uint64_t *bitmap = calloc(bitmap_size, sizeof(uint64_t));
-	if (!bitmap) {
-		free(label);
-		return -1;
+
+	return sweeps;
+}
+
+/* ========================================================================== */
+/*                       FRONTIER LABEL PROPAGATION                           */
+/* ========================================================================== */
+
+/** Rounds whose frontier holds at most 1/FRONTIER_SPARSE of the nodes walk
+ *  its queue; larger frontiers scan its bitmap in column order */
+#define FRONTIER_SPARSE 20
+
+/**
+ * @struct frontier_t
+ * @brief Active nodes of the current and the next round, each kept both as
+ *        a bitmap and as a queue.
+ */
+typedef struct {
+	uint64_t *bits[2];   /* Bitmaps of (nrows + 63) / 64 words */
+	csc_idx_t *queue[2]; /* Queues of nrows entries, each node at most once */
+	size_t tail;         /* Entries of the next round's queue in use */
+} frontier_t;
+
+/**
+ * @brief Tells whether @p col is stored in column @p row, by binary search
+ *        over the sorted rows of a normalized matrix.
+ */
+static inline int
+has_entry(const CSCBinaryMatrix *matrix, csc_idx_t row, csc_idx_t col)
+{
+	csc_ptr_t lo = matrix->col_ptr[row];
+	csc_ptr_t hi = matrix->col_ptr[row + 1];
+
+	while (lo < hi) {
+		csc_ptr_t mid = lo + (hi - lo) / 2;
+		if (matrix->row_idx[mid] < col)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
-	
-	/* Bitmap construction: set bit for each unique label */
-	for (uint32_t i = 0; i < matrix->nrows; i++) {
-		uint32_t val = label[i];
-		bitmap[val >> 6] |= (1ULL << (val & 63));
+	return lo < matrix->col_ptr[row + 1] && matrix->row_idx[lo] == col;
+}
+
+/**
+ * @brief Tells whether every edge of @p matrix is stored in both of its
+ *        columns, as frontier label propagation needs.
+ *
+ * Only unpacked, square matrices with full storage qualify. A matrix
+ * mirrored by construction (a fully expanded symmetric input) is taken as
+ * is; a normalized one is checked (O(nnz log degree), once per plan); for
+ * any other matrix the answer is 0, which is always safe.
+ */
+static int
+edges_mirrored(const CSCBinaryMatrix *matrix)
+{
+	if (matrix->half || matrix->packed || matrix->nrows != matrix->ncols)
+		return 0;
+	if (matrix->mirrored)
+		return 1;
+	if (!matrix->normalized)
+		return 0;
+
+	for (size_t col = 0; col < matrix->ncols; col++)
+		for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++)
+			if (!has_entry(matrix, matrix->row_idx[j], col))
+				return 0;
+
+	return 1;
+}
+
+/**
+ * @brief Adds node @p v to the next round's frontier unless it is there
+ *        already.
+ */
+static inline void
+activate(frontier_t *frontier, int next, csc_idx_t v)
+{
+	uint64_t mask = (uint64_t)1 << (v & 63);
+
+	if (frontier->bits[next][v >> 6] & mask)
+		return;
+	frontier->bits[next][v >> 6] |= mask;
+	frontier->queue[next][frontier->tail++] = v;
+}
+
+/**
+ * @brief Relaxes every edge of column @p col towards the smaller label
+ *        and activates every node whose label was lowered.
+ */
+static inline void
+propagate_column(const CSCBinaryMatrix *matrix, csc_idx_t *label, csc_idx_t col,
+                 frontier_t *frontier, int next)
+{
+	const csc_idx_t n = matrix->nrows;
+
+	if (col >= matrix->ncols)
+		return;
+
+	for (csc_ptr_t j = matrix->col_ptr[col]; j < matrix->col_ptr[col + 1]; j++) {
+		csc_idx_t row = matrix->row_idx[j];
+
+		if (row >= n || label[row] == label[col])
+			continue;
+		if (label[col] > label[row]) {
+			label[col] = label[row];
+			activate(frontier, next, col);
+		} else {
+			label[row] = label[col];
+			activate(frontier, next, row);
+		}
 	}
-	
-	/* Count set bits using hardware popcount */
-	uint32_t count = 0;
-	for (size_t i = 0; i < bitmap_size; i++) {
-		count += __builtin_popcountll(bitmap[i]);
+}
+
+/**
+ * @brief Computes connected components with frontier-driven label
+ *        propagation.
+ *
+ * Algorithm steps:
+ * 1. Initialize each node with its own index; every node is active
+ * 2. Relax the columns of the active nodes only. A node whose label is
+ *    lowered becomes active in the next round, once (bitmap)
+ * 3. Repeat until no node is active
+ *
+ * The matrix must be mirrored (unpacked, as edges_mirrored() checks):
+ * every active node's column then holds all of its edges, and every edge
+ * whose labels may differ has an end that was lowered in the previous
+ * round. Late rounds therefore cost O(active edges) instead of O(nnz).
+ *
+ * @param matrix Sparse binary matrix in CSC format (mirrored)
+ * @param label Label array of matrix->nrows entries (overwritten)
+ * @param frontier Bitmaps and queues of the plan (overwritten)
+ * @return Rounds until no node was active
+ */
+static unsigned int
+cc_frontier_propagation(const CSCBinaryMatrix *matrix, csc_idx_t *label,
+                        frontier_t *frontier)
+{
+	const csc_idx_t n = matrix->nrows;
+	const size_t words = ((size_t)n + 63) / 64;
+	unsigned int rounds = 0;
+	size_t count = n;
+	int cur = 0;
+
+	/* Initialize: each node its own label, all active */
+	for (size_t i = 0; i < n; i++)
+		label[i] = i;
+	memset(frontier->bits[0], 0xff, words * sizeof(uint64_t));
+	memset(frontier->bits[1], 0, words * sizeof(uint64_t));
+	if (n & 63)
+		frontier->bits[0][words - 1] = ((uint64_t)1 << (n & 63)) - 1;
+
+	while (count > 0) {
+		uint64_t *bits = frontier->bits[cur];
+		const csc_idx_t *queue = frontier->queue[cur];
+
+		rounds++;
+		frontier->tail = 0;
+
+		if (count <= n / FRONTIER_SPARSE) {
+			for (size_t q = 0; q < count; q++)
+				propagate_column(matrix, label, queue[q], frontier, cur ^ 1);
+			for (size_t q = 0; q < count; q++)
+				bits[queue[q] >> 6] = 0;
+		} else {
+			for (size_t w = 0; w < words; w++) {
+				for (uint64_t word = bits[w]; word; word &= word - 1)
+					propagate_column(matrix, label, w * 64 + __builtin_ctzll(word),
+					                 frontier, cur ^ 1);
+				bits[w] = 0;
+			}
+		}
+
+		count = frontier->tail;
+		cur ^= 1;
 	}
-	
-	free(label);
-	free(bitmap);
+
+	return rounds;
+}
+
+/* ========================================================================== */
+/*                              PREPARED PLANS                                */
+/* ========================================================================== */
+
+/**
+ * @struct CCPlan
+ * @brief Buffers reused by every run of a sequential plan.
+ */
+struct CCPlan {
+	const CSCBinaryMatrix *matrix; /* Matrix the plan runs on */
+	unsigned int variant;          /* Algorithm selection */
+	csc_idx_t *label;              /* Label array (nrows entries) */
+	csc_idx_t *size;               /* Component size by root, then dense id by root (nrows entries) */
+	int mirrored;                  /* Every edge stored in both columns (variant 5 only) */
+	frontier_t frontier;           /* Active nodes (frontier label propagation on mirrored matrices) */
+	CCSummary summary;             /* Statistics of the last run */
+};
+
+/**
+ * @copydoc cc_plan_create()
+ */
+CCPlan *
+cc_plan_create(const CSCBinaryMatrix *matrix,
+               const unsigned int n_threads __attribute__((unused)),
+               const unsigned int algorithm_variant)
+{
+	if (!matrix)
+		return NULL;
+	if (algorithm_variant > 1 && algorithm_variant != 5) {
+		print_error(__func__, "variant not implemented by this backend", 0);
+		return NULL;
+	}
+
+	CCPlan *plan = calloc(1, sizeof(*plan));
+	if (!plan) {
+		print_error(__func__, "calloc() failed", errno);
+		return NULL;
+	}
+	plan->matrix = matrix;
+	plan->variant = algorithm_variant;
+
+	plan->label = mem_alloc(matrix->nrows * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+	if (!plan->label) {
+		print_error(__func__, "malloc() failed", errno);
+		cc_plan_destroy(plan);
+		return NULL;
+	}
+
+	plan->size = mem_alloc(matrix->nrows * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_RANDOM);
+	if (!plan->size) {
+		print_error(__func__, "malloc() failed", errno);
+		cc_plan_destroy(plan);
+		return NULL;
+	}
+
+	if (algorithm_variant == 5)
+		plan->mirrored = edges_mirrored(matrix);
+
+	/* Without mirrored storage, frontier label propagation sweeps every column */
+	if (algorithm_variant == 5 && plan->mirrored) {
+		const size_t words = (matrix->nrows + 63) / 64;
+
+		for (int k = 0; k < 2; k++) {
+			plan->frontier.bits[k] = mem_alloc(words * sizeof(uint64_t), &matrix->mem, CSC_ACCESS_RANDOM);
+			plan->frontier.queue[k] = mem_alloc(matrix->nrows * sizeof(csc_idx_t), &matrix->mem, CSC_ACCESS_SEQUENTIAL);
+			if (!plan->frontier.bits[k] || !plan->frontier.queue[k]) {
+				print_error(__func__, "malloc() failed", errno);
+				cc_plan_destroy(plan);
+				return NULL;
+			}
+			memset(plan->frontier.bits[k], 0, words * sizeof(uint64_t));
+			memset(plan->frontier.queue[k], 0, matrix->nrows * sizeof(csc_idx_t));
+		}
+	}
+
+	/* Fault the pages in now rather than in the first run */
+	for (size_t i = 0; i < matrix->nrows; i++)
+		plan->label[i] = i;
+	memset(plan->size, 0, matrix->nrows * sizeof(csc_idx_t));
+
+	return plan;
+}
+
+/**
+ * @brief Counts the components of a flat labelling and measures their sizes.
+ *
+ * @param plan Plan whose size array and summary are filled
+ * @param label Labels, every node holding the smallest node of its component
+ * @return Number of connected components
+ */
+static size_t
+finalize(CCPlan *plan, const csc_idx_t *label)
+{
+	const size_t n = plan->matrix->nrows;
+	csc_idx_t *size = plan->size;
+	CCSummary *sum = &plan->summary;
+
+	memset(sum, 0, sizeof(*sum));
+	memset(size, 0, n * sizeof(csc_idx_t));
+
+	for (size_t i = 0; i < n; i++)
+		size[label[i]]++;
+
+	/* Roots are the nodes labelled with themselves */
+	for (size_t i = 0; i < n; i++) {
+		if (label[i] != i)
+			continue;
+		sum->components++;
+		if (size[i] > sum->largest)
+			sum->largest = size[i];
+		sum->size_histogram[cc_size_bucket(size[i])]++;
+	}
+
+	return sum->components;
+}
+
+/**
+ * @brief Runs the plan's kernel on @p label, then finalize(), and records
+ *        the kernel's passes over the edges.
+ */
+static int
+plan_run(CCPlan *plan, csc_idx_t *label)
+{
+	unsigned int rounds;
+	unsigned int fallback = 0;
+
+	switch (plan->variant) {
+	case 0:
+		rounds = cc_label_propagation(plan->matrix, label);
+		break;
+	case 1:
+		rounds = cc_union_find(plan->matrix, label);
+		break;
+	case 5:
+		if (plan->mirrored)
+			rounds = cc_frontier_propagation(plan->matrix, label, &plan->frontier);
+		else
+			rounds = cc_label_propagation(plan->matrix, label);
+		fallback = !plan->mirrored;
+		break;
+	default:
+		return -1;
+	}
+	size_t count = finalize(plan, label);
+	plan->summary.rounds = rounds;
+	plan->summary.fallback = fallback;
 	return (int)count;
 }
 
+/**
+ * @copydoc cc_plan_execute()
+ */
+int
+cc_plan_execute(CCPlan *plan)
+{
+	if (!plan)
+		return -1;
+
+	return plan_run(plan, plan->label);
+}
+
+/**
+ * @copydoc cc_plan_labels()
+ */
+int
+cc_plan_labels(CCPlan *plan, csc_idx_t *labels)
+{
+	if (!plan || !labels)
+		return -1;
+
+	return plan_run(plan, labels);
+}
+
+/**
+ * @copydoc cc_plan_dense_labels()
+ */
+int
+cc_plan_dense_labels(CCPlan *plan, csc_idx_t *labels)
+{
+	if (!plan || !labels)
+		return -1;
+
+	int count = plan_run(plan, labels);
+	if (count < 0)
+		return count;
+
+	/* The sizes are summarized: reuse the array for the roots' ids */
+	const size_t n = plan->matrix->nrows;
+	csc_idx_t next = 0;
+	for (size_t i = 0; i < n; i++)
+		if (labels[i] == i)
+			plan->size[i] = next++;
+	for (size_t i = 0; i < n; i++)
+		labels[i] = plan->size[labels[i]];
+
+	return count;
+}
+
+/**
+ * @copydoc cc_plan_summary()
+ */
+const CCSummary *
+cc_plan_summary(const CCPlan *plan)
+{
+	return &plan->summary;
+}
+
+/**
+ * @copydoc cc_plan_destroy()
+ */
+void
+cc_plan_destroy(CCPlan *plan)
+{
+	if (!plan)
+		return;
+
+	mem_free(plan->label, &plan->matrix->mem);
+	mem_free(plan->size, &plan->matrix->mem);
+	for (int k = 0; k < 2; k++) {
+		mem_free(plan->frontier.bits[k], &plan->matrix->mem);
+		mem_free(plan->frontier.queue[k], &plan->matrix->mem);
+	}
+	free(plan);
+}
+
 /* ========================================================================== */
 /*                              PUBLIC INTERFACE                              */
 /* ========================================================================== */
@@ -224,30 +637,47 @@ cc_label_propagation(const CSCBinaryMatrix *matrix)
  * @brief Computes connected components using sequential algorithms.
  *
  * This is the main entry point for sequential connected components
- * computation. It dispatches to one of two algorithm implementations
- * based on the variant parameter.
+ * computation. It runs a one-shot plan, which dispatches to one of three
+ * algorithm implementations based on the variant parameter.
  *
  * Supported variants:
  *   0: Label propagation
  *   1: Union-find
+ *   5: Frontier label propagation (relaxes only the active columns)
  *
  * @param matrix Sparse binary matrix in CSC format
  * @param n_threads Unused (for API compatibility with parallel versions)
- * @param algorithm_variant Algorithm selection (0 or 1)
+ * @param algorithm_variant Algorithm selection (0, 1 or 5)
  * @return Number of connected components, or -1 on error
  */
 int
 cc_sequential(const CSCBinaryMatrix *matrix,
-              const unsigned int n_threads __attribute__((unused)),
+              const unsigned int n_threads,
               const unsigned int algorithm_variant)
 {
-	switch (algorithm_variant) {
-	case 0:
-		return cc_label_propagation(matrix);
-	case 1:
-		return cc_union_find(matrix);
-	default:
-		break;
-	}
-	return -1;
+	CCPlan *plan = cc_plan_create(matrix, n_threads, algorithm_variant);
+	if (!plan)
+		return -1;
+
+	int count = cc_plan_execute(plan);
+	cc_plan_destroy(plan);
+	return count;
+}
+
+/**
+ * @copydoc cc_labels()
+ */
+int
+cc_labels(const CSCBinaryMatrix *matrix,
+          unsigned int n_threads,
+          unsigned int algorithm_variant,
+          csc_idx_t *labels)
+{
+	CCPlan *plan = cc_plan_create(matrix, n_threads, algorithm_variant);
+	if (!plan)
+		return -1;
+
+	int count = cc_plan_labels(plan, labels);
+	cc_plan_destroy(plan);
+	return count;
 }
@@ -10,23 +10,74 @@
  * - OpenMP
  * - Pthreads
  * - OpenCilk
+ *
+ * Each executable links exactly one implementation, which also provides the
+ * prepared plan API (cc_plan_create(), cc_plan_execute(), cc_plan_destroy()):
+ * a plan owns the label and component-size arrays and, for Pthreads, the
+ * worker threads, so repeated runs on the same matrix only pay for the
+ * kernel. The per-implementation functions are one-shot plans.
+ *
+ * cc_plan_labels() and cc_labels() also return the component of every
+ * vertex: the kernels run directly on the caller's array, so labels cost
+ * nothing over counting.
+ *
+ * Every run ends with the same parallel finalization: the roots are
+ * counted per thread block and numbered 0..k-1 by a prefix sum over the
+ * blocks, and the size of every component is accumulated. The count, the
+ * largest component and the size histogram are kept in the plan
+ * (cc_plan_summary()).
  */
 
 #ifndef CONNECTED_COMPONENTS_H
 #define CONNECTED_COMPONENTS_H
 
+#include <stddef.h>
+
 #include "matrix.h"
 
+/** Buckets of the component size histogram, enough for any size_t */
+#define CC_SIZE_BUCKETS 64
+
+/**
+ * @struct CCSummary
+ * @brief Component statistics and round count of the last run of a plan.
+ */
+typedef struct {
+	size_t components;                    /**< Number of components (k) */
+	size_t largest;                       /**< Vertices in the largest component */
+	size_t size_histogram[CC_SIZE_BUCKETS]; /**< [i]: components of 2^i to 2^(i+1) - 1 vertices */
+	unsigned int rounds;                  /**< Passes of the kernel over the edges: label
+	                                           propagation sweeps, FastSV rounds, 1 for union-find */
+	unsigned int shortcut_rounds;         /**< Pointer-jumping passes over the labels between
+	                                           sweeps (variant 6), 0 for the other kernels */
+	unsigned int fallback;                /**< 1 if the matrix is not mirrored, so the variant
+	                                           skipped its mirrored-edge path: Afforest read the
+	                                           giant component's columns, Multistep ran top-down
+	                                           only, frontier propagation ran plain label
+	                                           propagation (variants 2, 4 and 5) */
+} CCSummary;
+
+/**
+ * @brief Histogram bucket of a component of @p size vertices (size >= 1).
+ */
+static inline unsigned int
+cc_size_bucket(size_t size)
+{
+	return (unsigned int)(sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(size));
+}
+
 /**
  * @brief Computes connected components using sequential algorithms.
  *
  * Supported variants:
  *   0: Label propagation (simple, slower)
  *   1: Union-find (more complex, faster)
+ *   5: Frontier label propagation: relaxes only the columns of nodes
+ *      whose label changed in the previous round
  *
  * @param matrix Sparse binary matrix in CSC format
  * @param n_threads Unused (for API compatibility with parallel version)
- * @param algorithm_variant Algorithm selection (0 or 1)
+ * @param algorithm_variant Algorithm selection (0, 1 or 5)
  * @return Number of connected components, or -1 on error
  */
 int cc_sequential(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
@@ -37,37 +88,157 @@ int cc_sequential(const CSCBinaryMatrix *matrix, const unsigned int n_threads, c
  * Supported variants:
  *   0: Label propagation (simple, slower)
  *   1: Union-find with Rem's algorithm (more complex, faster)
+ *   2: Afforest: union-find on sampled neighbours first, then only the
+ *      edges leaving the giant component
+ *   3: FastSV: hooking and shortcutting in O(log n) rounds
+ *   4: Multistep: direction-optimizing BFS from a high-degree node, then
+ *      union-find over the nodes it did not reach
+ *   5: Frontier label propagation: relaxes only the columns of nodes
+ *      whose label changed in the previous round
+ *   6: Pointer-jumping label propagation: shortcut rounds
+ *      (label[v] = label[label[v]]) between sweeps
  *
- * Both algorithms use OpenMP for parallelization and are designed to
+ * All algorithms use OpenMP for parallelization and are designed to
  * scale efficiently across multiple cores.
  *
  * @param matrix Sparse binary matrix in CSC format
  * @param n_threads Number of OpenMP threads to use
- * @param algorithm_variant Algorithm selection (0 or 1)
+ * @param algorithm_variant Algorithm selection (0 to 6)
  * @return Number of connected components, or -1 on error
  */
 int cc_openmp(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
 
 /**
- * @brief Count connected components using parallel label propagation with opencilk
+ * @brief Computes connected components using OpenCilk.
+ *
+ * Supported variants:
+ *   0: Label propagation
+ *   1: Union-find with Rem's algorithm
+ *   2: Afforest: union-find on sampled neighbours first, then only the
+ *      edges leaving the giant component
+ *   3: FastSV: hooking and shortcutting in O(log n) rounds
+ *   5: Frontier label propagation: relaxes only the columns of nodes
+ *      whose label changed in the previous round
+ *   6: Pointer-jumping label propagation: shortcut rounds
+ *      (label[v] = label[label[v]]) between sweeps
+ *
  * @param matrix Input sparse binary matrix in CSC format
  * @param n_threads Number of threads to use
- * @param algorithm_variant Algorithm variant to use:
- *                          - 0: TODO: add variants.
- *                          - 1: TODO: add variants.
+ * @param algorithm_variant Algorithm selection (0 to 3, 5 or 6)
  * @return Number of connected components, or -1 on error
  */
 int cc_cilk(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
 
 /**
- * @brief Count connected components using parallel label propagation with pthreads
+ * @brief Computes connected components using Pthreads.
+ *
+ * Supported variants:
+ *   0: Label propagation
+ *   1: Union-find with Rem's algorithm
+ *   3: FastSV: hooking and shortcutting in O(log n) rounds
+ *   4: Multistep: direction-optimizing BFS from a high-degree node, then
+ *      union-find over the nodes it did not reach
+ *   5: Frontier label propagation: relaxes only the columns of nodes
+ *      whose label changed in the previous round
+ *   6: Pointer-jumping label propagation: shortcut rounds
+ *      (label[v] = label[label[v]]) between sweeps
+ *
  * @param matrix Input sparse binary matrix in CSC format
  * @param n_threads Number of threads to use
- * @param algorithm_variant Algorithm variant to use:
- *                          - 0: TODO: add variants.
- *                          - 1: TODO: add variants.
+ * @param algorithm_variant Algorithm selection (0, 1 or 3 to 6)
  * @return Number of connected components, or -1 on error
  */
 int cc_pthreads(const CSCBinaryMatrix *matrix, const unsigned int n_threads, const unsigned int algorithm_variant);
 
+/**
+ * @brief Preallocated buffers and workers for repeated runs on one matrix.
+ *
+ * Opaque; defined by the linked implementation.
+ */
+typedef struct CCPlan CCPlan;
+
+/**
+ * @brief Prepares repeated connected components runs on a matrix.
+ *
+ * Allocates the label array under the matrix's memory policy (see mem.h)
+ * and writes it once with the same thread split the kernels use, so its
+ * pages are faulted in (and first-touched) before the first run. The
+ * Pthreads implementation also starts its worker threads here.
+ *
+ * The plan reads @p matrix on every execution, so the matrix may be
+ * renumbered in place between runs (see reorder.h), but must keep its
+ * dimensions and outlive the plan.
+ *
+ * @param matrix Sparse binary matrix in CSC format
+ * @param n_threads Number of threads (ignored by the sequential and
+ *        OpenCilk implementations)
+ * @param algorithm_variant Algorithm selection: 0 label propagation,
+ *        1 union-find, 2 Afforest (OpenMP and OpenCilk only), 3 FastSV
+ *        (parallel implementations only), 4 Multistep (OpenMP and
+ *        Pthreads only), 5 frontier label propagation, 6 pointer-jumping
+ *        label propagation (parallel implementations only)
+ * @return Plan, or NULL on failure or a variant the implementation lacks
+ */
+CCPlan *cc_plan_create(const CSCBinaryMatrix *matrix, unsigned int n_threads, unsigned int algorithm_variant);
+
+/**
+ * @brief Counts the connected components of the plan's matrix.
+ *
+ * @param plan Plan from cc_plan_create()
+ * @return Number of connected components, or -1 on error
+ */
+int cc_plan_execute(CCPlan *plan);
+
+/**
+ * @brief Counts the components of the plan's matrix and labels every vertex.
+ *
+ * The kernel runs on @p labels in place of the plan's label array. On
+ * return labels[v] is the smallest vertex of v's component, so two
+ * vertices share a label exactly when they are connected. Vertices are
+ * numbered as in the matrix; for a reordered matrix, csc_unpermute()
+ * gives the labels of the input vertices.
+ *
+ * @param plan Plan from cc_plan_create()
+ * @param labels Output: matrix->nrows labels
+ * @return Number of connected components, or -1 on error
+ */
+int cc_plan_labels(CCPlan *plan, csc_idx_t *labels);
+
+/**
+ * @brief Like cc_plan_labels(), but labels the components densely.
+ *
+ * On return labels[v] is in [0, k), components numbered in the order of
+ * their smallest vertex. The numbering reuses the ids of the
+ * finalization, at the cost of one more parallel pass.
+ *
+ * @param plan Plan from cc_plan_create()
+ * @param labels Output: matrix->nrows labels
+ * @return Number of connected components k, or -1 on error
+ */
+int cc_plan_dense_labels(CCPlan *plan, csc_idx_t *labels);
+
+/**
+ * @brief Returns the component statistics of the plan's last run (all
+ *        zero before the first one).
+ */
+const CCSummary *cc_plan_summary(const CCPlan *plan);
+
+/**
+ * @brief Releases a plan, joining its worker threads. Safe to call with NULL.
+ */
+void cc_plan_destroy(CCPlan *plan);
+
+/**
+ * @brief One-shot cc_plan_labels(): labels every vertex of @p matrix with
+ *        the smallest vertex of its component.
+ *
+ * @param matrix Sparse binary matrix in CSC format
+ * @param n_threads Number of threads (see cc_plan_create())
+ * @param algorithm_variant Algorithm selection (see cc_plan_create())
+ * @param labels Output: matrix->nrows labels
+ * @return Number of connected components, or -1 on error
+ */
+int cc_labels(const CSCBinaryMatrix *matrix, unsigned int n_threads,
+              unsigned int algorithm_variant, csc_idx_t *labels);
+
 #endif
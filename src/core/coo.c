@@ -0,0 +1,192 @@
+/**
+ * @file coo.c
+ * @brief Parallel COO → CSC construction shared by the loaders.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "coo.h"
+#include "parallel.h"
+#include "error.h"
+
+/** Minimum number of entries per thread worth a thread start-up */
+#define COO_MIN_CHUNK (1u << 16)
+
+/**
+ * @struct coo_job_t
+ * @brief State shared by the conversion threads.
+ *
+ * Thread t owns the entry block [par_block_begin(count, T, t), ...) in
+ * passes 1 and 4 and the column block [par_block_begin(ncols, T, t), ...)
+ * in passes 2 and 3.
+ */
+typedef struct {
+	const csc_idx_t *coo_i; /* Input row indices */
+	const csc_idx_t *coo_j; /* Input column indices */
+	size_t count;           /* Number of entries */
+	size_t ncols;           /* Number of columns */
+	unsigned int n_threads; /* Number of threads */
+	csc_ptr_t *hist;        /* n_threads × ncols: counts, then write cursors */
+	csc_ptr_t *block_sum;   /* Per column block: entries, then first slot */
+	csc_ptr_t *col_ptr;     /* Output column pointers */
+	csc_idx_t *row_idx;     /* Output row indices */
+} coo_job_t;
+
+/**
+ * @brief Pass 1: column histogram of one entry block.
+ */
+static void
+hist_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	coo_job_t *job = arg;
+	csc_ptr_t *hist = job->hist + (size_t)tid * job->ncols;
+	size_t begin = par_block_begin(job->count, n_threads, tid);
+	size_t end   = par_block_begin(job->count, n_threads, tid + 1);
+
+	memset(hist, 0, job->ncols * sizeof(csc_ptr_t));
+
+	for (size_t k = begin; k < end; k++)
+		hist[job->coo_j[k]]++;
+}
+
+/**
+ * @brief Pass 2: turns the histograms of one column block into per-thread
+ *        offsets within each column and stores the column degrees.
+ */
+static void
+reduce_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	coo_job_t *job = arg;
+	size_t begin = par_block_begin(job->ncols, n_threads, tid);
+	size_t end   = par_block_begin(job->ncols, n_threads, tid + 1);
+	csc_ptr_t total = 0;
+
+	for (size_t j = begin; j < end; j++) {
+		csc_ptr_t deg = 0;
+
+		for (unsigned int t = 0; t < n_threads; t++) {
+			csc_ptr_t *h = &job->hist[(size_t)t * job->ncols + j];
+			csc_ptr_t c = *h;
+			*h = deg;
+			deg += c;
+		}
+
+		job->col_ptr[j] = deg;
+		total += deg;
+	}
+
+	job->block_sum[tid] = total;
+}
+
+/**
+ * @brief Pass 3: exclusive scan of the degrees of one column block,
+ *        starting from the block's first slot.
+ */
+static void
+scan_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	coo_job_t *job = arg;
+	size_t begin = par_block_begin(job->ncols, n_threads, tid);
+	size_t end   = par_block_begin(job->ncols, n_threads, tid + 1);
+	csc_ptr_t sum = job->block_sum[tid];
+
+	for (size_t j = begin; j < end; j++) {
+		csc_ptr_t deg = job->col_ptr[j];
+		job->col_ptr[j] = sum;
+		sum += deg;
+	}
+}
+
+/**
+ * @brief Pass 4: scatters one entry block into the slots reserved for it.
+ *
+ * Thread t's entries of column j go to col_ptr[j] + hist[t][j] onwards,
+ * a range no other thread writes to, so no synchronization is needed.
+ */
+static void
+scatter_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	coo_job_t *job = arg;
+	csc_ptr_t *cursor = job->hist + (size_t)tid * job->ncols;
+	size_t begin = par_block_begin(job->count, n_threads, tid);
+	size_t end   = par_block_begin(job->count, n_threads, tid + 1);
+
+	for (size_t k = begin; k < end; k++) {
+		csc_idx_t j = job->coo_j[k];
+		job->row_idx[job->col_ptr[j] + cursor[j]++] = job->coo_i[k];
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc coo_to_csc()
+ */
+int
+coo_to_csc(const csc_idx_t *coo_i, const csc_idx_t *coo_j, size_t count,
+           size_t ncols, unsigned int n_threads,
+           csc_ptr_t **col_ptr, csc_idx_t **row_idx)
+{
+	if (count > CSC_PTR_MAX) {
+		print_error(__func__, "too many entries for the column pointer width of this build", 0);
+		return -1;
+	}
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+	/* Keep the histograms no larger than the output and chunks worthwhile */
+	if (ncols && n_threads > count / ncols)
+		n_threads = (unsigned int)(count / ncols);
+	if (n_threads > count / COO_MIN_CHUNK)
+		n_threads = (unsigned int)(count / COO_MIN_CHUNK);
+	if (n_threads == 0)
+		n_threads = 1;
+
+	coo_job_t job = {
+		.coo_i = coo_i,
+		.coo_j = coo_j,
+		.count = count,
+		.ncols = ncols,
+		.n_threads = n_threads,
+	};
+
+	job.hist      = malloc((size_t)n_threads * ncols * sizeof(csc_ptr_t) + 1);
+	job.block_sum = malloc(n_threads * sizeof(csc_ptr_t));
+	job.col_ptr   = malloc((ncols + 1) * sizeof(csc_ptr_t));
+	job.row_idx   = malloc(count * sizeof(csc_idx_t) + 1);
+
+	if (!job.hist || !job.block_sum || !job.col_ptr || !job.row_idx) {
+		print_error(__func__, "malloc failed", errno);
+		free(job.hist);
+		free(job.block_sum);
+		free(job.col_ptr);
+		free(job.row_idx);
+		return -1;
+	}
+
+	par_run(n_threads, hist_worker, &job);
+	par_run(n_threads, reduce_worker, &job);
+
+	/* Exclusive scan of the block totals: first slot of every column block */
+	csc_ptr_t sum = 0;
+	for (unsigned int t = 0; t < n_threads; t++) {
+		csc_ptr_t total = job.block_sum[t];
+		job.block_sum[t] = sum;
+		sum += total;
+	}
+	job.col_ptr[ncols] = sum;
+
+	par_run(n_threads, scan_worker, &job);
+	par_run(n_threads, scatter_worker, &job);
+
+	free(job.hist);
+	free(job.block_sum);
+
+	*col_ptr = job.col_ptr;
+	*row_idx = job.row_idx;
+	return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file coo.h
+ * @brief Parallel COO → CSC construction shared by the loaders.
+ *
+ * The conversion is a counting sort on the column index, split into four
+ * parallel passes: per-thread column histograms, a column-wise reduction
+ * of the histograms into per-thread write offsets, a parallel prefix sum
+ * over the column degrees, and a conflict-free scatter where every thread
+ * writes only to the slots reserved for it.
+ */
+
+#ifndef COO_H
+#define COO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "matrix.h"
+
+/**
+ * @brief Builds CSC arrays from 0-based COO entries.
+ *
+ * The result is identical for every thread count: within a column, rows
+ * keep the order in which they appear in the COO arrays.
+ *
+ * Each thread keeps a histogram of @p ncols counters, so the number of
+ * threads is reduced when those histograms would outgrow the output.
+ *
+ * @param coo_i Row indices
+ * @param coo_j Column indices, all < @p ncols
+ * @param count Number of entries
+ * @param ncols Number of columns
+ * @param n_threads Number of threads (0 uses every online CPU)
+ * @param col_ptr Output: newly allocated column pointers (ncols + 1)
+ * @param row_idx Output: newly allocated row indices (count)
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int coo_to_csc(const csc_idx_t *coo_i, const csc_idx_t *coo_j, size_t count,
+               size_t ncols, unsigned int n_threads,
+               csc_ptr_t **col_ptr, csc_idx_t **row_idx);
+
+#endif /* COO_H */
@@ -0,0 +1,268 @@
+/**
+ * @file cscbin.c
+ * @brief Native binary CSC container (.csc) with zero-copy loading.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cscbin.h"
+#include "error.h"
+#include "parallel.h"
+#include "timer.h"
+
+_Static_assert(sizeof(CSCBinHeader) == 64, "CSCBinHeader must be 64 bytes");
+
+/**
+ * @brief Rounds @p x up to the next multiple of CSCBIN_ALIGN.
+ */
+static inline uint64_t
+align_up(uint64_t x)
+{
+	return (x + CSCBIN_ALIGN - 1) & ~(uint64_t)(CSCBIN_ALIGN - 1);
+}
+
+/**
+ * @brief Writes zero bytes until the file position is aligned.
+ */
+static int
+pad_to(FILE *f, uint64_t pos, uint64_t target)
+{
+	static const char zeros[CSCBIN_ALIGN];
+	return (target == pos || fwrite(zeros, 1, target - pos, f) == target - pos) ? 0 : -1;
+}
+
+/**
+ * @struct check_job_t
+ * @brief Parallel validation of the mapped col_ptr and row_idx arrays.
+ */
+typedef struct {
+	const csc_ptr_t *col_ptr;
+	const csc_idx_t *row_idx;
+	size_t ncols;
+	size_t nnz;
+	size_t nrows;
+	int bad;
+} check_job_t;
+
+/**
+ * @brief Checks one block of columns for monotonic pointers and one block
+ *        of entries for in-range row indices.
+ */
+static void
+check_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	check_job_t *job = arg;
+	size_t begin = par_block_begin(job->ncols, n_threads, tid);
+	size_t end   = par_block_begin(job->ncols, n_threads, tid + 1);
+
+	for (size_t j = begin; j < end; j++) {
+		if (job->col_ptr[j + 1] < job->col_ptr[j]) {
+			__atomic_store_n(&job->bad, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	}
+
+	begin = par_block_begin(job->nnz, n_threads, tid);
+	end   = par_block_begin(job->nnz, n_threads, tid + 1);
+
+	for (size_t k = begin; k < end; k++) {
+		if (job->row_idx[k] >= job->nrows) {
+			__atomic_store_n(&job->bad, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	}
+}
+
+/**
+ * @copydoc cscbin_read_header()
+ */
+int
+cscbin_read_header(const void *buf, size_t size, CSCBinHeader *h)
+{
+	memcpy(h, buf, sizeof(*h));
+
+	/* Version 1: two uint32 widths where version 2 has widths + flags */
+	if (h->version == 1) {
+		uint32_t w[2];
+		memcpy(w, (const char *)buf + offsetof(CSCBinHeader, ptr_width), sizeof(w));
+		h->ptr_width = (uint16_t)w[0];
+		h->idx_width = (uint16_t)w[1];
+		h->flags     = 0;
+		h->version   = CSCBIN_VERSION;
+	}
+
+	const char *err = NULL;
+	if (memcmp(h->magic, CSCBIN_MAGIC, sizeof(h->magic)) != 0)
+		err = "not a .csc file (bad magic)";
+	else if (h->byte_order != CSCBIN_BYTEORDER)
+		err = "byte order of .csc file does not match this machine";
+	else if (h->version != CSCBIN_VERSION)
+		err = "unsupported .csc format version";
+	else if (h->ptr_width != sizeof(csc_ptr_t) || h->idx_width != sizeof(csc_idx_t))
+		err = "index widths of .csc file do not match this build (see make INDEX=)";
+	else if (h->nrows > CSC_IDX_MAX || h->ncols > CSC_IDX_MAX || h->nnz > CSC_PTR_MAX)
+		err = "matrix exceeds the index width of this build (see make INDEX=)";
+	else if (h->col_ptr_offset % CSCBIN_ALIGN || h->row_idx_offset % CSCBIN_ALIGN ||
+	         h->col_ptr_offset > size || h->row_idx_offset > size ||
+	         h->ncols + 1 > (size - h->col_ptr_offset) / h->ptr_width ||
+	         h->nnz > (size - h->row_idx_offset) / h->idx_width)
+		err = "truncated or corrupt .csc file";
+
+	if (err) {
+		print_error(__func__, err, 0);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @copydoc cscbin_load()
+ */
+CSCBinaryMatrix *
+cscbin_load(const char *filename)
+{
+	double t0 = now_sec();
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		print_error(__func__, "failed to open .csc file", errno);
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		print_error(__func__, "fstat() failed", errno);
+		close(fd);
+		return NULL;
+	}
+
+	size_t size = (size_t)st.st_size;
+	if (size < sizeof(CSCBinHeader)) {
+		print_error(__func__, "file too small for a .csc header", 0);
+		close(fd);
+		return NULL;
+	}
+
+	char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		print_error(__func__, "mmap() failed", errno);
+		return NULL;
+	}
+
+	/* Pages are faulted in by the validation pass below, not here */
+	double t1 = now_sec();
+	double io_time_s = t1 - t0;
+
+	CSCBinHeader h;
+	if (cscbin_read_header(map, size, &h) != 0) {
+		munmap(map, size);
+		return NULL;
+	}
+
+	const csc_ptr_t *col_ptr = (const csc_ptr_t *)(map + h.col_ptr_offset);
+	if (col_ptr[0] != 0 || col_ptr[h.ncols] != h.nnz) {
+		print_error(__func__, "corrupt .csc file (col_ptr does not span [0, nnz])", 0);
+		munmap(map, size);
+		return NULL;
+	}
+
+	check_job_t check = {
+		.col_ptr = col_ptr,
+		.row_idx = (const csc_idx_t *)(map + h.row_idx_offset),
+		.ncols   = h.ncols,
+		.nnz     = h.nnz,
+		.nrows   = h.nrows,
+	};
+	par_run(par_num_cpus(), check_worker, &check);
+	if (check.bad) {
+		print_error(__func__, "corrupt .csc file (unsorted col_ptr or row index out of range)", 0);
+		munmap(map, size);
+		return NULL;
+	}
+
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		munmap(map, size);
+		return NULL;
+	}
+
+	m->nrows    = h.nrows;
+	m->ncols    = h.ncols;
+	m->nnz      = h.nnz;
+	m->col_ptr  = (csc_ptr_t *)(map + h.col_ptr_offset);
+	m->row_idx  = (csc_idx_t *)(map + h.row_idx_offset);
+	m->map_base = map;
+	m->map_size = size;
+	m->packed   = NULL;
+	m->perm     = NULL;
+	m->half     = (h.flags & CSCBIN_FLAG_HALF) != 0;
+	m->normalized = (h.flags & CSCBIN_FLAG_NORMALIZED) != 0;
+	m->mirrored = (h.flags & CSCBIN_FLAG_MIRRORED) != 0;
+	memset(&m->mem, 0, sizeof(m->mem));
+
+	memset(&m->load, 0, sizeof(m->load));
+	m->load.input_bytes  = size;
+	m->load.io_time_s    = io_time_s;
+	m->load.parse_time_s = now_sec() - t1;
+
+	return m;
+}
+
+/**
+ * @copydoc cscbin_save()
+ */
+int
+cscbin_save(const CSCBinaryMatrix *m, const char *filename)
+{
+	CSCBinHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, CSCBIN_MAGIC, sizeof(h.magic));
+	h.version        = CSCBIN_VERSION;
+	h.byte_order     = CSCBIN_BYTEORDER;
+	h.ptr_width      = sizeof(*m->col_ptr);
+	h.idx_width      = sizeof(*m->row_idx);
+	h.flags          = (m->half ? CSCBIN_FLAG_HALF : 0) |
+	                   (m->normalized ? CSCBIN_FLAG_NORMALIZED : 0) |
+	                   (m->mirrored ? CSCBIN_FLAG_MIRRORED : 0);
+	h.nrows          = m->nrows;
+	h.ncols          = m->ncols;
+	h.nnz            = m->nnz;
+	h.col_ptr_offset = align_up(sizeof(h));
+	h.row_idx_offset = align_up(h.col_ptr_offset + (h.ncols + 1) * h.ptr_width);
+
+	FILE *f = fopen(filename, "wb");
+	if (!f) {
+		print_error(__func__, "failed to create .csc file", errno);
+		return -1;
+	}
+
+	int ok = fwrite(&h, sizeof(h), 1, f) == 1
+	      && pad_to(f, sizeof(h), h.col_ptr_offset) == 0
+	      && fwrite(m->col_ptr, h.ptr_width, h.ncols + 1, f) == h.ncols + 1
+	      && pad_to(f, h.col_ptr_offset + (h.ncols + 1) * h.ptr_width, h.row_idx_offset) == 0
+	      && fwrite(m->row_idx, h.idx_width, h.nnz, f) == h.nnz;
+
+	if (fclose(f) != 0)
+		ok = 0;
+
+	if (!ok) {
+		print_error(__func__, "failed to write .csc file", errno);
+		remove(filename);
+		return -1;
+	}
+
+	return 0;
+}
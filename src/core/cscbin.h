@@ -0,0 +1,90 @@
+/**
+ * @file cscbin.h
+ * @brief Native binary CSC container (.csc) with zero-copy loading.
+ *
+ * On-disk layout (native byte order):
+ *
+ * | Offset          | Contents                                          |
+ * |-----------------|---------------------------------------------------|
+ * | 0               | CSCBinHeader (64 bytes)                           |
+ * | col_ptr_offset  | col_ptr, ncols + 1 entries of ptr_width bytes     |
+ * | row_idx_offset  | row_idx, nnz entries of idx_width bytes           |
+ *
+ * Both array offsets are multiples of CSCBIN_ALIGN, so a mapping of the
+ * file can be used as a CSCBinaryMatrix directly.
+ */
+
+#ifndef CSCBIN_H
+#define CSCBIN_H
+
+#include <stdint.h>
+
+#include "matrix.h"
+
+#define CSCBIN_MAGIC     "CSCBIN\0\0"  /**< File signature (8 bytes) */
+#define CSCBIN_VERSION   2u            /**< Current format version */
+#define CSCBIN_BYTEORDER 0x01020304u   /**< Byte-order mark */
+#define CSCBIN_ALIGN     64u           /**< Alignment of the array sections */
+
+#define CSCBIN_FLAG_HALF 0x1u          /**< One triangle of a symmetric matrix */
+#define CSCBIN_FLAG_NORMALIZED 0x2u    /**< Sorted, unique, loop-free rows (see normalize.h) */
+#define CSCBIN_FLAG_MIRRORED 0x4u      /**< Every off-diagonal entry stored in both columns */
+
+/**
+ * @struct CSCBinHeader
+ * @brief Fixed-size header at the start of every .csc file.
+ */
+typedef struct {
+	char magic[8];            /**< CSCBIN_MAGIC */
+	uint32_t version;         /**< CSCBIN_VERSION */
+	uint32_t byte_order;      /**< CSCBIN_BYTEORDER as written by the producer */
+	uint16_t ptr_width;       /**< Bytes per col_ptr entry */
+	uint16_t idx_width;       /**< Bytes per row_idx entry */
+	uint32_t flags;           /**< CSCBIN_FLAG_* (version 2; version 1 stored
+	                               both widths as uint32 and had no flags) */
+	uint64_t nrows;           /**< Number of rows */
+	uint64_t ncols;           /**< Number of columns */
+	uint64_t nnz;             /**< Number of stored entries */
+	uint64_t col_ptr_offset;  /**< File offset of col_ptr */
+	uint64_t row_idx_offset;  /**< File offset of row_idx */
+} CSCBinHeader;
+
+/**
+ * @brief Decodes and validates the header at the start of a .csc file.
+ *
+ * Version 1 headers are converted to the current layout. The array
+ * sections must lie within the file and match this build's index widths,
+ * and the dimensions must fit csc_idx_t / csc_ptr_t; the array contents
+ * are not checked.
+ *
+ * @param buf First sizeof(CSCBinHeader) bytes of the file
+ * @param size Size of the whole file in bytes
+ * @param h Output: decoded header
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int cscbin_read_header(const void *buf, size_t size, CSCBinHeader *h);
+
+/**
+ * @brief Maps a .csc file and returns a matrix backed by the mapping.
+ *
+ * The mapping is private and writable, so in-place preprocessing works
+ * (pages are copied on first write) without ever touching the file.
+ * Before returning, col_ptr is checked to be monotonic from 0 to nnz and
+ * every row index to be below nrows (in parallel), so the kernels can
+ * index labels without bounds checks.
+ *
+ * @param filename Path to the .csc file
+ * @return Newly allocated matrix, or NULL on error
+ */
+CSCBinaryMatrix *cscbin_load(const char *filename);
+
+/**
+ * @brief Writes a matrix in the .csc format.
+ *
+ * @param m Matrix to write
+ * @param filename Output path
+ * @return 0 on success, -1 on error
+ */
+int cscbin_save(const CSCBinaryMatrix *m, const char *filename);
+
+#endif /* CSCBIN_H */
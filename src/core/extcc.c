@@ -0,0 +1,577 @@
+/**
+ * @file extcc.c
+ * @brief Semi-external connected components for .csc files larger than memory.
+ *
+ * A block is a range of row indices [e0, e0 + n) together with the column
+ * pointers of every column it touches. Blocks are cut by size, not at
+ * column boundaries, so a column larger than a block is spread over
+ * several of them; every column range is clipped to the block before use.
+ *
+ * The reader thread fills block i into buffer i % 2 and the kernel threads
+ * process it while block i + 1 is read into the other buffer. The two
+ * sides only exchange the produced and consumed counters.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "extcc.h"
+#include "cscbin.h"
+#include "parallel.h"
+#include "error.h"
+#include "timer.h"
+
+/** Smallest block buffer a budget must leave room for (two are needed) */
+#define EXTCC_MIN_BUFFER (64u << 10)
+
+/**
+ * @struct ext_block_t
+ * @brief One block of the edge file.
+ */
+typedef struct {
+	size_t c0;          /* First column */
+	size_t ncols;       /* Columns touched (the first and last may be partial) */
+	size_t e0;          /* Edge index of rows[0] */
+	size_t n;           /* Row indices in the block */
+	csc_ptr_t *ptr;     /* col_ptr[c0 .. c0 + ncols] as stored in the file */
+	csc_idx_t *rows;    /* row_idx[e0 .. e0 + n) */
+} ext_block_t;
+
+/**
+ * @struct ext_job_t
+ * @brief State shared by the reader thread and the kernel threads.
+ */
+typedef struct {
+	int fd;                  /* Open .csc file */
+	CSCBinHeader h;          /* Its header */
+	size_t cap_cols;         /* Column pointers per buffer (at least 2) */
+	size_t cap_edges;        /* Row indices per buffer */
+	ext_block_t block[2];    /* Block i lives in block[i % 2] */
+
+	pthread_mutex_t lock;    /* Protects the fields below */
+	pthread_cond_t cond;     /* Signalled on every change of them */
+	size_t produced;         /* Blocks filled by the reader */
+	size_t consumed;         /* Blocks released by the kernels */
+	int done;                /* Reader finished (or failed) */
+	int read_errno;          /* Reader: errno of a failed read, or -1 for bad data */
+
+	size_t bytes_read;       /* Reader: bytes read over all passes */
+	csc_idx_t *label;        /* Parents (union-find) or labels (propagation) */
+	size_t n;                /* Number of vertices */
+	unsigned int variant;    /* 0: label propagation, 1: union-find */
+	const ext_block_t *cur;  /* Block being processed */
+	int changed;             /* Label propagation: a label changed this pass */
+	int bad_row;             /* A row index was out of range */
+	size_t *roots;           /* Per thread: roots found by count_worker() */
+} ext_job_t;
+
+/* ------------------------------------------------------------------------- */
+/*                                  Reader                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Reads exactly @p len bytes at @p off.
+ *
+ * @return 0 on success, -1 on error or end of file (errno set)
+ */
+static int
+read_full(int fd, void *buf, size_t len, off_t off)
+{
+	char *p = buf;
+
+	while (len > 0) {
+		ssize_t r = pread(fd, p, len, off);
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r <= 0) {
+			if (r == 0)
+				errno = EIO;
+			return -1;
+		}
+		p += r;
+		off += r;
+		len -= (size_t)r;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Reads the block starting at column *@p c, edge *@p e, and
+ *        advances both past it.
+ *
+ * @return 0 on success, -1 on a read error (errno set) or a corrupt
+ *         col_ptr (errno 0)
+ */
+static int
+fill_block(ext_job_t *job, ext_block_t *b, size_t *c, size_t *e)
+{
+	const CSCBinHeader *h = &job->h;
+	size_t k_max = h->ncols - *c;
+
+	if (k_max > job->cap_cols - 1)
+		k_max = job->cap_cols - 1;
+
+	if (read_full(job->fd, b->ptr, (k_max + 1) * sizeof(csc_ptr_t),
+	              (off_t)(h->col_ptr_offset + *c * sizeof(csc_ptr_t))) != 0)
+		return -1;
+
+	/* Everything below relies on this; a bad file must not move us backwards */
+	if (b->ptr[0] > *e || b->ptr[k_max] > h->nnz) {
+		errno = 0;
+		return -1;
+	}
+	for (size_t k = 0; k < k_max; k++) {
+		if (b->ptr[k] > b->ptr[k + 1]) {
+			errno = 0;
+			return -1;
+		}
+	}
+
+	size_t e_lim = *e + job->cap_edges;
+	if (e_lim > h->nnz)
+		e_lim = h->nnz;
+
+	/* Last column boundary within the limit */
+	size_t lo = 0, hi = k_max;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo + 1) / 2;
+		if (b->ptr[mid] <= e_lim)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	size_t end;
+	if (lo < k_max && b->ptr[lo] < e_lim) {
+		/* Column c + lo does not fit: take its first part */
+		b->ncols = lo + 1;
+		end = e_lim;
+	} else {
+		b->ncols = lo;
+		end = b->ptr[lo] > *e ? b->ptr[lo] : *e;
+	}
+
+	b->c0 = *c;
+	b->e0 = *e;
+	b->n  = end - *e;
+
+	off_t off = (off_t)(h->row_idx_offset + *e * sizeof(csc_idx_t));
+	size_t len = b->n * sizeof(csc_idx_t);
+	if (len && read_full(job->fd, b->rows, len, off) != 0)
+		return -1;
+
+	/* The rows are ours now: keep the page cache from holding the file */
+	if (len)
+		posix_fadvise(job->fd, off, (off_t)len, POSIX_FADV_DONTNEED);
+
+	job->bytes_read += len + (k_max + 1) * sizeof(csc_ptr_t);
+	*c += lo;
+	*e = end;
+	return 0;
+}
+
+/**
+ * @brief Reader thread: fills the buffers with one pass over the file.
+ */
+static void *
+reader_main(void *arg)
+{
+	ext_job_t *job = arg;
+	size_t c = 0, e = 0;
+	int err = 0;
+
+	while (c < job->h.ncols) {
+		pthread_mutex_lock(&job->lock);
+		while (job->produced - job->consumed == 2)
+			pthread_cond_wait(&job->cond, &job->lock);
+		ext_block_t *b = &job->block[job->produced % 2];
+		pthread_mutex_unlock(&job->lock);
+
+		if (fill_block(job, b, &c, &e) != 0) {
+			err = errno ? errno : -1;
+			break;
+		}
+
+		pthread_mutex_lock(&job->lock);
+		job->produced++;
+		pthread_cond_broadcast(&job->cond);
+		pthread_mutex_unlock(&job->lock);
+	}
+
+	pthread_mutex_lock(&job->lock);
+	job->read_errno = err;
+	job->done = 1;
+	pthread_cond_broadcast(&job->cond);
+	pthread_mutex_unlock(&job->lock);
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                  Kernels                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Finds the root of @p x, pointing every visited vertex at its
+ *        grandparent (path halving).
+ */
+static inline csc_idx_t
+find_halve(csc_idx_t *parent, csc_idx_t x)
+{
+	csc_idx_t p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+
+	while (p != x) {
+		csc_idx_t gp = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+		if (gp != p)
+			__atomic_store_n(&parent[x], gp, __ATOMIC_RELAXED);
+		x = p;
+		p = gp;
+	}
+
+	return x;
+}
+
+/**
+ * @brief Unites the sets of @p a and @p b (Rem-style: the larger root is
+ *        linked below the smaller one with a compare-and-swap).
+ */
+static inline void
+union_rem(csc_idx_t *parent, csc_idx_t a, csc_idx_t b)
+{
+	for (;;) {
+		a = find_halve(parent, a);
+		b = find_halve(parent, b);
+
+		if (a == b)
+			return;
+
+		if (a < b) {
+			csc_idx_t t = a;
+			a = b;
+			b = t;
+		}
+
+		csc_idx_t expected = a;
+		if (__atomic_compare_exchange_n(&parent[a], &expected, b, 0,
+		                                __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return;
+	}
+}
+
+/**
+ * @brief Lowers label[v] to @p l if that is smaller.
+ *
+ * @return 1 if the label changed, 0 otherwise
+ */
+static inline int
+lower_label(csc_idx_t *label, csc_idx_t v, csc_idx_t l)
+{
+	csc_idx_t cur = __atomic_load_n(&label[v], __ATOMIC_RELAXED);
+
+	while (l < cur) {
+		if (__atomic_compare_exchange_n(&label[v], &cur, l, 1,
+		                                __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief First column of thread @p tid's share of a block, balanced by edges.
+ */
+static size_t
+block_split(const ext_block_t *b, unsigned int n_threads, unsigned int tid)
+{
+	if (tid == 0)
+		return 0;
+	if (tid == n_threads)
+		return b->ncols;
+
+	size_t target = b->e0 + par_block_begin(b->n, n_threads, tid);
+	size_t lo = 1, hi = b->ncols;
+
+	/* First column whose entries start at or after target */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (b->ptr[mid] < target)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * @brief Runs the selected kernel over one share of the current block.
+ */
+static void
+block_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	ext_job_t *job = arg;
+	const ext_block_t *b = job->cur;
+	size_t begin = block_split(b, n_threads, tid);
+	size_t end   = block_split(b, n_threads, tid + 1);
+	size_t e_end = b->e0 + b->n;
+	csc_idx_t *label = job->label;
+	int changed = 0, bad = 0;
+
+	for (size_t k = begin; k < end; k++) {
+		csc_idx_t c = (csc_idx_t)(b->c0 + k);
+		size_t s = b->ptr[k] > b->e0 ? b->ptr[k] : b->e0;
+		size_t t = b->ptr[k + 1] < e_end ? b->ptr[k + 1] : e_end;
+
+		for (size_t e = s; e < t; e++) {
+			csc_idx_t r = b->rows[e - b->e0];
+
+			if (r >= job->n) {
+				bad = 1;
+				continue;
+			}
+
+			if (job->variant == 1) {
+				union_rem(label, r, c);
+			} else {
+				csc_idx_t lc = __atomic_load_n(&label[c], __ATOMIC_RELAXED);
+				csc_idx_t lr = __atomic_load_n(&label[r], __ATOMIC_RELAXED);
+				if (lc < lr)
+					changed |= lower_label(label, r, lc);
+				else if (lr < lc)
+					changed |= lower_label(label, c, lr);
+			}
+		}
+	}
+
+	if (changed)
+		__atomic_store_n(&job->changed, 1, __ATOMIC_RELAXED);
+	if (bad)
+		__atomic_store_n(&job->bad_row, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Makes every vertex of one block of the label array its own label.
+ */
+static void
+init_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	ext_job_t *job = arg;
+	size_t begin = par_block_begin(job->n, n_threads, tid);
+	size_t end   = par_block_begin(job->n, n_threads, tid + 1);
+
+	for (size_t v = begin; v < end; v++)
+		job->label[v] = (csc_idx_t)v;
+}
+
+/**
+ * @brief Counts the vertices of one block that are their own label.
+ */
+static void
+count_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	ext_job_t *job = arg;
+	size_t begin = par_block_begin(job->n, n_threads, tid);
+	size_t end   = par_block_begin(job->n, n_threads, tid + 1);
+	size_t roots = 0;
+
+	for (size_t v = begin; v < end; v++)
+		roots += (job->label[v] == v);
+
+	job->roots[tid] = roots;
+}
+
+/**
+ * @brief Streams the whole file once through the kernels.
+ *
+ * @return 0 on success, -1 on error (reported)
+ */
+static int
+run_pass(ext_job_t *job, unsigned int n_threads, double *wait_time_s)
+{
+	pthread_t reader;
+
+	job->produced = 0;
+	job->consumed = 0;
+	job->done = 0;
+	job->read_errno = 0;
+
+	int rc = pthread_create(&reader, NULL, reader_main, job);
+	if (rc != 0) {
+		print_error(__func__, "pthread_create() failed", rc);
+		return -1;
+	}
+
+	for (;;) {
+		double t0 = now_sec();
+
+		pthread_mutex_lock(&job->lock);
+		while (job->consumed == job->produced && !job->done)
+			pthread_cond_wait(&job->cond, &job->lock);
+		int have = job->consumed < job->produced;
+		pthread_mutex_unlock(&job->lock);
+
+		*wait_time_s += now_sec() - t0;
+		if (!have)
+			break;
+
+		job->cur = &job->block[job->consumed % 2];
+		par_run(n_threads, block_worker, job);
+
+		pthread_mutex_lock(&job->lock);
+		job->consumed++;
+		pthread_cond_broadcast(&job->cond);
+		pthread_mutex_unlock(&job->lock);
+	}
+
+	pthread_join(reader, NULL);
+
+	if (job->read_errno == -1) {
+		print_error(__func__, "corrupt .csc file (col_ptr)", 0);
+		return -1;
+	}
+	if (job->read_errno) {
+		print_error(__func__, "failed to read .csc file", job->read_errno);
+		return -1;
+	}
+	if (job->bad_row) {
+		print_error(__func__, "corrupt .csc file (row index out of range)", 0);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc extcc_count()
+ */
+long
+extcc_count(const char *filename, unsigned int variant, size_t budget_bytes,
+            unsigned int n_threads, ExtCCStats *stats)
+{
+	ext_job_t job;
+	long components = -1;
+	unsigned int passes = 0;
+	double wait_time_s = 0.0;
+	char head[sizeof(CSCBinHeader)];
+	struct stat st;
+
+	memset(&job, 0, sizeof(job));
+	job.variant = variant;
+	pthread_mutex_init(&job.lock, NULL);
+	pthread_cond_init(&job.cond, NULL);
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+
+	job.fd = open(filename, O_RDONLY);
+	if (job.fd < 0) {
+		print_error(__func__, "failed to open .csc file", errno);
+		goto out;
+	}
+
+	if (fstat(job.fd, &st) != 0) {
+		print_error(__func__, "fstat() failed", errno);
+		goto out;
+	}
+
+	if ((size_t)st.st_size < sizeof(head) || read_full(job.fd, head, sizeof(head), 0) != 0) {
+		print_error(__func__, "file too small for a .csc header", 0);
+		goto out;
+	}
+
+	if (cscbin_read_header(head, (size_t)st.st_size, &job.h) != 0)
+		goto out;
+
+	/* Vertices and budget: the labels stay, the rest is split into two buffers */
+	job.n = job.h.nrows > job.h.ncols ? job.h.nrows : job.h.ncols;
+	size_t label_bytes = (job.n + 1) * sizeof(csc_idx_t);
+
+	if (budget_bytes < label_bytes || (budget_bytes - label_bytes) / 2 < EXTCC_MIN_BUFFER) {
+		char err[160];
+		snprintf(err, sizeof(err),
+		         "memory budget too small: labels take %.1f MiB, plus 2 x %u KiB of blocks",
+		         label_bytes / 1048576.0, EXTCC_MIN_BUFFER >> 10);
+		print_error(__func__, err, 0);
+		goto out;
+	}
+
+	/* An eighth of each buffer for column pointers, no more than the file holds */
+	size_t buffer = (budget_bytes - label_bytes) / 2;
+	job.cap_cols = buffer / 8 / sizeof(csc_ptr_t);
+	job.cap_edges = (buffer - job.cap_cols * sizeof(csc_ptr_t)) / sizeof(csc_idx_t);
+	if (job.cap_cols > job.h.ncols + 1)
+		job.cap_cols = job.h.ncols + 1;
+	if (job.cap_edges > job.h.nnz)
+		job.cap_edges = job.h.nnz ? job.h.nnz : 1;
+	if (job.cap_cols < 2)
+		job.cap_cols = 2;
+
+	job.label = malloc(label_bytes);
+	job.roots = malloc(n_threads * sizeof(size_t));
+	for (int i = 0; i < 2; i++) {
+		job.block[i].ptr  = malloc(job.cap_cols * sizeof(csc_ptr_t));
+		job.block[i].rows = malloc(job.cap_edges * sizeof(csc_idx_t));
+	}
+
+	if (!job.label || !job.roots || !job.block[0].ptr || !job.block[0].rows ||
+	    !job.block[1].ptr || !job.block[1].rows)
+	{
+		print_error(__func__, "malloc failed", errno);
+		goto out;
+	}
+
+	posix_fadvise(job.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	par_run(n_threads, init_worker, &job);
+
+	/* Union-find needs one pass; propagation repeats until nothing changes */
+	do {
+		job.changed = 0;
+		if (run_pass(&job, n_threads, &wait_time_s) != 0)
+			goto out;
+		passes++;
+	} while (variant == 0 && job.changed);
+
+	par_run(n_threads, count_worker, &job);
+
+	components = 0;
+	for (unsigned int t = 0; t < n_threads; t++)
+		components += (long)job.roots[t];
+
+	if (stats) {
+		stats->nrows = job.h.nrows;
+		stats->ncols = job.h.ncols;
+		stats->nnz = job.h.nnz;
+		stats->block_edges = job.cap_edges;
+		stats->block_cols = job.cap_cols;
+		stats->resident_bytes = label_bytes +
+			2 * (job.cap_cols * sizeof(csc_ptr_t) + job.cap_edges * sizeof(csc_idx_t));
+		stats->passes = passes;
+		stats->bytes_read = job.bytes_read;
+		stats->wait_time_s = wait_time_s;
+	}
+
+out:
+	if (job.fd >= 0)
+		close(job.fd);
+	for (int i = 0; i < 2; i++) {
+		free(job.block[i].ptr);
+		free(job.block[i].rows);
+	}
+	free(job.label);
+	free(job.roots);
+	pthread_mutex_destroy(&job.lock);
+	pthread_cond_destroy(&job.cond);
+	return components;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file extcc.h
+ * @brief Semi-external connected components for .csc files larger than memory.
+ *
+ * Only the per-vertex label array is kept in memory. The column pointers
+ * and row indices stay in the .csc file and are read in blocks by a reader
+ * thread into two buffers, so the kernels work on one block while the next
+ * one is being read. The label array and both buffers together stay within
+ * a memory budget given by the caller; a smaller budget only means smaller
+ * blocks and more reads.
+ *
+ * - Union-find (variant 1) reads the file once.
+ * - Label propagation (variant 0) reads it once per sweep, until a sweep
+ *   changes no label.
+ *
+ * Row ranges are dropped from the page cache once they have been used, so
+ * the file does not stay resident behind the process's back either.
+ */
+
+#ifndef EXTCC_H
+#define EXTCC_H
+
+#include <stddef.h>
+
+/**
+ * @struct ExtCCStats
+ * @brief Measurements of one semi-external run.
+ */
+typedef struct {
+	size_t nrows;         /**< Number of rows */
+	size_t ncols;         /**< Number of columns */
+	size_t nnz;           /**< Stored entries */
+	size_t block_edges;   /**< Row indices per block */
+	size_t block_cols;    /**< Column pointers per block */
+	size_t resident_bytes;/**< Labels plus both block buffers */
+	unsigned int passes;  /**< Passes over the file */
+	size_t bytes_read;    /**< Bytes read from the file over all passes */
+	double wait_time_s;   /**< Wall time the kernels spent waiting for a block */
+} ExtCCStats;
+
+/**
+ * @brief Counts the connected components of a .csc file within a memory budget.
+ *
+ * @param filename Path to the .csc file (see cscbin.h)
+ * @param variant 0 for label propagation, 1 for union-find
+ * @param budget_bytes Upper bound on the labels plus both block buffers
+ * @param n_threads Number of kernel threads (0 uses every online CPU); the
+ *        reader thread comes on top
+ * @param stats Output: measurements of the run (may be NULL)
+ * @return Number of connected components, or -1 on error (reported
+ *         through print_error()), including a budget too small for the
+ *         labels and two minimal blocks
+ */
+long extcc_count(const char *filename, unsigned int variant, size_t budget_bytes,
+                 unsigned int n_threads, ExtCCStats *stats);
+
+#endif /* EXTCC_H */
@@ -0,0 +1,453 @@
+/**
+ * @file instream.c
+ * @brief Streaming decompression of compressed text inputs.
+ *
+ * The decompressor thread fills INSTREAM_NBUF buffers in turn. After
+ * filling one, it moves the partial line at its end into a carry buffer
+ * that starts the next one, so every delivered block holds whole lines.
+ * A mutex and two condition variables hand buffers back and forth.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <zlib.h>
+#ifdef USE_XZ
+#include <lzma.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "instream.h"
+#include "error.h"
+
+#define INSTREAM_NBUF  3u          /**< Buffers in the ring */
+#define INSTREAM_BLOCK (16u << 20) /**< Bytes per buffer */
+#define INSTREAM_IN    (1u << 18)  /**< Compressed input buffer (xz, zstd) */
+
+/**
+ * @struct InStream
+ * @brief Decompressor state and the buffer ring shared with the consumer.
+ */
+struct InStream {
+	InStreamFormat fmt;           /* Compression format */
+	FILE *f;                      /* Compressed input (xz, zstd) */
+	gzFile gz;                    /* gzip input */
+#ifdef USE_XZ
+	lzma_stream xz;               /* xz decoder */
+	int xz_end;                   /* Decoder reached the end of the input */
+#endif
+#ifdef USE_ZSTD
+	ZSTD_DCtx *zstd;              /* zstd decoder */
+	ZSTD_inBuffer zin;            /* Pending compressed input */
+	size_t zstd_last;             /* Last return value: 0 at a frame boundary */
+#endif
+	uint8_t *in;                  /* Compressed input buffer (xz, zstd) */
+	const char *dec_err;          /* Decoder error (decompressor thread only) */
+
+	char *buf[INSTREAM_NBUF];     /* Buffer ring */
+	size_t len[INSTREAM_NBUF];    /* Bytes of whole lines in each filled buffer */
+	char *carry;                  /* Partial line carried into the next buffer */
+	size_t carry_len;             /* Length of the carried line */
+
+	pthread_t thread;             /* Decompressor thread */
+	pthread_mutex_t lock;         /* Protects the fields below */
+	pthread_cond_t not_full;      /* Signalled when a buffer is handed back */
+	pthread_cond_t not_empty;     /* Signalled when a buffer is filled */
+	unsigned int head;            /* Next buffer to fill */
+	unsigned int tail;            /* Next buffer to deliver */
+	unsigned int filled;          /* Filled buffers, including the one held */
+	int holding;                  /* Consumer holds buffer tail */
+	int eof;                      /* Decompressor is done (end of input or error) */
+	int stop;                     /* Consumer asked the decompressor to quit */
+	const char *err;              /* Decompressor error message */
+	size_t bytes;                 /* Bytes delivered to the consumer */
+};
+
+/* ------------------------------------------------------------------------- */
+/*                                  Decoders                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Decompresses up to @p cap bytes into @p dst.
+ *
+ * @return Bytes produced (0 at the end of the input), or -1 on error
+ */
+static ssize_t
+decode(InStream *s, char *dst, size_t cap)
+{
+	switch (s->fmt) {
+	case INSTREAM_GZIP: {
+		/* gzread() also follows concatenated gzip members */
+		int n = gzread(s->gz, dst, cap > (1u << 30) ? (1u << 30) : (unsigned int)cap);
+		int errnum = Z_OK;
+		if (n == 0)
+			gzerror(s->gz, &errnum);
+		if (n < 0 || errnum == Z_BUF_ERROR) {
+			s->dec_err = n < 0 ? "corrupt gzip input" : "truncated gzip input";
+			return -1;
+		}
+		return n;
+	}
+
+#ifdef USE_XZ
+	case INSTREAM_XZ: {
+		s->xz.next_out  = (uint8_t *)dst;
+		s->xz.avail_out = cap;
+
+		while (s->xz.avail_out > 0 && !s->xz_end) {
+			lzma_action action = LZMA_RUN;
+
+			if (s->xz.avail_in == 0) {
+				s->xz.next_in  = s->in;
+				s->xz.avail_in = fread(s->in, 1, INSTREAM_IN, s->f);
+				if (s->xz.avail_in == 0)
+					action = LZMA_FINISH;
+			}
+
+			lzma_ret ret = lzma_code(&s->xz, action);
+			if (ret == LZMA_STREAM_END) {
+				s->xz_end = 1;
+			} else if (ret != LZMA_OK) {
+				s->dec_err = ret == LZMA_BUF_ERROR ? "truncated xz input" : "corrupt xz input";
+				return -1;
+			}
+		}
+		return (ssize_t)(cap - s->xz.avail_out);
+	}
+#endif
+
+#ifdef USE_ZSTD
+	case INSTREAM_ZSTD: {
+		ZSTD_outBuffer out = { dst, cap, 0 };
+
+		while (out.pos < out.size) {
+			if (s->zin.pos == s->zin.size) {
+				s->zin.size = fread(s->in, 1, INSTREAM_IN, s->f);
+				s->zin.pos  = 0;
+				if (s->zin.size == 0) {
+					if (s->zstd_last != 0) {
+						s->dec_err = "truncated zstd input";
+						return -1;
+					}
+					break;
+				}
+			}
+
+			size_t ret = ZSTD_decompressStream(s->zstd, &out, &s->zin);
+			if (ZSTD_isError(ret)) {
+				s->dec_err = "corrupt zstd input";
+				return -1;
+			}
+			s->zstd_last = ret;
+		}
+		return (ssize_t)out.pos;
+	}
+#endif
+
+	default:
+		s->dec_err = "unsupported compression format";
+		return -1;
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/*                             Decompressor Thread                           */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fills buffers with whole lines until the input ends or the
+ *        consumer stops the stream.
+ */
+static void *
+producer(void *arg)
+{
+	InStream *s = arg;
+
+	for (;;) {
+		pthread_mutex_lock(&s->lock);
+		while (s->filled == INSTREAM_NBUF && !s->stop)
+			pthread_cond_wait(&s->not_full, &s->lock);
+		unsigned int slot = s->head;
+		int stop = s->stop;
+		pthread_mutex_unlock(&s->lock);
+
+		if (stop)
+			break;
+
+		char *buf = s->buf[slot];
+		size_t len = s->carry_len;
+		int end = 0;
+
+		memcpy(buf, s->carry, s->carry_len);
+		s->carry_len = 0;
+
+		while (len < INSTREAM_BLOCK) {
+			ssize_t got = decode(s, buf + len, INSTREAM_BLOCK - len);
+			if (got <= 0) {
+				end = 1;
+				break;
+			}
+			len += (size_t)got;
+		}
+
+		/* Keep whole lines; the rest starts the next buffer */
+		size_t keep = len;
+		if (!end) {
+			while (keep > 0 && buf[keep - 1] != '\n')
+				keep--;
+			if (keep == 0) {
+				s->dec_err = "line longer than the stream buffer";
+				end = 1;
+			} else {
+				s->carry_len = len - keep;
+				memcpy(s->carry, buf + keep, s->carry_len);
+			}
+		}
+
+		pthread_mutex_lock(&s->lock);
+		s->len[slot] = keep;
+		s->head = (slot + 1) % INSTREAM_NBUF;
+		s->filled++;
+		s->eof = end;
+		s->err = s->dec_err;
+		pthread_cond_signal(&s->not_empty);
+		pthread_mutex_unlock(&s->lock);
+
+		if (end)
+			break;
+	}
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Case-insensitive suffix match.
+ */
+static int
+suffix_is(const char *filename, const char *suffix)
+{
+	size_t n = strlen(filename), k = strlen(suffix);
+
+	if (n < k)
+		return 0;
+	for (size_t i = 0; i < k; i++)
+		if (tolower((unsigned char)filename[n - k + i]) != suffix[i])
+			return 0;
+	return 1;
+}
+
+/**
+ * @copydoc instream_format()
+ */
+InStreamFormat
+instream_format(const char *filename)
+{
+	if (suffix_is(filename, ".gz"))
+		return INSTREAM_GZIP;
+	if (suffix_is(filename, ".xz"))
+		return INSTREAM_XZ;
+	if (suffix_is(filename, ".zst"))
+		return INSTREAM_ZSTD;
+	return INSTREAM_NONE;
+}
+
+/**
+ * @brief Frees the decoder and buffers of a stream whose thread is not
+ *        running.
+ */
+static void
+stream_free(InStream *s)
+{
+	if (s->gz)
+		gzclose(s->gz);
+	if (s->f)
+		fclose(s->f);
+#ifdef USE_XZ
+	if (s->fmt == INSTREAM_XZ)
+		lzma_end(&s->xz);
+#endif
+#ifdef USE_ZSTD
+	ZSTD_freeDCtx(s->zstd);
+#endif
+	free(s->in);
+	for (unsigned int b = 0; b < INSTREAM_NBUF; b++)
+		free(s->buf[b]);
+	free(s->carry);
+	free(s);
+}
+
+/**
+ * @copydoc instream_open()
+ */
+InStream *
+instream_open(const char *filename, InStreamFormat fmt)
+{
+	InStream *s = calloc(1, sizeof(InStream));
+	if (!s) {
+		print_error(__func__, "malloc failed", errno);
+		return NULL;
+	}
+	s->fmt = fmt;
+
+	const char *err = NULL;
+
+	switch (fmt) {
+	case INSTREAM_GZIP:
+		s->gz = gzopen(filename, "rb");
+		if (!s->gz)
+			err = "failed to open gzip file";
+		else
+			gzbuffer(s->gz, INSTREAM_IN);
+		break;
+
+	case INSTREAM_XZ:
+#ifdef USE_XZ
+		s->xz = (lzma_stream)LZMA_STREAM_INIT;
+		if (lzma_stream_decoder(&s->xz, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+			err = "lzma_stream_decoder failed";
+		break;
+#else
+		err = "xz input needs a build with XZ=1";
+		break;
+#endif
+
+	case INSTREAM_ZSTD:
+#ifdef USE_ZSTD
+		s->zstd = ZSTD_createDCtx();
+		if (!s->zstd)
+			err = "ZSTD_createDCtx failed";
+		s->zin = (ZSTD_inBuffer){ NULL, 0, 0 };
+		break;
+#else
+		err = "zstd input needs a build with ZSTD=1";
+		break;
+#endif
+
+	default:
+		err = "unsupported compression format";
+		break;
+	}
+
+	if (!err && fmt != INSTREAM_GZIP) {
+		s->f  = fopen(filename, "rb");
+		s->in = malloc(INSTREAM_IN);
+		if (!s->f)
+			err = "failed to open compressed file";
+		else if (!s->in)
+			err = "malloc failed";
+#ifdef USE_ZSTD
+		s->zin.src = s->in;
+#endif
+	}
+
+	for (unsigned int b = 0; !err && b < INSTREAM_NBUF; b++)
+		if (!(s->buf[b] = malloc(INSTREAM_BLOCK)))
+			err = "malloc failed";
+	if (!err && !(s->carry = malloc(INSTREAM_BLOCK)))
+		err = "malloc failed";
+
+	if (err) {
+		print_error(__func__, err, errno);
+		stream_free(s);
+		return NULL;
+	}
+
+	pthread_mutex_init(&s->lock, NULL);
+	pthread_cond_init(&s->not_full, NULL);
+	pthread_cond_init(&s->not_empty, NULL);
+
+	int rc = pthread_create(&s->thread, NULL, producer, s);
+	if (rc != 0) {
+		print_error(__func__, "failed to start the decompressor thread", rc);
+		pthread_mutex_destroy(&s->lock);
+		pthread_cond_destroy(&s->not_full);
+		pthread_cond_destroy(&s->not_empty);
+		stream_free(s);
+		return NULL;
+	}
+
+	return s;
+}
+
+/**
+ * @copydoc instream_next()
+ */
+int
+instream_next(InStream *s, const char **data, size_t *len)
+{
+	pthread_mutex_lock(&s->lock);
+
+	/* Hand the previous block back */
+	if (s->holding) {
+		s->tail = (s->tail + 1) % INSTREAM_NBUF;
+		s->filled--;
+		s->holding = 0;
+		pthread_cond_signal(&s->not_full);
+	}
+
+	while (s->filled == 0 && !s->eof)
+		pthread_cond_wait(&s->not_empty, &s->lock);
+
+	int ret;
+	if (s->err) {
+		ret = -1;
+	} else if (s->filled == 0) {
+		ret = 0;
+	} else {
+		*data = s->buf[s->tail];
+		*len  = s->len[s->tail];
+		s->bytes += *len;
+		s->holding = 1;
+		ret = 1;
+	}
+
+	pthread_mutex_unlock(&s->lock);
+
+	if (ret < 0)
+		print_error(__func__, s->err, 0);
+	return ret;
+}
+
+/**
+ * @copydoc instream_bytes()
+ */
+size_t
+instream_bytes(const InStream *s)
+{
+	return s->bytes;
+}
+
+/**
+ * @copydoc instream_close()
+ */
+void
+instream_close(InStream *s)
+{
+	if (!s)
+		return;
+
+	pthread_mutex_lock(&s->lock);
+	s->stop = 1;
+	pthread_cond_signal(&s->not_full);
+	pthread_mutex_unlock(&s->lock);
+
+	pthread_join(s->thread, NULL);
+
+	pthread_mutex_destroy(&s->lock);
+	pthread_cond_destroy(&s->not_full);
+	pthread_cond_destroy(&s->not_empty);
+	stream_free(s);
+}
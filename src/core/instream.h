@@ -0,0 +1,76 @@
+/**
+ * @file instream.h
+ * @brief Streaming decompression of compressed text inputs.
+ *
+ * A compressed file is decompressed by a dedicated thread into a small
+ * ring of large buffers. The consumer receives the text block by block,
+ * each block ending on a line boundary, so a line-oriented parser can
+ * tokenize every block on its own while the next one is being
+ * decompressed. At no point is the whole decompressed file held in memory
+ * or written to disk.
+ *
+ * gzip is always available (zlib). xz and zstd need `make XZ=1` and
+ * `make ZSTD=1` respectively.
+ */
+
+#ifndef INSTREAM_H
+#define INSTREAM_H
+
+#include <stddef.h>
+
+/**
+ * @enum InStreamFormat
+ * @brief Compression format of an input file.
+ */
+typedef enum {
+	INSTREAM_NONE = 0,  /**< Not compressed */
+	INSTREAM_GZIP,      /**< gzip (.gz) */
+	INSTREAM_XZ,        /**< xz (.xz) */
+	INSTREAM_ZSTD       /**< Zstandard (.zst) */
+} InStreamFormat;
+
+/** Opaque decompressing reader */
+typedef struct InStream InStream;
+
+/**
+ * @brief Detects the compression format from the file name suffix.
+ *
+ * @param filename Path to check
+ * @return Format, or INSTREAM_NONE for an uncompressed name
+ */
+InStreamFormat instream_format(const char *filename);
+
+/**
+ * @brief Opens a compressed file and starts the decompressor thread.
+ *
+ * @param filename Path to the compressed file
+ * @param fmt Format, as returned by instream_format()
+ * @return New stream, or NULL on error (reported through print_error())
+ */
+InStream *instream_open(const char *filename, InStreamFormat fmt);
+
+/**
+ * @brief Waits for the next block of decompressed text.
+ *
+ * Every block but the last ends with a newline. The block stays valid
+ * until the next call or instream_close(), after which its buffer is
+ * handed back to the decompressor.
+ *
+ * @param s Stream
+ * @param data Output: first byte of the block
+ * @param len Output: length of the block
+ * @return 1 for a block, 0 at the end of the input, -1 on error (reported)
+ */
+int instream_next(InStream *s, const char **data, size_t *len);
+
+/**
+ * @brief Number of decompressed bytes delivered so far.
+ */
+size_t instream_bytes(const InStream *s);
+
+/**
+ * @brief Stops the decompressor thread and frees the stream. Safe with NULL.
+ */
+void instream_close(InStream *s);
+
+#endif /* INSTREAM_H */
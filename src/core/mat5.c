@@ -0,0 +1,696 @@
+/**
+ * @file mat5.c
+ * @brief Pattern-only reader for MATLAB Level 5 (.mat v5/v7) files.
+ *
+ * A Level 5 file is a 128-byte header followed by a sequence of data
+ * elements, each an 8-byte tag (type, size) and its payload. A variable
+ * is a miMATRIX element, optionally wrapped in a miCOMPRESSED element
+ * holding its zlib stream. Inside a miMATRIX come the array flags, the
+ * dimensions and the name, then class-specific data:
+ *
+ * - struct: field name length, field names, then one miMATRIX per field
+ * - sparse: ir (row indices), jc (column pointers), pr (values), [pi]
+ *
+ * Variables other than the requested one are skipped with a seek, without
+ * decompressing them. Within the requested struct, earlier fields are
+ * inflated and discarded, and reading stops right after jc.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <zlib.h>
+
+#include "mat5.h"
+#include "error.h"
+
+/* Data types used by this reader (MAT-File Format, Level 5) */
+#define MI_INT8        1
+#define MI_UINT8       2
+#define MI_INT16       3
+#define MI_UINT16      4
+#define MI_INT32       5
+#define MI_UINT32      6
+#define MI_INT64       12
+#define MI_UINT64      13
+#define MI_MATRIX      14
+#define MI_COMPRESSED  15
+
+/* Array classes */
+#define MX_STRUCT_CLASS 2
+#define MX_SPARSE_CLASS 5
+
+#define MAT5_HEADER    128u        /**< Size of the file header */
+#define MAT5_VERSION   0x0100u     /**< Level 5 version field */
+#define MAT5_ENDIAN    (('M' << 8) | 'I') /**< Endian indicator in native order */
+#define MAT5_BUF       (1u << 18)  /**< Compressed input / discard buffer size */
+#define MAT5_MAX_META  (1u << 20)  /**< Largest flags/dims/name element accepted */
+
+/**
+ * @struct mat5_src_t
+ * @brief Byte source over the payload of the current variable.
+ *
+ * Reads either straight from the file (uncompressed variables) or through
+ * an inflate stream fed from the file (miCOMPRESSED variables).
+ */
+typedef struct {
+	FILE *f;              /* Input file */
+	int inflating;        /* 1 while reading a miCOMPRESSED payload */
+	z_stream z;           /* Inflate state (valid while inflating) */
+	uint64_t in_left;     /* Compressed bytes not yet read from the file */
+	uint8_t *in;          /* Compressed input buffer (MAT5_BUF bytes) */
+	uint8_t *discard;     /* Output buffer for skipped bytes (MAT5_BUF bytes) */
+	const char *err;      /* First error, reported by mat5_read_pattern() */
+} mat5_src_t;
+
+/* ------------------------------------------------------------------------- */
+/*                                Byte Source                                */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Records the first error and returns -1.
+ */
+static int
+fail(mat5_src_t *s, const char *msg)
+{
+	if (!s->err)
+		s->err = msg;
+	return -1;
+}
+
+/**
+ * @brief Reads exactly @p n payload bytes into @p dst.
+ */
+static int
+src_read(mat5_src_t *s, void *dst, size_t n)
+{
+	if (!s->inflating)
+		return fread(dst, 1, n, s->f) == n ? 0 : fail(s, "unexpected end of file");
+
+	uint8_t *out = dst;
+
+	while (n > 0) {
+		uInt chunk = n > (1u << 30) ? (1u << 30) : (uInt)n;
+
+		s->z.next_out  = out;
+		s->z.avail_out = chunk;
+
+		while (s->z.avail_out > 0) {
+			if (s->z.avail_in == 0) {
+				size_t want = s->in_left < MAT5_BUF ? (size_t)s->in_left : MAT5_BUF;
+				if (want == 0)
+					return fail(s, "compressed variable ends early");
+				if (fread(s->in, 1, want, s->f) != want)
+					return fail(s, "unexpected end of file");
+				s->in_left -= want;
+				s->z.next_in  = s->in;
+				s->z.avail_in = (uInt)want;
+			}
+
+			int ret = inflate(&s->z, Z_NO_FLUSH);
+			if (ret == Z_STREAM_END && s->z.avail_out > 0)
+				return fail(s, "compressed variable ends early");
+			if (ret != Z_OK && ret != Z_STREAM_END)
+				return fail(s, "corrupt compressed variable");
+		}
+
+		out += chunk;
+		n -= chunk;
+	}
+	return 0;
+}
+
+/**
+ * @brief Skips @p n payload bytes.
+ */
+static int
+src_skip(mat5_src_t *s, uint64_t n)
+{
+	if (!s->inflating)
+		return fseeko(s->f, (off_t)n, SEEK_CUR) == 0 ? 0 : fail(s, "seek failed");
+
+	while (n > 0) {
+		size_t chunk = n < MAT5_BUF ? (size_t)n : MAT5_BUF;
+		if (src_read(s, s->discard, chunk) != 0)
+			return -1;
+		n -= chunk;
+	}
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               Data Elements                               */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Padding after a payload of @p n bytes (elements are 8-byte aligned).
+ */
+static inline uint64_t
+pad8(uint64_t n)
+{
+	return (8 - n % 8) % 8;
+}
+
+/**
+ * @brief Width in bytes of an integer data type, 0 for other types.
+ */
+static size_t
+int_width(uint32_t type)
+{
+	switch (type) {
+	case MI_INT8:  case MI_UINT8:  return 1;
+	case MI_INT16: case MI_UINT16: return 2;
+	case MI_INT32: case MI_UINT32: return 4;
+	case MI_INT64: case MI_UINT64: return 8;
+	default:                       return 0;
+	}
+}
+
+/**
+ * @brief Reads an element tag.
+ *
+ * In the small data element format the payload (at most 4 bytes) is
+ * packed into the tag itself and is returned in @p small.
+ *
+ * @return 1 for a small element, 0 for a regular one, -1 on error
+ */
+static int
+read_tag(mat5_src_t *s, uint32_t *type, uint32_t *nbytes, uint8_t small[4])
+{
+	uint32_t tag[2];
+
+	if (src_read(s, tag, sizeof(tag)) != 0)
+		return -1;
+
+	if (tag[0] >> 16) {
+		*type   = tag[0] & 0xffff;
+		*nbytes = tag[0] >> 16;
+		if (*nbytes > 4)
+			return fail(s, "corrupt small data element");
+		memcpy(small, &tag[1], 4);
+		return 1;
+	}
+
+	*type   = tag[0];
+	*nbytes = tag[1];
+	return 0;
+}
+
+/**
+ * @brief Reads a short element (array flags, dimensions, names) whole.
+ *
+ * @return Newly allocated, NUL-terminated payload, or NULL on error
+ */
+static uint8_t *
+read_meta(mat5_src_t *s, uint32_t *type, uint32_t *nbytes)
+{
+	uint8_t small[4];
+	int fmt = read_tag(s, type, nbytes, small);
+
+	if (fmt < 0)
+		return NULL;
+	if (*nbytes > MAT5_MAX_META) {
+		fail(s, "corrupt array header");
+		return NULL;
+	}
+
+	uint8_t *p = malloc(*nbytes + 1);
+	if (!p) {
+		fail(s, "malloc failed");
+		return NULL;
+	}
+
+	if (fmt == 1) {
+		memcpy(p, small, *nbytes);
+	} else if (src_read(s, p, *nbytes) != 0 || src_skip(s, pad8(*nbytes)) != 0) {
+		free(p);
+		return NULL;
+	}
+
+	p[*nbytes] = '\0';
+	return p;
+}
+
+/**
+ * @brief Array flags, dimensions and name at the start of a miMATRIX.
+ */
+typedef struct {
+	unsigned int cls;     /* Array class (MX_*_CLASS) */
+	size_t rank;          /* Number of dimensions */
+	size_t dims[2];       /* First two dimensions */
+	size_t numel;         /* Product of all dimensions */
+	char name[64];        /* Variable name (empty for struct fields) */
+} mat5_array_t;
+
+/**
+ * @brief Reads the common header of a miMATRIX payload.
+ */
+static int
+read_array_header(mat5_src_t *s, mat5_array_t *a)
+{
+	uint32_t type, nbytes;
+	uint8_t *p;
+
+	/* Array flags: class in the low byte, then nzmax */
+	if (!(p = read_meta(s, &type, &nbytes)))
+		return -1;
+	if (type != MI_UINT32 || nbytes != 8) {
+		free(p);
+		return fail(s, "corrupt array flags");
+	}
+	uint32_t flags;
+	memcpy(&flags, p, 4);
+	a->cls = flags & 0xff;
+	free(p);
+
+	/* Dimensions */
+	if (!(p = read_meta(s, &type, &nbytes)))
+		return -1;
+	if (type != MI_INT32 || nbytes < 8 || nbytes % 4) {
+		free(p);
+		return fail(s, "corrupt array dimensions");
+	}
+	a->rank  = nbytes / 4;
+	a->numel = 1;
+	for (size_t k = 0; k < a->rank; k++) {
+		int32_t d;
+		memcpy(&d, p + 4 * k, 4);
+		if (d < 0) {
+			free(p);
+			return fail(s, "corrupt array dimensions");
+		}
+		if (k < 2)
+			a->dims[k] = (size_t)d;
+		a->numel *= (size_t)d;
+	}
+	free(p);
+
+	/* Name */
+	if (!(p = read_meta(s, &type, &nbytes)))
+		return -1;
+	if (type != MI_INT8 && type != MI_UINT8) {
+		free(p);
+		return fail(s, "corrupt array name");
+	}
+	snprintf(a->name, sizeof(a->name), "%s", (const char *)p);
+	free(p);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               Index Arrays                                */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Loads an unsigned integer of @p w bytes.
+ */
+static inline uint64_t
+load_uint(const uint8_t *p, size_t w)
+{
+	uint8_t v8; uint16_t v16; uint32_t v32; uint64_t v64;
+
+	switch (w) {
+	case 1:  memcpy(&v8, p, 1);  return v8;
+	case 2:  memcpy(&v16, p, 2); return v16;
+	case 4:  memcpy(&v32, p, 4); return v32;
+	default: memcpy(&v64, p, 8); return v64;
+	}
+}
+
+/**
+ * @brief Stores @p v as an unsigned integer of @p w bytes (4 or 8).
+ */
+static inline void
+store_uint(uint8_t *p, size_t w, uint64_t v)
+{
+	if (w == 4) {
+		uint32_t v32 = (uint32_t)v;
+		memcpy(p, &v32, 4);
+	} else {
+		memcpy(p, &v, 8);
+	}
+}
+
+/**
+ * @brief Reads an integer array element into a new array of @p width-byte
+ *        unsigned entries.
+ *
+ * Entries of the same width are read in place. Narrower ones are read into
+ * the tail of the output and widened front to back, which never overwrites
+ * an entry before it is converted. Wider ones go through the discard buffer
+ * and are range-checked against @p max.
+ *
+ * @param s Byte source
+ * @param width Output entry width (4 or 8)
+ * @param max Largest value representable in the output
+ * @param count Output: number of entries
+ * @return Newly allocated array, or NULL on error
+ */
+static uint8_t *
+read_index(mat5_src_t *s, size_t width, uint64_t max, size_t *count)
+{
+	uint32_t type, nbytes;
+	uint8_t small[4];
+	int fmt = read_tag(s, &type, &nbytes, small);
+
+	if (fmt < 0)
+		return NULL;
+
+	size_t w = int_width(type);
+	if (!w || nbytes % w) {
+		fail(s, "sparse index array is not an integer array");
+		return NULL;
+	}
+
+	size_t n = nbytes / w;
+	int is_signed = type == MI_INT8 || type == MI_INT16 ||
+	                type == MI_INT32 || type == MI_INT64;
+
+	/* +1: malloc(0) may return NULL for an empty array */
+	uint8_t *dst = malloc(n * width + 1);
+	if (!dst) {
+		fail(s, "malloc failed");
+		return NULL;
+	}
+
+	if (w <= width) {
+		uint8_t *src = dst + n * (width - w);
+
+		if (fmt == 1)
+			memcpy(src, small, nbytes);
+		else if (src_read(s, src, nbytes) != 0)
+			goto fail;
+
+		if (w < width) {
+			for (size_t k = 0; k < n; k++) {
+				uint64_t v = load_uint(src + k * w, w);
+				if (is_signed && (v >> (8 * w - 1))) {
+					fail(s, "negative sparse index");
+					goto fail;
+				}
+				store_uint(dst + k * width, width, v);
+			}
+		}
+	} else {
+		size_t per_chunk = MAT5_BUF / w;
+
+		for (size_t k = 0; k < n; k += per_chunk) {
+			size_t m = n - k < per_chunk ? n - k : per_chunk;
+
+			if (src_read(s, s->discard, m * w) != 0)
+				goto fail;
+			for (size_t e = 0; e < m; e++) {
+				uint64_t v = load_uint(s->discard + e * w, w);
+				if (v > max) {
+					fail(s, "matrix exceeds the index width of this build (see make INDEX=)");
+					goto fail;
+				}
+				store_uint(dst + (k + e) * width, width, v);
+			}
+		}
+	}
+
+	if (fmt == 0 && src_skip(s, pad8(nbytes)) != 0)
+		goto fail;
+
+	*count = n;
+	return dst;
+
+fail:
+	free(dst);
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                 Variables                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Output of read_sparse().
+ */
+typedef struct {
+	size_t nrows, ncols, nnz;
+	csc_ptr_t *col_ptr;
+	csc_idx_t *row_idx;
+} mat5_pattern_t;
+
+/**
+ * @brief Reads ir and jc of a sparse array whose header has been read, and
+ *        validates them. The value arrays are left unread.
+ */
+static int
+read_sparse(mat5_src_t *s, const mat5_array_t *a, mat5_pattern_t *out)
+{
+	size_t nir, njc;
+
+	if (a->cls != MX_SPARSE_CLASS || a->rank != 2)
+		return fail(s, "field is not a 2-D sparse matrix");
+	if (a->dims[0] > CSC_IDX_MAX)
+		return fail(s, "matrix exceeds the index width of this build (see make INDEX=)");
+
+	csc_idx_t *ir = (csc_idx_t *)read_index(s, sizeof(csc_idx_t), CSC_IDX_MAX, &nir);
+	if (!ir)
+		return -1;
+
+	csc_ptr_t *jc = (csc_ptr_t *)read_index(s, sizeof(csc_ptr_t), CSC_PTR_MAX, &njc);
+	if (!jc) {
+		free(ir);
+		return -1;
+	}
+
+	size_t ncols = a->dims[1];
+	const char *err = NULL;
+
+	if (njc != ncols + 1 || jc[0] != 0)
+		err = "corrupt sparse column pointers";
+	for (size_t j = 0; !err && j < ncols; j++)
+		if (jc[j + 1] < jc[j])
+			err = "corrupt sparse column pointers";
+	if (!err && jc[ncols] > nir)
+		err = "corrupt sparse column pointers";
+
+	size_t nnz = err ? 0 : jc[ncols];
+	for (size_t k = 0; !err && k < nnz; k++)
+		if (ir[k] >= a->dims[0])
+			err = "sparse row index out of range";
+
+	if (err) {
+		free(ir);
+		free(jc);
+		return fail(s, err);
+	}
+
+	/* ir holds nzmax slots; give back the unused tail */
+	if (nnz < nir) {
+		csc_idx_t *shrunk = realloc(ir, nnz * sizeof(csc_idx_t) + 1);
+		if (shrunk)
+			ir = shrunk;
+	}
+
+	out->nrows   = a->dims[0];
+	out->ncols   = ncols;
+	out->nnz     = nnz;
+	out->col_ptr = jc;
+	out->row_idx = ir;
+	return 0;
+}
+
+/**
+ * @brief Finds @p field_name in a struct whose header has been read and
+ *        reads its sparsity pattern. Earlier fields are skipped.
+ */
+static int
+read_struct_field(mat5_src_t *s, const mat5_array_t *a, const char *field_name,
+                  mat5_pattern_t *out)
+{
+	uint32_t type, nbytes;
+	uint8_t *p;
+
+	if (a->cls != MX_STRUCT_CLASS || a->numel != 1)
+		return fail(s, "variable is not a 1x1 struct");
+
+	/* Field name length, then the names, each padded to that length */
+	if (!(p = read_meta(s, &type, &nbytes)))
+		return -1;
+	if (type != MI_INT32 || nbytes != 4) {
+		free(p);
+		return fail(s, "corrupt struct field names");
+	}
+	int32_t len;
+	memcpy(&len, p, 4);
+	free(p);
+
+	if (!(p = read_meta(s, &type, &nbytes)))
+		return -1;
+	if (len <= 0 || nbytes % (uint32_t)len) {
+		free(p);
+		return fail(s, "corrupt struct field names");
+	}
+
+	size_t nfields = nbytes / (uint32_t)len;
+	size_t target = nfields;
+	for (size_t k = 0; k < nfields; k++) {
+		if (strncmp((const char *)p + k * (size_t)len, field_name, (size_t)len) == 0 &&
+		    strlen(field_name) < (size_t)len) {
+			target = k;
+			break;
+		}
+	}
+	free(p);
+
+	if (target == nfields)
+		return fail(s, "field not found in struct");
+
+	for (size_t k = 0; k < target; k++) {
+		uint8_t small[4];
+		if (read_tag(s, &type, &nbytes, small) != 0 || type != MI_MATRIX)
+			return fail(s, "corrupt struct field");
+		if (src_skip(s, nbytes + pad8(nbytes)) != 0)
+			return -1;
+	}
+
+	uint8_t small[4];
+	mat5_array_t fa;
+
+	if (read_tag(s, &type, &nbytes, small) != 0 || type != MI_MATRIX || nbytes == 0)
+		return fail(s, "corrupt struct field");
+	if (read_array_header(s, &fa) != 0)
+		return -1;
+
+	return read_sparse(s, &fa, out);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc mat5_probe()
+ */
+int
+mat5_probe(const char *filename)
+{
+	uint8_t h[MAT5_HEADER];
+	FILE *f = fopen(filename, "rb");
+
+	if (!f)
+		return 0;
+
+	size_t got = fread(h, 1, sizeof(h), f);
+	fclose(f);
+	if (got != sizeof(h))
+		return 0;
+
+	uint16_t version, endian;
+	memcpy(&version, h + 124, 2);
+	memcpy(&endian, h + 126, 2);
+
+	return version == MAT5_VERSION && endian == MAT5_ENDIAN;
+}
+
+/**
+ * @copydoc mat5_read_pattern()
+ */
+int
+mat5_read_pattern(const char *filename, const char *var_name,
+                  const char *field_name, size_t *nrows, size_t *ncols,
+                  size_t *nnz, csc_ptr_t **col_ptr, csc_idx_t **row_idx)
+{
+	mat5_src_t s = { 0 };
+	mat5_pattern_t out = { 0 };
+	int found = 0;
+
+	s.f = fopen(filename, "rb");
+	if (!s.f) {
+		print_error(__func__, "failed to open file", errno);
+		return -1;
+	}
+
+	s.in      = malloc(MAT5_BUF);
+	s.discard = malloc(MAT5_BUF);
+	if (!s.in || !s.discard) {
+		fail(&s, "malloc failed");
+		goto done;
+	}
+
+	if (fseeko(s.f, MAT5_HEADER, SEEK_SET) != 0) {
+		fail(&s, "seek failed");
+		goto done;
+	}
+
+	while (!found && !s.err) {
+		uint32_t tag[2];
+		off_t pos = ftello(s.f);
+
+		if (fread(tag, 1, sizeof(tag), s.f) != sizeof(tag)) {
+			fail(&s, "variable not found");
+			break;
+		}
+
+		off_t end = pos + (off_t)sizeof(tag) + tag[1];
+
+		if (tag[0] == MI_COMPRESSED) {
+			/* Fresh stream: no input left over from a skipped variable */
+			s.z.next_in  = Z_NULL;
+			s.z.avail_in = 0;
+			if (inflateInit(&s.z) != Z_OK) {
+				fail(&s, "inflateInit failed");
+				break;
+			}
+			s.inflating = 1;
+			s.in_left   = tag[1];
+
+			uint32_t type, nbytes;
+			uint8_t small[4];
+			if (read_tag(&s, &type, &nbytes, small) != 0 || type != MI_MATRIX)
+				fail(&s, "corrupt compressed variable");
+		} else if (tag[0] == MI_MATRIX) {
+			end += (off_t)pad8(tag[1]);
+		} else {
+			/* Not a variable: skip it */
+			if (fseeko(s.f, end, SEEK_SET) != 0)
+				fail(&s, "seek failed");
+			continue;
+		}
+
+		mat5_array_t a;
+		if (!s.err && read_array_header(&s, &a) == 0 && strcmp(a.name, var_name) == 0) {
+			found = 1;
+			if (field_name)
+				read_struct_field(&s, &a, field_name, &out);
+			else
+				read_sparse(&s, &a, &out);
+		}
+
+		if (s.inflating) {
+			inflateEnd(&s.z);
+			s.inflating = 0;
+		}
+
+		if (!found && !s.err && fseeko(s.f, end, SEEK_SET) != 0)
+			fail(&s, "seek failed");
+	}
+
+done:
+	free(s.in);
+	free(s.discard);
+	fclose(s.f);
+
+	if (s.err) {
+		print_error(__func__, s.err, 0);
+		return -1;
+	}
+
+	*nrows   = out.nrows;
+	*ncols   = out.ncols;
+	*nnz     = out.nnz;
+	*col_ptr = out.col_ptr;
+	*row_idx = out.row_idx;
+	return 0;
+}
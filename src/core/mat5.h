@@ -0,0 +1,54 @@
+/**
+ * @file mat5.h
+ * @brief Pattern-only reader for MATLAB Level 5 (.mat v5/v7) files.
+ *
+ * MATIO decodes a whole variable, including the value array of a sparse
+ * matrix (8 bytes per entry for doubles), only for the loader to keep the
+ * index arrays. This reader walks the file element by element instead,
+ * inflating compressed variables through zlib as a stream, and stops as
+ * soon as the sparse field's `ir` and `jc` arrays have been read. The value
+ * array that follows them is never decompressed.
+ *
+ * Index arrays whose element width matches csc_idx_t / csc_ptr_t are
+ * inflated straight into the final CSC arrays; narrower ones are widened
+ * in place, so no second copy is made.
+ *
+ * Only files in native byte order are handled. MATLAB 7.3 files (HDF5)
+ * and byte-swapped files are left to MATIO (see mat5_probe()).
+ */
+
+#ifndef MAT5_H
+#define MAT5_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+/**
+ * @brief Checks whether a file can be read by mat5_read_pattern().
+ *
+ * @param filename Path to the .mat file
+ * @return 1 for a Level 5 file in native byte order, 0 otherwise
+ *         (including when the file cannot be read)
+ */
+int mat5_probe(const char *filename);
+
+/**
+ * @brief Reads the sparsity pattern of a sparse matrix from a .mat file.
+ *
+ * @param filename Path to the .mat file
+ * @param var_name Name of the top-level variable (e.g. "Problem")
+ * @param field_name Struct field holding the sparse matrix (e.g. "A"), or
+ *                   NULL if the variable itself is the sparse matrix
+ * @param nrows Output: number of rows
+ * @param ncols Output: number of columns
+ * @param nnz Output: number of stored entries
+ * @param col_ptr Output: newly allocated column pointers (ncols + 1)
+ * @param row_idx Output: newly allocated row indices (nnz)
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mat5_read_pattern(const char *filename, const char *var_name,
+                      const char *field_name, size_t *nrows, size_t *ncols,
+                      size_t *nnz, csc_ptr_t **col_ptr, csc_idx_t **row_idx);
+
+#endif /* MAT5_H */
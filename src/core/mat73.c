@@ -0,0 +1,612 @@
+/**
+ * @file mat73.c
+ * @brief Chunked, parallel reader for MATLAB v7.3 (HDF5) .mat files.
+ *
+ * An index dataset is read batch by batch. Each parallel region reads
+ * batch k+1 on thread 0 (the only thread that calls into HDF5, which is
+ * not thread-safe in the usual builds) while every thread, thread 0
+ * included once its read is done, claims chunks of batch k from a shared
+ * counter and decodes them into the output array. Two batch buffers
+ * alternate between the roles, so no thread ever waits for another
+ * inside a region.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hdf5.h>
+#include <zlib.h>
+
+#include "mat73.h"
+#include "parallel.h"
+#include "error.h"
+
+#define MAT73_VERSION   0x0200u     /**< v7.3 version field of the MATLAB header */
+#define MAT73_ENDIAN    (('M' << 8) | 'I') /**< Endian indicator in native order */
+#define MAT73_BATCH     (32u << 20) /**< Raw bytes fetched per batch */
+
+/**
+ * @struct h5_batch_t
+ * @brief Raw chunks fetched by one read step.
+ */
+typedef struct {
+	uint8_t *raw;       /* Concatenated raw chunks */
+	size_t cap;         /* Allocated size of raw */
+	size_t *off;        /* Offset of each chunk in raw (count + 1) */
+	uint32_t *mask;     /* Filter mask of each chunk (bit set: filter skipped) */
+	size_t off_cap;     /* Allocated entries of off / mask */
+	size_t first;       /* Index of the first chunk */
+	size_t count;       /* Number of chunks */
+} h5_batch_t;
+
+/**
+ * @struct h5_job_t
+ * @brief State shared by the reader and decoder threads for one dataset.
+ */
+typedef struct {
+	hid_t dset;            /* Dataset being read */
+	int axis;              /* Axis along which the elements lie */
+	int rank;              /* Dataset rank (1 or 2) */
+	size_t n;              /* Elements in the dataset */
+	size_t esize;          /* Bytes per stored element */
+	int is_signed;         /* Stored type is signed */
+	size_t chunk;          /* Elements per chunk */
+	size_t nchunks;        /* Number of chunks */
+	int shuffle_bit;       /* Position of the shuffle filter, -1 if absent */
+	int deflate_bit;       /* Position of the deflate filter, -1 if absent */
+	size_t width;          /* Bytes per output element (4 or 8) */
+	uint64_t max;          /* Largest value representable in the output */
+	uint8_t *dst;          /* Output array */
+	h5_batch_t batch[2];   /* Batch being decoded / batch being read */
+	int cur;               /* Index of the batch being decoded */
+	size_t next_chunk;     /* First chunk of the next batch to read */
+	size_t claim;          /* Next chunk of the current batch to decode */
+	uint8_t **scratch;     /* Per-thread buffer of one decoded chunk */
+	int error;             /* Set by any thread on failure */
+	const char *err;       /* First error message */
+} h5_job_t;
+
+/**
+ * @brief Records the first error of a job.
+ */
+static void
+job_fail(h5_job_t *job, const char *msg)
+{
+	if (!__atomic_exchange_n(&job->error, 1, __ATOMIC_ACQ_REL))
+		job->err = msg;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                   Reader                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Dataset coordinates of the first element of chunk @p c.
+ */
+static void
+chunk_offset(const h5_job_t *job, size_t c, hsize_t offset[2])
+{
+	offset[0] = offset[1] = 0;
+	offset[job->axis] = (hsize_t)(c * job->chunk);
+}
+
+/**
+ * @brief Fetches the raw bytes of the next chunks (at most MAT73_BATCH
+ *        bytes, but at least one chunk) into @p b.
+ *
+ * Called by thread 0 only.
+ */
+static void
+read_batch(h5_job_t *job, h5_batch_t *b)
+{
+	hsize_t offset[2];
+	size_t total = 0;
+
+	b->first = job->next_chunk;
+	b->count = 0;
+
+	/* Size the batch */
+	for (size_t c = b->first; c < job->nchunks; c++) {
+		hsize_t bytes = 0;
+
+		chunk_offset(job, c, offset);
+		if (H5Dget_chunk_storage_size(job->dset, offset, &bytes) < 0) {
+			/* Not allocated: decoded as the fill value (zero) */
+			bytes = 0;
+		}
+		if (b->count > 0 && total + bytes > MAT73_BATCH)
+			break;
+
+		if (b->count + 1 >= b->off_cap) {
+			size_t cap = b->off_cap ? 2 * b->off_cap : 64;
+			size_t *off = realloc(b->off, cap * sizeof(size_t));
+			if (off)
+				b->off = off;
+			uint32_t *mask = realloc(b->mask, cap * sizeof(uint32_t));
+			if (mask)
+				b->mask = mask;
+			if (!off || !mask) {
+				job_fail(job, "malloc failed");
+				return;
+			}
+			b->off_cap = cap;
+		}
+
+		b->off[b->count++] = total;
+		total += (size_t)bytes;
+	}
+	b->off[b->count] = total;
+
+	if (total > b->cap) {
+		uint8_t *raw = realloc(b->raw, total);
+		if (!raw) {
+			job_fail(job, "malloc failed");
+			return;
+		}
+		b->raw = raw;
+		b->cap = total;
+	}
+
+	/* Read the chunks as stored, without running the filter pipeline */
+	for (size_t k = 0; k < b->count; k++) {
+		b->mask[k] = 0;
+		if (b->off[k + 1] == b->off[k])
+			continue;
+
+		chunk_offset(job, b->first + k, offset);
+		if (H5Dread_chunk(job->dset, H5P_DEFAULT, offset, &b->mask[k],
+		                  b->raw + b->off[k]) < 0) {
+			job_fail(job, "H5Dread_chunk failed");
+			return;
+		}
+	}
+
+	job->next_chunk = b->first + b->count;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                   Decoder                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Loads an unsigned integer of @p w bytes.
+ */
+static inline uint64_t
+load_uint(const uint8_t *p, size_t w)
+{
+	uint8_t v8; uint16_t v16; uint32_t v32; uint64_t v64;
+
+	switch (w) {
+	case 1:  memcpy(&v8, p, 1);  return v8;
+	case 2:  memcpy(&v16, p, 2); return v16;
+	case 4:  memcpy(&v32, p, 4); return v32;
+	default: memcpy(&v64, p, 8); return v64;
+	}
+}
+
+/**
+ * @brief Inflates, unshuffles and converts one chunk into the output.
+ */
+static void
+decode_chunk(h5_job_t *job, unsigned int tid, const h5_batch_t *b, size_t k)
+{
+	size_t c = b->first + k;
+	size_t elems = job->n - c * job->chunk < job->chunk ? job->n - c * job->chunk : job->chunk;
+	size_t full = job->chunk * job->esize;
+	const uint8_t *raw = b->raw + b->off[k];
+	size_t raw_len = b->off[k + 1] - b->off[k];
+	uint8_t *out = job->dst + c * job->chunk * job->width;
+
+	if (raw_len == 0) {
+		memset(out, 0, elems * job->width);
+		return;
+	}
+
+	int deflated = job->deflate_bit >= 0 && !(b->mask[k] & (1u << job->deflate_bit));
+	int shuffled = job->shuffle_bit >= 0 && !(b->mask[k] & (1u << job->shuffle_bit));
+	const uint8_t *src = raw;
+
+	if (deflated) {
+		/* Full chunks already in the output layout are inflated in place */
+		int direct = !shuffled && job->esize == job->width && elems == job->chunk;
+		uint8_t *to = direct ? out : job->scratch[tid];
+		uLongf len = (uLongf)full;
+
+		if (!to) {
+			to = job->scratch[tid] = malloc(full);
+			if (!to) {
+				job_fail(job, "malloc failed");
+				return;
+			}
+		}
+		if (uncompress(to, &len, raw, (uLong)raw_len) != Z_OK || len != full) {
+			job_fail(job, "corrupt compressed chunk");
+			return;
+		}
+		if (direct)
+			return;
+		src = to;
+	} else if (raw_len < full) {
+		job_fail(job, "truncated chunk");
+		return;
+	}
+
+	/* Gather (unshuffling if needed), range-check and store */
+	size_t w = job->esize;
+	uint64_t sign = (uint64_t)1 << (8 * w - 1);
+
+	for (size_t e = 0; e < elems; e++) {
+		uint64_t v;
+
+		if (shuffled) {
+			uint8_t bytes[8];
+			for (size_t i = 0; i < w; i++)
+				bytes[i] = src[i * job->chunk + e];
+			v = load_uint(bytes, w);
+		} else {
+			v = load_uint(src + e * w, w);
+		}
+
+		if ((job->is_signed && (v & sign)) || v > job->max) {
+			job_fail(job, "sparse index out of range for this build (see make INDEX=)");
+			return;
+		}
+
+		if (job->width == 4) {
+			uint32_t v32 = (uint32_t)v;
+			memcpy(out + e * 4, &v32, 4);
+		} else {
+			memcpy(out + e * 8, &v, 8);
+		}
+	}
+}
+
+/**
+ * @brief Parallel region: thread 0 reads the next batch, then every
+ *        thread decodes chunks of the current one.
+ */
+static void
+chunk_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	h5_job_t *job = arg;
+	const h5_batch_t *b = &job->batch[job->cur];
+
+	(void)n_threads;
+
+	if (tid == 0 && job->next_chunk < job->nchunks)
+		read_batch(job, &job->batch[!job->cur]);
+
+	for (;;) {
+		size_t k = __atomic_fetch_add(&job->claim, 1, __ATOMIC_RELAXED);
+		if (k >= b->count || __atomic_load_n(&job->error, __ATOMIC_RELAXED))
+			break;
+		decode_chunk(job, tid, b, k);
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                  Datasets                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Inspects the layout of a dataset and decides whether the direct
+ *        chunk path applies.
+ *
+ * @return 1 for the chunk path, 0 for the H5Dread() fallback, -1 on error
+ */
+static int
+inspect_dataset(h5_job_t *job)
+{
+	hid_t space = H5Dget_space(job->dset);
+	hid_t type  = H5Dget_type(job->dset);
+	hid_t dcpl  = H5Dget_create_plist(job->dset);
+	hsize_t dims[2] = { 1, 1 }, cdims[2] = { 1, 1 };
+	int ret = -1;
+
+	if (space < 0 || type < 0 || dcpl < 0)
+		goto out;
+
+	job->rank = H5Sget_simple_extent_ndims(space);
+	if (job->rank < 1 || job->rank > 2 || H5Tget_class(type) != H5T_INTEGER)
+		goto out;
+	H5Sget_simple_extent_dims(space, dims, NULL);
+
+	/* A vector: at most one dimension longer than one */
+	job->axis = (job->rank == 2 && dims[0] == 1) ? 1 : 0;
+	if (job->rank == 2 && dims[0] != 1 && dims[1] != 1)
+		goto out;
+	job->n = (size_t)dims[job->axis];
+
+	job->esize = H5Tget_size(type);
+	job->is_signed = H5Tget_sign(type) == H5T_SGN_2;
+	ret = 0;
+
+	if ((job->esize != 1 && job->esize != 2 && job->esize != 4 && job->esize != 8) ||
+	    H5Tget_order(type) != H5Tget_order(H5T_NATIVE_UINT32) ||
+	    H5Pget_layout(dcpl) != H5D_CHUNKED ||
+	    H5Pget_chunk(dcpl, job->rank, cdims) != job->rank ||
+	    (job->rank == 2 && cdims[!job->axis] != 1))
+		goto out;
+
+	job->chunk = (size_t)cdims[job->axis];
+	job->nchunks = job->chunk ? (job->n + job->chunk - 1) / job->chunk : 0;
+	job->shuffle_bit = job->deflate_bit = -1;
+
+	int nfilters = H5Pget_nfilters(dcpl);
+	for (int i = 0; i < nfilters; i++) {
+		unsigned int flags;
+		size_t nelmts = 0;
+		H5Z_filter_t f = H5Pget_filter2(dcpl, (unsigned int)i, &flags, &nelmts,
+		                                NULL, 0, NULL, NULL);
+		if (f == H5Z_FILTER_SHUFFLE && job->deflate_bit < 0)
+			job->shuffle_bit = i;
+		else if (f == H5Z_FILTER_DEFLATE)
+			job->deflate_bit = i;
+		else
+			goto out;
+	}
+
+	ret = job->chunk > 0;
+
+out:
+	if (space >= 0) H5Sclose(space);
+	if (type >= 0)  H5Tclose(type);
+	if (dcpl >= 0)  H5Pclose(dcpl);
+	return ret;
+}
+
+/**
+ * @brief Reads an integer vector dataset into a new array of @p width-byte
+ *        unsigned entries.
+ *
+ * @param file Open file
+ * @param path Dataset path
+ * @param width Output entry width (4 or 8)
+ * @param max Largest value representable in the output
+ * @param n_threads Number of threads
+ * @param count Output: number of entries
+ * @param err Output: error message on failure
+ * @return Newly allocated array, or NULL on error
+ */
+static void *
+read_index(hid_t file, const char *path, size_t width, uint64_t max,
+           unsigned int n_threads, size_t *count, const char **err)
+{
+	h5_job_t job = { .width = width, .max = max };
+
+	job.dset = H5Dopen2(file, path, H5P_DEFAULT);
+	if (job.dset < 0) {
+		*err = "sparse index dataset not found";
+		return NULL;
+	}
+
+	int chunked = inspect_dataset(&job);
+	if (chunked < 0) {
+		*err = "sparse index dataset is not an integer vector";
+		H5Dclose(job.dset);
+		return NULL;
+	}
+
+	/* +1: malloc(0) may return NULL for an empty dataset */
+	job.dst = malloc(job.n * width + 1);
+	job.scratch = calloc(n_threads, sizeof(uint8_t *));
+	if (!job.dst || !job.scratch) {
+		job_fail(&job, "malloc failed");
+		goto out;
+	}
+
+	if (!chunked) {
+		/* Contiguous or other filters: let HDF5 convert while reading */
+		hid_t mem = width == 4 ? H5T_NATIVE_UINT32 : H5T_NATIVE_UINT64;
+		if (job.n && H5Dread(job.dset, mem, H5S_ALL, H5S_ALL, H5P_DEFAULT, job.dst) < 0)
+			job_fail(&job, "H5Dread failed");
+		goto out;
+	}
+
+	read_batch(&job, &job.batch[0]);
+	job.cur = 0;
+
+	while (!job.error && job.batch[job.cur].count > 0) {
+		job.claim = 0;
+		job.batch[!job.cur].count = 0;
+		par_run(n_threads, chunk_worker, &job);
+		job.cur = !job.cur;
+	}
+
+out:
+	for (int i = 0; i < 2; i++) {
+		free(job.batch[i].raw);
+		free(job.batch[i].off);
+		free(job.batch[i].mask);
+	}
+	if (job.scratch) {
+		for (unsigned int t = 0; t < n_threads; t++)
+			free(job.scratch[t]);
+		free(job.scratch);
+	}
+	H5Dclose(job.dset);
+
+	if (job.error) {
+		*err = job.err;
+		free(job.dst);
+		return NULL;
+	}
+
+	*count = job.n;
+	return job.dst;
+}
+
+/**
+ * @struct check_job_t
+ * @brief Parallel range check of the row indices.
+ */
+typedef struct {
+	const csc_idx_t *ir;
+	size_t nnz;
+	size_t nrows;
+	int bad;
+} check_job_t;
+
+static void
+check_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	check_job_t *job = arg;
+	size_t begin = par_block_begin(job->nnz, n_threads, tid);
+	size_t end   = par_block_begin(job->nnz, n_threads, tid + 1);
+
+	for (size_t k = begin; k < end; k++) {
+		if (job->ir[k] >= job->nrows) {
+			__atomic_store_n(&job->bad, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc mat73_probe()
+ */
+int
+mat73_probe(const char *filename)
+{
+	uint8_t h[128];
+	FILE *f = fopen(filename, "rb");
+
+	if (!f)
+		return 0;
+
+	size_t got = fread(h, 1, sizeof(h), f);
+	fclose(f);
+	if (got != sizeof(h))
+		return 0;
+
+	uint16_t version, endian;
+	memcpy(&version, h + 124, 2);
+	memcpy(&endian, h + 126, 2);
+	if (version != MAT73_VERSION || endian != MAT73_ENDIAN)
+		return 0;
+
+	/* Silence HDF5's own error stack printing while probing */
+	H5E_auto2_t func;
+	void *data;
+	H5Eget_auto2(H5E_DEFAULT, &func, &data);
+	H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+	htri_t is_hdf5 = H5Fis_hdf5(filename);
+	H5Eset_auto2(H5E_DEFAULT, func, data);
+
+	return is_hdf5 > 0;
+}
+
+/**
+ * @copydoc mat73_read_pattern()
+ */
+int
+mat73_read_pattern(const char *filename, const char *group,
+                   unsigned int n_threads, size_t *nrows, size_t *ncols,
+                   size_t *nnz, csc_ptr_t **col_ptr, csc_idx_t **row_idx)
+{
+	const char *err = NULL;
+	csc_ptr_t *jc = NULL;
+	csc_idx_t *ir = NULL;
+	size_t njc = 0, nir = 0;
+	uint64_t rows = 0;
+	char path[512];
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+
+	H5E_auto2_t func;
+	void *data;
+	H5Eget_auto2(H5E_DEFAULT, &func, &data);
+	H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+	hid_t file = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+	if (file < 0) {
+		err = "failed to open HDF5 file";
+		goto out;
+	}
+
+	/* Number of rows: the MATLAB_sparse attribute of the group */
+	hid_t attr = H5Aopen_by_name(file, group, "MATLAB_sparse", H5P_DEFAULT, H5P_DEFAULT);
+	if (attr < 0) {
+		err = "sparse matrix group not found";
+		goto out;
+	}
+	herr_t st = H5Aread(attr, H5T_NATIVE_UINT64, &rows);
+	H5Aclose(attr);
+	if (st < 0 || rows > CSC_IDX_MAX) {
+		err = st < 0 ? "cannot read MATLAB_sparse attribute"
+		             : "matrix exceeds the index width of this build (see make INDEX=)";
+		goto out;
+	}
+
+	snprintf(path, sizeof(path), "%s/jc", group);
+	if (!(jc = read_index(file, path, sizeof(csc_ptr_t), CSC_PTR_MAX, n_threads, &njc, &err)))
+		goto out;
+
+	if (njc == 0 || jc[0] != 0) {
+		err = "corrupt sparse column pointers";
+		goto out;
+	}
+	for (size_t j = 0; j + 1 < njc; j++) {
+		if (jc[j + 1] < jc[j]) {
+			err = "corrupt sparse column pointers";
+			goto out;
+		}
+	}
+
+	/* An empty matrix may have no ir dataset */
+	snprintf(path, sizeof(path), "%s/ir", group);
+	if (jc[njc - 1] == 0 && H5Lexists(file, path, H5P_DEFAULT) <= 0) {
+		ir = malloc(1);
+		if (!ir)
+			err = "malloc failed";
+	} else {
+		ir = read_index(file, path, sizeof(csc_idx_t), CSC_IDX_MAX, n_threads, &nir, &err);
+	}
+	if (!ir)
+		goto out;
+
+	if (jc[njc - 1] > nir) {
+		err = "corrupt sparse column pointers";
+		goto out;
+	}
+
+	check_job_t check = { .ir = ir, .nnz = jc[njc - 1], .nrows = rows };
+	par_run(n_threads, check_worker, &check);
+	if (check.bad)
+		err = "sparse row index out of range";
+
+	/* ir may hold nzmax slots; give back the unused tail */
+	if (!err && check.nnz < nir) {
+		csc_idx_t *shrunk = realloc(ir, check.nnz * sizeof(csc_idx_t) + 1);
+		if (shrunk)
+			ir = shrunk;
+	}
+
+out:
+	if (file >= 0)
+		H5Fclose(file);
+	H5Eset_auto2(H5E_DEFAULT, func, data);
+
+	if (err) {
+		print_error(__func__, err, 0);
+		free(jc);
+		free(ir);
+		return -1;
+	}
+
+	*nrows   = (size_t)rows;
+	*ncols   = njc - 1;
+	*nnz     = jc[njc - 1];
+	*col_ptr = jc;
+	*row_idx = ir;
+	return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file mat73.h
+ * @brief Chunked, parallel reader for MATLAB v7.3 (HDF5) .mat files.
+ *
+ * A v7.3 file is an HDF5 file behind a 512-byte user block holding the
+ * usual MATLAB header. A sparse matrix `Problem.A` is the group
+ * `/Problem/A` with a `MATLAB_sparse` attribute (the number of rows) and
+ * the datasets `ir`, `jc` and `data`. Only `jc` and `ir` are read.
+ *
+ * Chunked datasets whose filters are limited to shuffle and deflate (what
+ * MATLAB writes) are read with direct chunk reads: the calling thread
+ * fetches the raw, still compressed chunks from the file in batches while
+ * the other threads inflate, unshuffle and convert the previous batch
+ * straight into the CSC arrays. Decoding scales with the thread count and
+ * overlaps I/O, so large inputs are bounded by the read bandwidth. Other
+ * layouts fall back to a plain H5Dread().
+ *
+ * Only compiled with `make HDF5=1` (defines USE_HDF5).
+ */
+
+#ifndef MAT73_H
+#define MAT73_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+/**
+ * @brief Checks whether a file is a MATLAB v7.3 (HDF5) .mat file.
+ *
+ * @param filename Path to the .mat file
+ * @return 1 for a v7.3 file, 0 otherwise (including when it cannot be read)
+ */
+int mat73_probe(const char *filename);
+
+/**
+ * @brief Reads the sparsity pattern of a sparse matrix from a v7.3 file.
+ *
+ * @param filename Path to the .mat file
+ * @param group Path of the sparse matrix group (e.g. "/Problem/A")
+ * @param n_threads Number of threads (0 uses every online CPU)
+ * @param nrows Output: number of rows
+ * @param ncols Output: number of columns
+ * @param nnz Output: number of stored entries
+ * @param col_ptr Output: newly allocated column pointers (ncols + 1)
+ * @param row_idx Output: newly allocated row indices (nnz)
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mat73_read_pattern(const char *filename, const char *group,
+                       unsigned int n_threads, size_t *nrows, size_t *ncols,
+                       size_t *nnz, csc_ptr_t **col_ptr, csc_idx_t **row_idx);
+
+#endif /* MAT73_H */
@@ -5,14 +5,24 @@
  * This module implements loading, storing, and printing of binary sparse
  * matrices in CSC format. Two input formats are supported:
  *
- * - **MAT files (.mat)** using MATIO, expecting a struct `Problem.A`
- *   containing a MATLAB sparse matrix.
+ * - **MAT files (.mat)** expecting a struct `Problem.A` containing a
+ *   MATLAB sparse matrix. Level 5 files are streamed by a pattern-only
+ *   reader (see mat5.h), v7.3 files are read in parallel chunks when built
+ *   with HDF5=1 (see mat73.h); anything else goes through MATIO.
  *
- * - **Matrix Market files (.mtx)** in `coordinate` or `array` format.
+ * - **Matrix Market files (.mtx)** in `coordinate` or `array` format,
+ *   parsed in parallel from a memory mapping (see mtx.h). Compressed
+ *   files (.gz, .xz, .zst) are decompressed on a dedicated thread and
+ *   parsed block by block as the text arrives (see instream.h).
+ *
+ * - **Native binary files (.csc)**, mapped directly into memory without
+ *   any parsing or copying (see cscbin.h).
  *
  * Only binary matrices are represented. Any non-zero numeric values in
  * the input are treated as 1.
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include <ctype.h>
 #include <errno.h>
 #include <math.h>
@@ -20,9 +30,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "matrix.h"
+#include "cscbin.h"
+#include "coo.h"
+#include "instream.h"
+#include "mat5.h"
+#ifdef USE_HDF5
+#include "mat73.h"
+#endif
+#include "mtx.h"
+#include "normalize.h"
+#include "mem.h"
+#include "packed.h"
+#include "parallel.h"
 #include "error.h"
+#include "timer.h"
 
 /* ------------------------------------------------------------------------- */
 /*                            Static Helper Functions                        */
@@ -45,20 +70,100 @@ num_digits(int n)
 	return (int)log10(n) + 1;
 }
 
+/**
+ * @brief Load the sparsity pattern of `Problem.A` with one of the native
+ *        .mat readers.
+ *
+ * Only the ir/jc index arrays are decoded, straight into the matrix's own
+ * arrays; the value array is never read (see mat5.h and mat73.h).
+ *
+ * @param filename Path to the .mat file.
+ * @param v73 1 for a v7.3 (HDF5) file, 0 for a Level 5 file.
+ * @param n_threads Number of threads for the v7.3 reader.
+ * @return Newly allocated CSCBinaryMatrix on success, NULL on error.
+ */
+static CSCBinaryMatrix*
+csc_load_matrix_mat_pattern(const char *filename, int v73, unsigned int n_threads)
+{
+	double t_parse = now_sec();
+	struct stat st;
+
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
+		print_error(__func__, "malloc() failed", errno);
+		return NULL;
+	}
+
+#ifdef USE_HDF5
+	int err = v73
+		? mat73_read_pattern(filename, "/Problem/A", n_threads, &m->nrows,
+		                     &m->ncols, &m->nnz, &m->col_ptr, &m->row_idx)
+		: mat5_read_pattern(filename, "Problem", "A", &m->nrows, &m->ncols,
+		                    &m->nnz, &m->col_ptr, &m->row_idx);
+#else
+	(void)v73;
+	(void)n_threads;
+	int err = mat5_read_pattern(filename, "Problem", "A", &m->nrows, &m->ncols,
+	                            &m->nnz, &m->col_ptr, &m->row_idx);
+#endif
+
+	if (err) {
+		free(m);
+		return NULL;
+	}
+
+	if (m->nrows != m->ncols) {
+		print_error(__func__, "invalid matrix dimensions", 0);
+		free(m->col_ptr);
+		free(m->row_idx);
+		free(m);
+		return NULL;
+	}
+
+	m->half = 0;
+	memset(&m->load, 0, sizeof(m->load));
+	m->load.input_bytes = (stat(filename, &st) == 0) ? (size_t)st.st_size : 0;
+	m->map_base = NULL;
+	m->map_size = 0;
+	m->packed = NULL;
+	m->perm = NULL;
+	m->normalized = 0;
+	m->mirrored = 0;
+	memset(&m->mem, 0, sizeof(m->mem));
+	/* The reader interleaves I/O and inflation: all of it counts as parsing */
+	m->load.parse_time_s = now_sec() - t_parse;
+
+	return m;
+}
+
 /**
  * @brief Load a CSC matrix from a MATLAB .mat file.
  *
  * Expects a struct named "Problem" with a sparse matrix field "A".
- * The matrix must be 2-D, real-valued, and stored in MATLAB sparse format.
+ * The matrix must be 2-D and stored in MATLAB sparse format.
+ *
+ * Level 5 files (v5/v7), and v7.3 files in HDF5=1 builds, are read by
+ * csc_load_matrix_mat_pattern(), which skips the value array. MATIO
+ * handles the rest and requires a real-valued matrix.
  *
  * @param filename Path to the .mat file.
+ * @param opts Loader options.
  * @return Newly allocated CSCBinaryMatrix on success, NULL on error.
  */
 static CSCBinaryMatrix*
-csc_load_matrix_mat(const char *filename)
+csc_load_matrix_mat(const char *filename, const CSCLoadOptions *opts)
 {
 	const char matrix_name[] = "Problem";
 	const char field_name[]  = "A";
+	double t_parse = now_sec();
+	struct stat st;
+
+	if (mat5_probe(filename))
+		return csc_load_matrix_mat_pattern(filename, 0, opts->n_threads);
+#ifdef USE_HDF5
+	if (mat73_probe(filename))
+		return csc_load_matrix_mat_pattern(filename, 1, opts->n_threads);
+#endif
 
 	mat_t *matfp = Mat_Open(filename, MAT_ACC_RDONLY);
 	if (!matfp) {
@@ -106,12 +211,32 @@ csc_load_matrix_mat(const char *filename)
 
 	mat_sparse_t *s = (mat_sparse_t*)field->data;
 
+	size_t nnz = s->jc[field->dims[1]];
+
+	if (field->dims[0] > CSC_IDX_MAX || nnz > CSC_PTR_MAX) {
+		print_error(__func__, "matrix exceeds the index width of this build (see make INDEX=)", 0);
+		free(m);
+		Mat_VarFree(Problem);
+		Mat_Close(matfp);
+		return NULL;
+	}
+
+	m->half  = 0;
 	m->nrows = field->dims[0];
 	m->ncols = field->dims[1];
-	m->nnz   = s->jc[m->ncols];
-
-	m->row_idx = malloc(sizeof(uint32_t) * m->nnz);
-	m->col_ptr = malloc(sizeof(uint32_t) * (m->ncols + 1));
+	m->nnz   = nnz;
+	memset(&m->load, 0, sizeof(m->load));
+	m->load.input_bytes = (stat(filename, &st) == 0) ? (size_t)st.st_size : 0;
+	m->map_base = NULL;
+	m->map_size = 0;
+	m->packed = NULL;
+	m->perm = NULL;
+	m->normalized = 0;
+	m->mirrored = 0;
+	memset(&m->mem, 0, sizeof(m->mem));
+
+	m->row_idx = malloc(sizeof(csc_idx_t) * m->nnz);
+	m->col_ptr = malloc(sizeof(csc_ptr_t) * (m->ncols + 1));
 
 	if (!m->row_idx || !m->col_ptr) {
 		print_error(__func__, "malloc() failed", errno);
@@ -121,41 +246,18 @@ csc_load_matrix_mat(const char *filename)
 		return NULL;
 	}
 
-	memcpy(m->row_idx, s->ir, m->nnz * sizeof(uint32_t));
-	memcpy(m->col_ptr, s->jc, (m->ncols + 1) * sizeof(uint32_t));
+	/* Element-wise: matio's ir/jc width need not match csc_idx_t/csc_ptr_t */
+	for (size_t k = 0; k < m->nnz; k++)
+		m->row_idx[k] = (csc_idx_t)s->ir[k];
+	for (size_t j = 0; j <= m->ncols; j++)
+		m->col_ptr[j] = (csc_ptr_t)s->jc[j];
 
 	Mat_VarFree(Problem);
 	Mat_Close(matfp);
 
-	return m;
-}
+	m->load.parse_time_s = now_sec() - t_parse;
 
-/**
- * @brief Skip comments and blank lines in a Matrix Market file.
- *
- * Advances the file cursor until the next non-comment, non-empty line.
- *
- * @param f Open file pointer.
- * @return Always 0.
- */
-static int
-mm_skip_comments(FILE *f)
-{
-	long pos;
-	int c;
-
-	while (1) {
-		pos = ftell(f);
-		c = fgetc(f);
-		if (c == '%') {          /* comment line */
-			while ((c = fgetc(f)) != '\n' && c != EOF);
-			continue;
-		} else if (isspace(c)) { /* blank line */
-			continue;
-		}
-		fseek(f, pos, SEEK_SET);
-		return 0;
-	}
+	return m;
 }
 
 /**
@@ -164,181 +266,121 @@ mm_skip_comments(FILE *f)
  * Supports the following formats:
  *
  * - coordinate or array
- * - pattern or real-valued
+ * - pattern, integer, real or complex valued
  * - general, symmetric, skew-symmetric, hermitian
  *
- * Only non-zero entries are stored (binary interpretation).
+ * Only non-zero entries are stored (binary interpretation). The file is
+ * memory-mapped and tokenized in parallel (see mtx.h). With
+ * CSC_BUILD_TWO_PASS the CSC arrays are built directly from the file
+ * instead of going through COO staging arrays.
+ *
+ * Compressed files are streamed instead: one thread decompresses while
+ * the remaining ones parse, and since the text can only be read once
+ * they always go through COO staging arrays.
  *
- * @param filename Path to the .mtx file.
+ * @param filename Path to the .mtx file, possibly compressed.
+ * @param opts Loader options.
  * @return Newly allocated CSCBinaryMatrix on success, NULL on error.
  */
 static CSCBinaryMatrix*
-csc_load_matrix_mtx(const char *filename)
+csc_load_matrix_mtx(const char *filename, const CSCLoadOptions *opts)
 {
-	FILE *f = fopen(filename, "r");
-	if (!f) {
-		print_error(__func__, "failed to open .mtx file", errno);
-		return NULL;
-	}
-
-	/* --- Header -------------------------------------------------------- */
-	char format[64], field[64], symmetry[64];
-
-	if (fscanf(f, "%%%%MatrixMarket matrix %63s %63s %63s",
-				format, field, symmetry) != 3)
-	{
-		print_error(__func__, "invalid MatrixMarket header", 0);
-		fclose(f);
-		return NULL;
-	}
-
-	int is_coordinate = (strcmp(format, "coordinate") == 0);
-	//int is_array      = (strcmp(format, "array") == 0);
-
-	int is_pattern = (strcmp(field, "pattern") == 0);
-
-	int symmetric   = (strcmp(symmetry, "symmetric") == 0);
-	int skew        = (strcmp(symmetry, "skew-symmetric") == 0);
-	int hermitian   = (strcmp(symmetry, "hermitian") == 0);
-	int general     = (strcmp(symmetry, "general") == 0);
-
-	if (!general && !symmetric && !skew && !hermitian) {
-		print_error(__func__, "unsupported symmetry", 0);
-		fclose(f);
-		return NULL;
-	}
-
-	/* --- Sizes --------------------------------------------------------- */
-	mm_skip_comments(f);
-
-	size_t nrows, ncols, nnz;
-	if (is_coordinate) {
-		if (fscanf(f, "%zu %zu %zu", &nrows, &ncols, &nnz) != 3) {
-			print_error(__func__, "invalid size line", 0);
-			fclose(f);
+	MtxFile mf;
+	csc_idx_t *coo_i = NULL;
+	csc_idx_t *coo_j = NULL;
+	size_t count = 0;
+	unsigned int n_threads = opts->n_threads ? opts->n_threads : par_num_cpus();
+	unsigned int parse_threads = n_threads;
+	CSCBuildMode build = opts->build;
+	InStreamFormat fmt = instream_format(filename);
+	InStream *in = NULL;
+	double t_open = now_sec();
+
+	if (fmt != INSTREAM_NONE) {
+		in = instream_open(filename, fmt);
+		if (!in)
 			return NULL;
-		}
-	} else { /* array */
-		if (fscanf(f, "%zu %zu", &nrows, &ncols) != 2) {
-			print_error(__func__, "invalid array size line", 0);
-			fclose(f);
+		if (mtx_open_stream(in, &mf) != 0) {
+			instream_close(in);
 			return NULL;
 		}
-		nnz = nrows * ncols; /* will filter zeroes later */
+		/* The decompressor thread takes one of the loader's threads */
+		parse_threads = n_threads > 1 ? n_threads - 1 : 1;
+		build = CSC_BUILD_COO;
+	} else if (mtx_open(filename, &mf) != 0) {
+		return NULL;
 	}
 
-	/* Allocate temporary COO arrays */
-	size_t max_nnz = nnz * (symmetric ? 2 : 1) + 5;
-	uint32_t *coo_i = malloc(max_nnz * sizeof(uint32_t));
-	uint32_t *coo_j = malloc(max_nnz * sizeof(uint32_t));
-	if (!coo_i || !coo_j) {
+	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
+	if (!m) {
 		print_error(__func__, "malloc failed", errno);
-		fclose(f);
-		free(coo_i); free(coo_j);
+		mtx_close(&mf);
+		instream_close(in);
 		return NULL;
 	}
 
-	size_t count = 0;
+	/* Half storage: keep the file's triangle instead of mirroring it */
+	m->half = opts->half && mf.symmetric;
+	if (m->half)
+		mf.symmetric = 0;
+
+	m->nrows = mf.nrows;
+	m->ncols = mf.ncols;
+	m->row_idx = NULL;
+	m->col_ptr = NULL;
+	memset(&m->load, 0, sizeof(m->load));
+	m->load.input_bytes = mf.size;
+	m->load.io_time_s = now_sec() - t_open;
+	m->map_base = NULL;
+	m->map_size = 0;
+	m->packed = NULL;
+	m->perm = NULL;
+	m->normalized = 0;
+	/* The readers store every off-diagonal entry of a symmetric file twice */
+	m->mirrored = mf.symmetric;
+	memset(&m->mem, 0, sizeof(m->mem));
 
 	/* --- Read entries -------------------------------------------------- */
-	if (is_coordinate) {
-		/* i j [value] */
-		for (size_t k = 0; k < nnz; k++) {
-			size_t i, j;
-			double val = 1.0;
-
-			if (is_pattern) {
-				if (fscanf(f, "%zu %zu", &i, &j) != 2) {
-					print_error(__func__, "bad coordinate entry", 0);
-					goto fail;
-				}
-			} else {
-				if (fscanf(f, "%zu %zu %lf", &i, &j, &val) != 3) {
-					print_error(__func__, "bad coordinate entry", 0);
-					goto fail;
-				}
-			}
+	double t_parse = now_sec();
+	int err;
 
-			if (val != 0.0) {
-				coo_i[count] = i - 1;
-				coo_j[count] = j - 1;
-				count++;
+	if (build == CSC_BUILD_TWO_PASS)
+		err = mtx_read_csc(&mf, parse_threads, &m->col_ptr, &m->row_idx, &count);
+	else
+		err = mtx_read_coo(&mf, parse_threads, &coo_i, &coo_j, &count);
 
-				if (symmetric && i != j) {
-					coo_i[count] = j - 1;
-					coo_j[count] = i - 1;
-					count++;
-				}
-			}
-		}
-	}
-	else {
-		/* array: dense stored column-major */
-		for (size_t j = 0; j < ncols; j++) {
-			for (size_t i = 0; i < nrows; i++) {
-				double val;
-				if (fscanf(f, "%lf", &val) != 1)
-					goto fail;
-
-				if (val != 0.0) {
-					coo_i[count] = i;
-					coo_j[count] = j;
-					count++;
-				}
-			}
-		}
-	}
-
-	fclose(f);
-
-	/* --- Convert COO → CSC binary -------------------------------------- */
-	CSCBinaryMatrix *m = malloc(sizeof(CSCBinaryMatrix));
-	if (!m) goto fail;
-
-	m->nrows = nrows;
-	m->ncols = ncols;
-	m->nnz   = count;
-
-	m->row_idx = malloc(count * sizeof(uint32_t));
-	m->col_ptr = malloc((ncols + 1) * sizeof(uint32_t));
+	m->nnz = count;
+	mtx_close(&mf);
 
-	if (!m->row_idx || !m->col_ptr) {
-		print_error(__func__, "malloc failed", errno);
-		csc_free_matrix(m);
-		goto fail;
+	/* Streams report the decompressed text that was parsed */
+	if (in) {
+		m->load.input_bytes = instream_bytes(in);
+		instream_close(in);
 	}
 
-	/* count entries per column */
-	memset(m->col_ptr, 0, (ncols + 1) * sizeof(uint32_t));
-
-	for (size_t k = 0; k < count; k++)
-		m->col_ptr[coo_j[k] + 1]++;
-
-	for (size_t j = 0; j < ncols; j++)
-		m->col_ptr[j+1] += m->col_ptr[j];
-
-	/* fill rows */
-	uint32_t *col_fill = calloc(ncols, sizeof(uint32_t));
-	if (!col_fill) goto fail2;
+	if (err)
+		goto fail;
 
-	for (size_t k = 0; k < count; k++) {
-		uint32_t j = coo_j[k];
-		uint32_t dest = m->col_ptr[j] + col_fill[j];
-		m->row_idx[dest] = coo_i[k];
-		col_fill[j]++;
-	}
+	/* Two-pass mode scatters into the CSC arrays while it parses */
+	m->load.parse_time_s = now_sec() - t_parse;
+	if (build == CSC_BUILD_TWO_PASS)
+		return m;
 
-	free(col_fill);
+	/* --- Convert COO → CSC binary -------------------------------------- */
+	double t_build = now_sec();
+	err = coo_to_csc(coo_i, coo_j, count, m->ncols, n_threads, &m->col_ptr, &m->row_idx);
 	free(coo_i);
 	free(coo_j);
+	coo_i = coo_j = NULL;
 
-	return m;
+	if (err)
+		goto fail;
 
-fail2:
-	csc_free_matrix(m);    
+	m->load.build_time_s = now_sec() - t_build;
+	return m;
 
 fail:
-	fclose(f);
+	csc_free_matrix(m);
 	free(coo_i);
 	free(coo_j);
 	return NULL;
@@ -373,11 +415,13 @@ ext_is(const char *filename, const char *ext)
 /* ------------------------------------------------------------------------- */
 
 /**
- * @brief Load a sparse binary matrix from a .mat or .mtx file.
+ * @brief Load a sparse binary matrix from a .mat, .mtx or .csc file.
  *
  * Automatically dispatches to:
- * - csc_load_matrix_mtx() if the file ends in ".mtx"
+ * - csc_load_matrix_mtx() if the file ends in ".mtx", or in ".gz", ".xz"
+ *   or ".zst" (compressed Matrix Market)
  * - csc_load_matrix_mat() if the file ends in ".mat"
+ * - cscbin_load() if the file ends in ".csc"
  *
  * @param path Path to the matrix file.
  * @return Newly allocated CSCBinaryMatrix, or NULL on failure.
@@ -385,21 +429,82 @@ ext_is(const char *filename, const char *ext)
 CSCBinaryMatrix*
 csc_load_matrix(const char *path)
 {
-	if (ext_is(path, "mtx")) {
-		return csc_load_matrix_mtx(path);
+	return csc_load_matrix_opts(path, NULL);
+}
+
+/**
+ * @brief Load a sparse binary matrix with explicit loader options.
+ *
+ * With opts->normalize set, the loaded matrix is normalized (see
+ * normalize.h) before it is returned. Its col_ptr and row_idx then move to
+ * pages allocated under opts->mem (see mem.h), once every pass that
+ * rebuilds them is done.
+ *
+ * @param path Path to the matrix file.
+ * @param opts Loader options (NULL for defaults).
+ * @return Newly allocated CSCBinaryMatrix, or NULL on failure.
+ */
+CSCBinaryMatrix*
+csc_load_matrix_opts(const char *path, const CSCLoadOptions *opts)
+{
+	static const CSCLoadOptions defaults = { 0 };
+
+	if (!opts)
+		opts = &defaults;
+
+	CSCBinaryMatrix *m = NULL;
+	double t_load = now_sec();
+
+	if (ext_is(path, "mtx") || instream_format(path) != INSTREAM_NONE) {
+		m = csc_load_matrix_mtx(path, opts);
 	}
 	else if (ext_is(path, "mat")) {
-		return csc_load_matrix_mat(path);
+		m = csc_load_matrix_mat(path, opts);
+	}
+	else if (ext_is(path, "csc")) {
+		m = cscbin_load(path);
 	} else {
 		print_error(__func__, "Unrecognized matrix file extention", 0);
 	}
-	
-	return NULL;
+
+	if (m)
+		m->load.load_time_s = now_sec() - t_load;
+
+	if (m && opts->normalize && csc_normalize_matrix(m, opts->n_threads) != 0) {
+		csc_free_matrix(m);
+		return NULL;
+	}
+
+	if (m && csc_mem_place(m, &opts->mem, opts->n_threads) != 0) {
+		csc_free_matrix(m);
+		return NULL;
+	}
+
+	return m;
+}
+
+/**
+ * @brief Save a sparse binary matrix in the native binary .csc format.
+ *
+ * @param m Matrix to save.
+ * @param path Output path (must end in ".csc").
+ * @return 0 on success, -1 on failure.
+ */
+int
+csc_save_matrix(const CSCBinaryMatrix *m, const char *path)
+{
+	if (!ext_is(path, "csc")) {
+		print_error(__func__, "output file must have a .csc extension", 0);
+		return -1;
+	}
+
+	return cscbin_save(m, path);
 }
 
 /**
  * @brief Free a CSCBinaryMatrix and its associated memory.
  *
+ * Matrices backed by a file mapping are unmapped instead of freed.
  * Safe to call with NULL.
  *
  * @param m CSC matrix to free.
@@ -410,13 +515,22 @@ csc_free_matrix(CSCBinaryMatrix *m)
 	if (!m)
 		return;
 
+	csc_packed_free(m->packed);
+	free(m->perm);
+
+	if (m->map_base) {
+		munmap(m->map_base, m->map_size);
+		free(m);
+		return;
+	}
+
 	if(m->row_idx){
-		free(m->row_idx);
+		mem_free(m->row_idx, &m->mem);
 		m->row_idx = NULL;
 	}
 
 	if(m->col_ptr){
-		free(m->col_ptr);
+		mem_free(m->col_ptr, &m->mem);
 		m->col_ptr = NULL;
 	}
 
@@ -446,7 +560,7 @@ csc_print_matrix(CSCBinaryMatrix *m)
 
 	for (size_t i = 0; i < m->ncols; i++) {
 		for(size_t j = m->col_ptr[i]; j < m->col_ptr[i+1]; j++) {
-			printf("(%*d,%*d)", di, m->row_idx[j] + 1, dj, (int) i + 1);
+			printf("(%*zu,%*zu)", di, (size_t)m->row_idx[j] + 1, dj, i + 1);
 
 			if (nline < maxline) {
 				printf(" ");
@@ -461,3 +575,18 @@ csc_print_matrix(CSCBinaryMatrix *m)
 
 	printf("\n");
 }
+
+/**
+ * @brief qsort() comparator for arrays of csc_idx_t, in ascending order.
+ *
+ * @param a Pointer to the first index.
+ * @param b Pointer to the second index.
+ * @return Negative, zero or positive as *a is below, equal to or above *b.
+ */
+int
+csc_idx_cmp(const void *a, const void *b)
+{
+	csc_idx_t x = *(const csc_idx_t *)a;
+	csc_idx_t y = *(const csc_idx_t *)b;
+	return (x > y) - (x < y);
+}
@@ -12,6 +12,106 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/*
+ * Index widths are fixed at compile time so every kernel is specialized for
+ * one combination (see `make INDEX=...`):
+ *
+ * | Flags                   | csc_ptr_t | csc_idx_t | Limits                   |
+ * |-------------------------|-----------|-----------|--------------------------|
+ * | (none)                  | 32-bit    | 32-bit    | nnz, nrows, ncols < 2^32 |
+ * | -DCSC_PTR64             | 64-bit    | 32-bit    | nrows, ncols < 2^32      |
+ * | -DCSC_IDX64             | 64-bit    | 64-bit    | none in practice         |
+ */
+#if defined(CSC_IDX64) && !defined(CSC_PTR64)
+#define CSC_PTR64
+#endif
+
+#ifdef CSC_PTR64
+typedef uint64_t csc_ptr_t;   /**< Column pointer / edge offset type */
+#define CSC_PTR_MAX UINT64_MAX
+#else
+typedef uint32_t csc_ptr_t;   /**< Column pointer / edge offset type */
+#define CSC_PTR_MAX UINT32_MAX
+#endif
+
+#ifdef CSC_IDX64
+typedef uint64_t csc_idx_t;   /**< Row / column (vertex) index type */
+#define CSC_IDX_MAX UINT64_MAX
+#else
+typedef uint32_t csc_idx_t;   /**< Row / column (vertex) index type */
+#define CSC_IDX_MAX UINT32_MAX
+#endif
+
+/**
+ * @struct CSCLoadStats
+ * @brief Measurements taken while loading and preprocessing a matrix.
+ */
+typedef struct {
+	size_t input_bytes;   /**< Size of the parsed input in bytes (decompressed for .gz/.xz/.zst) */
+	double load_time_s;   /**< Wall time of the whole csc_load_matrix_opts() call, normalization aside */
+	double io_time_s;     /**< Wall time spent opening/mapping the file and reading its header */
+	double parse_time_s;  /**< Wall time spent tokenizing or decoding the entries */
+	double build_time_s;  /**< Wall time spent converting COO staging arrays to CSC */
+	double reorder_time_s;/**< Wall time spent renumbering vertices (see reorder.h) */
+	double normalize_time_s;   /**< Wall time spent normalizing (see normalize.h) */
+	double pack_time_s;        /**< Wall time spent compressing row indices (see packed.h) */
+	double place_time_s;       /**< Wall time spent moving the arrays to placed pages (see mem.h) */
+	size_t duplicates_removed; /**< Repeated (i,j) entries dropped by normalization */
+	size_t self_loops_removed; /**< Diagonal entries dropped by normalization */
+} CSCLoadStats;
+
+/**
+ * @enum CSCBuildMode
+ * @brief How text inputs (.mtx) are turned into CSC arrays.
+ */
+typedef enum {
+	CSC_BUILD_COO = 0,  /**< Stage COO arrays, then convert (fastest, ~3x peak memory) */
+	CSC_BUILD_TWO_PASS  /**< Count column degrees, then scatter rows (peak memory = CSC size) */
+} CSCBuildMode;
+
+/**
+ * @enum CSCNumaPolicy
+ * @brief Where the pages of the large per-matrix arrays live (see mem.h).
+ */
+typedef enum {
+	CSC_NUMA_NONE = 0,     /**< Plain malloc(): pages land wherever they are first written */
+	CSC_NUMA_LOCAL,        /**< Fresh pages, first written in parallel by the threads that use them */
+	CSC_NUMA_INTERLEAVE    /**< Fresh pages spread round-robin over every online node */
+} CSCNumaPolicy;
+
+/**
+ * @enum CSCHugePolicy
+ * @brief Page size of the large per-matrix arrays (see mem.h).
+ */
+typedef enum {
+	CSC_HUGE_NONE = 0,     /**< Base pages */
+	CSC_HUGE_THP,          /**< 2 MB-aligned, madvise(MADV_HUGEPAGE): transparent huge pages */
+	CSC_HUGE_HUGETLB       /**< MAP_HUGETLB from the hugetlbfs pool, else as CSC_HUGE_THP */
+} CSCHugePolicy;
+
+/**
+ * @struct CSCMemPolicy
+ * @brief How the large per-matrix arrays are allocated (see mem.h).
+ *
+ * The all-zero policy is plain malloc().
+ */
+typedef struct {
+	CSCNumaPolicy numa;    /**< Node placement */
+	CSCHugePolicy huge;    /**< Page size */
+} CSCMemPolicy;
+
+/**
+ * @struct CSCLoadOptions
+ * @brief Tuning knobs of csc_load_matrix_opts().
+ */
+typedef struct {
+	unsigned int n_threads; /**< Loader threads (0: all online processors) */
+	CSCBuildMode build;     /**< CSC construction strategy for text inputs */
+	int half;               /**< Keep only the stored triangle of symmetric inputs */
+	int normalize;          /**< Sort rows, drop duplicates and self-loops (see normalize.h) */
+	CSCMemPolicy mem;       /**< Move col_ptr and row_idx to pages allocated this way (see mem.h) */
+} CSCLoadOptions;
+
 /**
  * @struct CSCBinaryMatrix
  * @brief Compressed Sparse Column (CSC) representation of a binary matrix.
@@ -22,13 +122,29 @@ typedef struct {
 	size_t nrows;       /**< Number of rows in the matrix */
 	size_t ncols;       /**< Number of columns in the matrix */
 	size_t nnz;         /**< Number of non-zero (1) entries */
-	uint32_t *row_idx;  /**< Row indices of non-zero elements (length nnz) */
-	uint32_t *col_ptr;  /**< Column pointers (length ncols + 1) */
+	csc_idx_t *row_idx; /**< Row indices of non-zero elements (length nnz) */
+	csc_ptr_t *col_ptr; /**< Column pointers (length ncols + 1) */
+	CSCLoadStats load;  /**< How the matrix was loaded */
+	void *map_base;     /**< File mapping backing the arrays (NULL if malloc'd) */
+	size_t map_size;    /**< Length of the mapping in bytes */
+	struct CSCPacked *packed; /**< Optional compressed row indices (see packed.h) */
+	int half;           /**< Symmetric matrix with one triangle stored: each
+	                         undirected edge appears once, not mirrored */
+	csc_idx_t *perm;    /**< Vertex renumbering, perm[input] = current
+	                         (NULL if not reordered, see reorder.h) */
+	int normalized;     /**< Rows of every column strictly increasing and
+	                         off the diagonal (see normalize.h) */
+	int mirrored;       /**< Every off-diagonal entry stored in both of its
+	                         columns by construction (a fully expanded
+	                         symmetric input) */
+	CSCMemPolicy mem;   /**< How col_ptr and row_idx were allocated; the
+	                         kernels allocate their labels the same way */
 } CSCBinaryMatrix;
 
-/** @brief Load a sparse binary matrix from a .mat or .mtx file.
+/** @brief Load a sparse binary matrix from a .mat, .mtx or .csc file.
  *
- * Dispatches automatically based on file extension.
+ * Dispatches automatically based on file extension. Native .csc files
+ * are memory-mapped and used without copying.
  *
  * @param path Path to the matrix file.
  * @return Newly allocated CSCBinaryMatrix, or NULL on failure.
@@ -37,10 +153,33 @@ typedef struct {
  */
 CSCBinaryMatrix *csc_load_matrix(const char *path);
 
+/**
+ * @brief Load a sparse binary matrix with explicit loader options.
+ *
+ * Same as csc_load_matrix(), which uses zero-initialized options.
+ *
+ * @param path Path to the matrix file.
+ * @param opts Loader options (NULL for defaults).
+ * @return Newly allocated CSCBinaryMatrix, or NULL on failure.
+ */
+CSCBinaryMatrix *csc_load_matrix_opts(const char *path, const CSCLoadOptions *opts);
+
+/**
+ * @brief Save a sparse binary matrix in the native binary .csc format.
+ *
+ * The file can later be loaded with csc_load_matrix() without parsing.
+ *
+ * @param m Matrix to save.
+ * @param path Output path (should end in ".csc").
+ * @return 0 on success, -1 on failure.
+ */
+int csc_save_matrix(const CSCBinaryMatrix *m, const char *path);
+
 /**
  * @brief Free a CSCBinaryMatrix and its associated memory.
  *
- * Safe to call with NULL.
+ * Unmaps the file for matrices loaded from .csc files. Safe to call
+ * with NULL.
  *
  * @param m CSC matrix to free.
  */
@@ -55,4 +194,13 @@ void csc_free_matrix(CSCBinaryMatrix *m);
  */
 void csc_print_matrix(CSCBinaryMatrix *m);
 
+/**
+ * @brief qsort() comparator for arrays of csc_idx_t, in ascending order.
+ *
+ * @param a Pointer to the first index.
+ * @param b Pointer to the second index.
+ * @return Negative, zero or positive as *a is below, equal to or above *b.
+ */
+int csc_idx_cmp(const void *a, const void *b);
+
 #endif /* MATRIX_H */
@@ -0,0 +1,491 @@
+/**
+ * @file mem.c
+ * @brief Allocation layer for the label, col_ptr and row_idx arrays.
+ *
+ * Policy-allocated arrays are anonymous mappings. The array starts on a
+ * page (or huge page) boundary and is preceded by a mem_header_t that
+ * records the mapping, so mem_free() needs only the pointer. Interleaving
+ * calls the mbind() system call directly and the node list is read from
+ * sysfs; neither needs libnuma.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "mem.h"
+#include "parallel.h"
+#include "error.h"
+#include "timer.h"
+
+/** MPOL_INTERLEAVE from <linux/mempolicy.h> */
+#define NUMA_MPOL_INTERLEAVE 3
+
+/** Nodes an interleave mask can name */
+#define NUMA_MAX_NODES 64
+
+/** log2(MEM_HUGE_SIZE), for MAP_HUGE_SHIFT */
+#define MEM_HUGE_LOG2 21
+
+/**
+ * @struct mem_header_t
+ * @brief Bookkeeping stored right before a policy-allocated array.
+ */
+typedef struct {
+	void *base;            /* Start of the mapping */
+	size_t len;            /* Length of the mapping */
+	CSCHugePolicy huge;    /* Page size the array got */
+} mem_header_t;
+
+/**
+ * @struct place_job_t
+ * @brief State shared by the placement threads.
+ */
+typedef struct {
+	const CSCBinaryMatrix *m;  /* Matrix being placed */
+	csc_ptr_t *col_ptr;        /* New col_ptr */
+	csc_idx_t *row_idx;        /* New row_idx */
+	int pin;                   /* Pin thread t to the t-th allowed CPU */
+} place_job_t;
+
+/** CPUs the process may run on, read once before the first pin */
+static cpu_set_t pin_allowed;
+static pthread_once_t pin_once = PTHREAD_ONCE_INIT;
+
+/** Affinity of the calling thread before mem_pin_thread(), and whether it is saved */
+static _Thread_local cpu_set_t pin_saved;
+static _Thread_local int pin_active;
+
+/**
+ * @brief Returns the system page size.
+ */
+static size_t
+page_size(void)
+{
+	long page = sysconf(_SC_PAGESIZE);
+	return page > 0 ? (size_t)page : 4096;
+}
+
+/**
+ * @brief Reads the online nodes from sysfs ("0", "0-3", "0,2-3", ...).
+ *
+ * @param mask Output: bit i set for online node i < NUMA_MAX_NODES
+ * @return Number of online nodes (1 if the list cannot be read)
+ */
+static unsigned int
+online_nodes(unsigned long *mask)
+{
+	FILE *f = fopen("/sys/devices/system/node/online", "r");
+	unsigned int count = 0;
+	char line[256];
+
+	*mask = 0;
+	if (f && fgets(line, sizeof(line), f)) {
+		char *p = line;
+
+		while (*p >= '0' && *p <= '9') {
+			unsigned long lo = strtoul(p, &p, 10), hi = lo;
+			if (*p == '-')
+				hi = strtoul(p + 1, &p, 10);
+			for (unsigned long n = lo; n <= hi; n++) {
+				if (n < NUMA_MAX_NODES)
+					*mask |= 1UL << n;
+				count++;
+			}
+			if (*p == ',')
+				p++;
+		}
+	}
+	if (f)
+		fclose(f);
+
+	if (count == 0) {
+		*mask = 1;
+		count = 1;
+	}
+	return count;
+}
+
+/**
+ * @brief Binds [addr, addr + len) to every online node in turn.
+ *
+ * Failures are ignored: the pages then follow first touch.
+ */
+static void
+interleave(void *addr, size_t len)
+{
+#ifdef SYS_mbind
+	unsigned long mask;
+
+	if (online_nodes(&mask) < 2)
+		return;
+	syscall(SYS_mbind, addr, len, NUMA_MPOL_INTERLEAVE, &mask,
+	        (unsigned long)NUMA_MAX_NODES + 1, 0UL);
+#else
+	(void)addr;
+	(void)len;
+#endif
+}
+
+/**
+ * @brief Returns 1 for the all-zero policy, served by plain malloc().
+ */
+static int
+is_plain(const CSCMemPolicy *policy)
+{
+	return policy->numa == CSC_NUMA_NONE && policy->huge == CSC_HUGE_NONE;
+}
+
+/**
+ * @brief Returns 0 if transparent huge pages are disabled ("[never]").
+ */
+static int
+thp_enabled(void)
+{
+	FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+	char line[128];
+	int enabled = 1;
+
+	if (f && fgets(line, sizeof(line), f))
+		enabled = strstr(line, "[never]") == NULL;
+	if (f)
+		fclose(f);
+	return enabled;
+}
+
+/**
+ * @brief Reads the affinity of the main thread into pin_allowed.
+ *
+ * Every pin waits for this first, so no thread of the process is pinned
+ * by us yet when it runs.
+ */
+static void
+pin_init(void)
+{
+	if (sched_getaffinity(getpid(), sizeof(pin_allowed), &pin_allowed) != 0)
+		CPU_ZERO(&pin_allowed);
+}
+
+/**
+ * @brief Pins the calling thread to the @p i-th CPU of @p allowed (modulo
+ *        their number).
+ */
+static void
+pin_to(const cpu_set_t *allowed, unsigned int i)
+{
+	int n = CPU_COUNT(allowed);
+
+	if (n <= 0)
+		return;
+
+	int want = (int)(i % (unsigned int)n);
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (CPU_ISSET(cpu, allowed) && want-- == 0) {
+			cpu_set_t one;
+			CPU_ZERO(&one);
+			CPU_SET(cpu, &one);
+			pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief First column of thread @p tid's share, balanced by entries.
+ */
+static size_t
+col_split(const csc_ptr_t *col_ptr, size_t ncols, unsigned int n_threads, unsigned int tid)
+{
+	if (tid == n_threads)
+		return ncols;
+
+	size_t target = par_block_begin(col_ptr[ncols], n_threads, tid);
+	size_t lo = 0, hi = ncols;
+
+	/* First column whose entries start at or after target */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (col_ptr[mid] < target)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * @brief Copies one block of columns, first-touching its new pages.
+ */
+static void
+place_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	place_job_t *job = arg;
+	const CSCBinaryMatrix *m = job->m;
+	size_t begin = col_split(m->col_ptr, m->ncols, n_threads, tid);
+	size_t end   = col_split(m->col_ptr, m->ncols, n_threads, tid + 1);
+
+	if (job->pin)
+		mem_pin_thread(tid);
+
+	/* The last share also owns the closing col_ptr entry */
+	size_t ptr_end = (tid + 1 == n_threads) ? m->ncols + 1 : end;
+
+	memcpy(job->col_ptr + begin, m->col_ptr + begin, (ptr_end - begin) * sizeof(csc_ptr_t));
+	memcpy(job->row_idx + m->col_ptr[begin], m->row_idx + m->col_ptr[begin],
+	       (m->col_ptr[end] - m->col_ptr[begin]) * sizeof(csc_idx_t));
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc csc_numa_name()
+ */
+const char *
+csc_numa_name(CSCNumaPolicy policy)
+{
+	switch (policy) {
+	case CSC_NUMA_NONE:       return "none";
+	case CSC_NUMA_LOCAL:      return "local";
+	case CSC_NUMA_INTERLEAVE: return "interleave";
+	}
+	return "unknown";
+}
+
+/**
+ * @copydoc csc_huge_name()
+ */
+const char *
+csc_huge_name(CSCHugePolicy policy)
+{
+	switch (policy) {
+	case CSC_HUGE_NONE:    return "none";
+	case CSC_HUGE_THP:     return "thp";
+	case CSC_HUGE_HUGETLB: return "hugetlb";
+	}
+	return "unknown";
+}
+
+/**
+ * @copydoc mem_numa_nodes()
+ */
+unsigned int
+mem_numa_nodes(void)
+{
+	unsigned long mask;
+	return online_nodes(&mask);
+}
+
+/**
+ * @copydoc mem_alloc()
+ */
+void *
+mem_alloc(size_t bytes, const CSCMemPolicy *policy, CSCAccess access)
+{
+	if (is_plain(policy))
+		return malloc(bytes ? bytes : 1);
+
+	size_t page = page_size();
+	int want_huge = policy->huge != CSC_HUGE_NONE && bytes >= MEM_HUGE_SIZE;
+	size_t align = want_huge ? MEM_HUGE_SIZE : page;
+	size_t body = (bytes + align - 1) / align * align;
+	CSCHugePolicy huge = CSC_HUGE_NONE;
+	char *base = MAP_FAILED;
+	size_t len = 0;
+
+	/* One more alignment unit leaves room for the header page in front */
+	if (body == 0)
+		body = page;
+	if (body > SIZE_MAX - align) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+	if (want_huge && policy->huge == CSC_HUGE_HUGETLB) {
+		len = body + align;
+		base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (MEM_HUGE_LOG2 << MAP_HUGE_SHIFT),
+		            -1, 0);
+		if (base != MAP_FAILED)
+			huge = CSC_HUGE_HUGETLB;
+	}
+#endif
+
+	if (base == MAP_FAILED) {
+		len = body + align;
+		base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base == MAP_FAILED)
+			return NULL;
+	}
+
+	/* First boundary with a page of room for the header */
+	uintptr_t at = ((uintptr_t)base + page + align - 1) / align * align;
+	char *data = (char *)at;
+
+#ifdef MADV_HUGEPAGE
+	if (want_huge && huge == CSC_HUGE_NONE && thp_enabled() &&
+	    madvise(data, body, MADV_HUGEPAGE) == 0)
+		huge = CSC_HUGE_THP;
+#endif
+	madvise(data, body, access == CSC_ACCESS_RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+	if (policy->numa == CSC_NUMA_INTERLEAVE)
+		interleave(data, body);
+
+	mem_header_t *h = (mem_header_t *)data - 1;
+	h->base = base;
+	h->len  = len;
+	h->huge = huge;
+	return data;
+}
+
+/**
+ * @copydoc mem_free()
+ */
+void
+mem_free(void *p, const CSCMemPolicy *policy)
+{
+	if (!p)
+		return;
+
+	if (is_plain(policy)) {
+		free(p);
+		return;
+	}
+
+	mem_header_t *h = (mem_header_t *)p - 1;
+	munmap(h->base, h->len);
+}
+
+/**
+ * @copydoc mem_huge_in_effect()
+ */
+CSCHugePolicy
+mem_huge_in_effect(const void *p, const CSCMemPolicy *policy)
+{
+	if (!p || is_plain(policy))
+		return CSC_HUGE_NONE;
+
+	return ((const mem_header_t *)p - 1)->huge;
+}
+
+/**
+ * @copydoc mem_pin_thread()
+ */
+void
+mem_pin_thread(unsigned int i)
+{
+	pthread_once(&pin_once, pin_init);
+
+	if (!pin_active &&
+	    pthread_getaffinity_np(pthread_self(), sizeof(pin_saved), &pin_saved) == 0)
+		pin_active = 1;
+	if (pin_active)
+		pin_to(&pin_allowed, i);
+}
+
+/**
+ * @copydoc mem_unpin_thread()
+ */
+void
+mem_unpin_thread(void)
+{
+	if (!pin_active)
+		return;
+
+	pthread_setaffinity_np(pthread_self(), sizeof(pin_saved), &pin_saved);
+	pin_active = 0;
+}
+
+/**
+ * @copydoc csc_col_split()
+ */
+size_t
+csc_col_split(const CSCBinaryMatrix *m, unsigned int n_threads, unsigned int tid)
+{
+	return col_split(m->col_ptr, m->ncols, n_threads, tid);
+}
+
+/**
+ * @copydoc csc_mem_place()
+ */
+int
+csc_mem_place(CSCBinaryMatrix *m, const CSCMemPolicy *policy, unsigned int n_threads)
+{
+	if (is_plain(policy))
+		return 0;
+
+	double t0 = now_sec();
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+
+	place_job_t job = { .m = m };
+	job.col_ptr = mem_alloc((m->ncols + 1) * sizeof(csc_ptr_t), policy, CSC_ACCESS_SEQUENTIAL);
+	job.row_idx = mem_alloc((m->nnz + 1) * sizeof(csc_idx_t), policy, CSC_ACCESS_SEQUENTIAL);
+
+	if (!job.col_ptr || !job.row_idx) {
+		print_error(__func__, "mmap() failed", errno);
+		mem_free(job.col_ptr, policy);
+		mem_free(job.row_idx, policy);
+		return -1;
+	}
+
+	/* Pinning moves the calling thread too (it runs share 0): restore it after */
+	job.pin = policy->numa == CSC_NUMA_LOCAL;
+
+	par_run(n_threads, place_worker, &job);
+
+	if (job.pin)
+		mem_unpin_thread();
+
+	/* Release the old arrays */
+	if (m->map_base) {
+		munmap(m->map_base, m->map_size);
+		m->map_base = NULL;
+		m->map_size = 0;
+	} else {
+		mem_free(m->col_ptr, &m->mem);
+		mem_free(m->row_idx, &m->mem);
+	}
+	m->col_ptr = job.col_ptr;
+	m->row_idx = job.row_idx;
+	m->mem = *policy;
+
+	m->load.place_time_s += now_sec() - t0;
+	return 0;
+}
+
+/**
+ * @copydoc csc_mem_release_rows()
+ */
+void
+csc_mem_release_rows(CSCBinaryMatrix *m)
+{
+	if (!m->packed || !m->row_idx)
+		return;
+
+	if (m->map_base) {
+		/* Whole pages inside the section only; the mapping is unmapped on free */
+		size_t page = page_size();
+		uintptr_t begin = ((uintptr_t)m->row_idx + page - 1) / page * page;
+		uintptr_t end   = ((uintptr_t)(m->row_idx + m->nnz)) / page * page;
+
+		if (end > begin)
+			madvise((void *)begin, end - begin, MADV_DONTNEED);
+	} else {
+		mem_free(m->row_idx, &m->mem);
+	}
+	m->row_idx = NULL;
+}
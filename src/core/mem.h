@@ -0,0 +1,164 @@
+/**
+ * @file mem.h
+ * @brief Allocation layer for the label, col_ptr and row_idx arrays.
+ *
+ * Every large array of a matrix and of the kernels goes through
+ * mem_alloc() under the matrix's CSCMemPolicy, which chooses two things:
+ *
+ * Node placement (CSCNumaPolicy). Linux places a page on the node of the
+ * thread that first writes it. Arrays that are malloc()'d and then filled
+ * by one thread therefore sit on one node, and every other socket reads
+ * them remotely.
+ *
+ * - CSC_NUMA_LOCAL: fresh pages written first by the threads that later
+ *   use them. csc_mem_place() copies col_ptr and row_idx in the n_threads
+ *   contiguous, edge-balanced column blocks of csc_col_split(), thread t
+ *   pinned to the t-th allowed CPU (mem_pin_thread()). Kernels that
+ *   support the policy pin their threads the same way, sweep the same
+ *   static blocks and first-touch their labels by them.
+ * - CSC_NUMA_INTERLEAVE: fresh pages spread round-robin over the online
+ *   nodes with mbind(). Random accesses such as label[row] then hit every
+ *   memory controller evenly, whatever thread makes them.
+ *
+ * Page size (CSCHugePolicy). Random label[row] lookups over a multi-GB
+ * array miss the TLB on almost every access with 4 KB pages; 2 MB pages
+ * cover 512 times as much memory per TLB entry.
+ *
+ * - CSC_HUGE_THP: 2 MB-aligned mappings advised with MADV_HUGEPAGE, so
+ *   transparent huge pages are used even in the kernel's "madvise" mode.
+ * - CSC_HUGE_HUGETLB: mappings from the hugetlbfs pool (MAP_HUGETLB),
+ *   falling back to CSC_HUGE_THP when the pool is empty.
+ *
+ * Arrays below MEM_HUGE_SIZE always use base pages. Each array is also
+ * advised with its access pattern (CSCAccess).
+ *
+ * None of this needs libnuma or hugetlbfs mounts. On single-node machines,
+ * or where mbind() is not permitted, interleaving degrades to first touch;
+ * mem_huge_in_effect() tells which page size an array actually got.
+ */
+
+#ifndef MEM_H
+#define MEM_H
+
+#include <stddef.h>
+
+#include "matrix.h"
+
+/** Huge page size, and the smallest array that uses huge pages */
+#define MEM_HUGE_SIZE ((size_t)2 << 20)
+
+/**
+ * @enum CSCAccess
+ * @brief Access pattern of an array, passed to madvise().
+ */
+typedef enum {
+	CSC_ACCESS_SEQUENTIAL = 0,  /**< Streamed front to back (col_ptr, row_idx) */
+	CSC_ACCESS_RANDOM           /**< Gathered at random (labels) */
+} CSCAccess;
+
+/**
+ * @brief Returns the printable name of a node placement ("none", "local", "interleave").
+ */
+const char *csc_numa_name(CSCNumaPolicy policy);
+
+/**
+ * @brief Returns the printable name of a page size policy ("none", "thp", "hugetlb").
+ */
+const char *csc_huge_name(CSCHugePolicy policy);
+
+/**
+ * @brief Returns the number of online NUMA nodes (1 if unknown).
+ */
+unsigned int mem_numa_nodes(void);
+
+/**
+ * @brief Allocates an array under a memory policy.
+ *
+ * The all-zero policy is a plain malloc(). Any other maps fresh anonymous
+ * pages that are not touched yet, so the caller's first writes decide
+ * where they live (CSC_NUMA_LOCAL), or they are already bound to every
+ * node in turn (CSC_NUMA_INTERLEAVE).
+ *
+ * @param bytes Size of the array
+ * @param policy Memory policy
+ * @param access Access pattern hint
+ * @return The array, or NULL on failure (errno set)
+ */
+void *mem_alloc(size_t bytes, const CSCMemPolicy *policy, CSCAccess access);
+
+/**
+ * @brief Frees an array allocated by mem_alloc() under the same @p policy.
+ *        Safe to call with NULL.
+ */
+void mem_free(void *p, const CSCMemPolicy *policy);
+
+/**
+ * @brief Returns the page size an array allocated by mem_alloc() under
+ *        @p policy actually got.
+ *
+ * CSC_HUGE_THP means huge pages were requested with MADV_HUGEPAGE and
+ * transparent huge pages are not disabled; the kernel may still back
+ * parts of the array with base pages.
+ */
+CSCHugePolicy mem_huge_in_effect(const void *p, const CSCMemPolicy *policy);
+
+/**
+ * @brief Moves col_ptr and row_idx of a matrix to pages allocated under
+ *        @p policy.
+ *
+ * The arrays are copied in parallel and the old ones released, including
+ * the file mapping of a .csc matrix. Later passes that replace the arrays
+ * (normalization, reordering) keep the policy. The time spent is recorded
+ * in m->load.place_time_s. The all-zero policy leaves the matrix untouched.
+ *
+ * @param m Matrix to place
+ * @param policy Memory policy
+ * @param n_threads Number of threads; use the kernels' thread count
+ *        (0 uses every online CPU)
+ * @return 0 on success, -1 on error (reported through print_error()); the
+ *         matrix is unchanged on error
+ */
+int csc_mem_place(CSCBinaryMatrix *m, const CSCMemPolicy *policy, unsigned int n_threads);
+
+/**
+ * @brief Returns the first column of block @p tid when the columns of @p m
+ *        are cut into @p n_threads contiguous blocks of about as many
+ *        entries each.
+ *
+ * Block @p n_threads starts at m->ncols. These are the blocks
+ * csc_mem_place() copies under CSC_NUMA_LOCAL, so a kernel thread that
+ * sweeps block t reads the pages thread t placed.
+ */
+size_t csc_col_split(const CSCBinaryMatrix *m, unsigned int n_threads, unsigned int tid);
+
+/**
+ * @brief Pins the calling thread to the @p i-th CPU (modulo their number)
+ *        the process was allowed to run on before anything was pinned.
+ *
+ * The thread's own affinity is saved the first time, for
+ * mem_unpin_thread(). Thread i of csc_mem_place() under CSC_NUMA_LOCAL
+ * runs on the same CPU. Failures are ignored: the thread then stays
+ * where the scheduler puts it.
+ */
+void mem_pin_thread(unsigned int i);
+
+/**
+ * @brief Gives the calling thread back the affinity it had before
+ *        mem_pin_thread(). Does nothing if it is not pinned.
+ */
+void mem_unpin_thread(void);
+
+/**
+ * @brief Gives back the pages of row_idx of a packed matrix.
+ *
+ * Every kernel decodes m->packed when it is set, so the plain row indices
+ * are dead weight once normalization and reordering (which rebuild the
+ * matrix from them) are done. The array is freed, or for a .csc file
+ * mapping its pages are dropped with MADV_DONTNEED, and m->row_idx is set
+ * to NULL. Does nothing on an unpacked matrix.
+ *
+ * @param m Matrix whose plain row indices are released
+ */
+void csc_mem_release_rows(CSCBinaryMatrix *m);
+
+#endif /* MEM_H */
@@ -0,0 +1,1040 @@
+/**
+ * @file mtx.c
+ * @brief Memory-mapped, multi-threaded Matrix Market (.mtx) reader.
+ *
+ * Reading proceeds in three steps:
+ *
+ * 1. The file is mapped and the banner and size line are parsed serially.
+ * 2. The body is split into one line-aligned chunk per thread and every
+ *    thread counts the entry lines of its chunk. A prefix sum over these
+ *    counts gives the global index of the first entry of each chunk, which
+ *    fixes where the chunk writes its output.
+ * 3. Every thread tokenizes its chunk directly into the shared COO arrays.
+ *    Chunks that dropped entries (explicit zeros, diagonal of symmetric
+ *    files) are then compacted so the output matches a serial scan.
+ *
+ * mtx_read_csc() replaces step 3 with two tokenizing passes (column
+ * degrees, then a scatter into the final row_idx), trading a second parse
+ * for not having to stage COO arrays.
+ *
+ * mtx_read_edges() hands the entries to a callback instead of storing
+ * them. Nothing is written to a global slot, so for coordinate files step
+ * 2 is skipped and every byte of the file is read once.
+ *
+ * Files opened with mtx_open_stream() run steps 2 and 3 once per
+ * decompressed block. The global index of a block's first entry is the
+ * number of entry lines seen in earlier blocks, so every entry still lands
+ * in the slot a serial scan would give it.
+ *
+ * The tokenizer only needs to know whether a value is zero, so it never
+ * converts values to floating point.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mtx.h"
+#include "parallel.h"
+#include "error.h"
+
+/* ------------------------------------------------------------------------- */
+/*                                 Tokenizer                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Skips spaces, tabs and carriage returns (but not newlines).
+ */
+static inline const char *
+skip_blanks(const char *p, const char *end)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		p++;
+	return p;
+}
+
+/**
+ * @brief Returns the first byte of the line following the one containing @p p.
+ */
+static inline const char *
+next_line(const char *p, const char *end)
+{
+	const char *nl = memchr(p, '\n', (size_t)(end - p));
+	return nl ? nl + 1 : end;
+}
+
+/**
+ * @brief Scans an unsigned decimal integer.
+ *
+ * @param p Cursor (advanced past the number on success)
+ * @param end End of the buffer
+ * @param out Parsed value
+ * @return 1 on success, 0 if no digits were found
+ */
+static inline int
+scan_index(const char **p, const char *end, size_t *out)
+{
+	const char *s = skip_blanks(*p, end);
+	size_t v = 0;
+
+	if (s == end || (unsigned char)(*s - '0') > 9)
+		return 0;
+
+	while (s < end && (unsigned char)(*s - '0') <= 9)
+		v = v * 10 + (size_t)(*s++ - '0');
+
+	*p = s;
+	*out = v;
+	return 1;
+}
+
+/**
+ * @brief Scans a real number and reports whether it is non-zero.
+ *
+ * Accepts the usual `[sign] digits [. digits] [e|E [sign] digits]` syntax as
+ * well as `inf`/`nan` spellings (which count as non-zero, like strtod()).
+ * A value is zero when all mantissa digits are zero or when its magnitude
+ * underflows a double.
+ *
+ * @param p Cursor (advanced past the number on success)
+ * @param end End of the buffer
+ * @param nonzero Output: 1 if the value is non-zero
+ * @return 1 on success, 0 if no number was found
+ */
+static inline int
+scan_value(const char **p, const char *end, int *nonzero)
+{
+	const char *s = skip_blanks(*p, end);
+	long lead = 0;    /* Decimal exponent of the first non-zero digit */
+	int seen_nz = 0;
+	int digits = 0;
+
+	if (s < end && (*s == '+' || *s == '-'))
+		s++;
+
+	/* inf, infinity, nan, nan(...) */
+	if (s < end && ((*s | 0x20) == 'i' || (*s | 0x20) == 'n')) {
+		while (s < end && *s != ' ' && *s != '\t' && *s != '\r' && *s != '\n')
+			s++;
+		*p = s;
+		*nonzero = 1;
+		return 1;
+	}
+
+	/* Integer part: the first non-zero digit's exponent depends on how many
+	 * digits follow it, so count them as we go. */
+	for (; s < end && (unsigned char)(*s - '0') <= 9; s++, digits++) {
+		if (seen_nz)
+			lead++;
+		else if (*s != '0')
+			seen_nz = 1;
+	}
+
+	if (s < end && *s == '.') {
+		long frac = 0;
+		for (s++; s < end && (unsigned char)(*s - '0') <= 9; s++, digits++) {
+			frac++;
+			if (!seen_nz && *s != '0') {
+				seen_nz = 1;
+				lead = -frac;
+			}
+		}
+	}
+
+	if (!digits)
+		return 0;
+
+	if (s < end && (*s == 'e' || *s == 'E')) {
+		const char *e = s + 1;
+		int neg = 0;
+		long exp = 0;
+
+		if (e < end && (*e == '+' || *e == '-'))
+			neg = (*e++ == '-');
+		if (e < end && (unsigned char)(*e - '0') <= 9) {
+			while (e < end && (unsigned char)(*e - '0') <= 9) {
+				if (exp < 100000)
+					exp = exp * 10 + (*e - '0');
+				e++;
+			}
+			lead += neg ? -exp : exp;
+			s = e;
+		}
+	}
+
+	/* Magnitudes below the smallest subnormal double round to 0.0 */
+	*nonzero = seen_nz && lead >= -324;
+	*p = s;
+	return 1;
+}
+
+/**
+ * @brief Parses the remainder of one entry line.
+ *
+ * For coordinate files this reads `i j [re [im]]`, for array files
+ * `re [im]`. The returned indices are 1-based as stored in the file.
+ *
+ * @return 1 on success, 0 on a malformed line
+ */
+static inline int
+scan_entry(const MtxFile *mf, const char **p, const char *end,
+           size_t *i, size_t *j, int *nonzero)
+{
+	*nonzero = 1;
+
+	if (mf->is_coordinate) {
+		if (!scan_index(p, end, i) || !scan_index(p, end, j))
+			return 0;
+		if (*i == 0 || *i > mf->nrows || *j == 0 || *j > mf->ncols)
+			return 0;
+		if (mf->is_pattern)
+			return 1;
+	}
+
+	if (!scan_value(p, end, nonzero))
+		return 0;
+
+	if (mf->is_complex) {
+		int im_nonzero;
+		if (!scan_value(p, end, &im_nonzero))
+			return 0;
+		*nonzero |= im_nonzero;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Case-insensitive comparison of a banner word.
+ */
+static int
+word_is(const char *w, size_t len, const char *lit)
+{
+	size_t n = strlen(lit);
+	if (len != n)
+		return 0;
+
+	for (size_t k = 0; k < n; k++)
+		if ((w[k] | 0x20) != lit[k])
+			return 0;
+
+	return 1;
+}
+
+/**
+ * @brief Reads the next blank-separated word of the current line.
+ *
+ * @return Length of the word (0 at end of line)
+ */
+static size_t
+next_word(const char **p, const char *end, const char **word)
+{
+	const char *s = skip_blanks(*p, end);
+	const char *w = s;
+
+	while (s < end && *s != ' ' && *s != '\t' && *s != '\r' && *s != '\n')
+		s++;
+
+	*word = w;
+	*p = s;
+	return (size_t)(s - w);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              Parallel Passes                              */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @enum mtx_emit_t
+ * @brief What the tokenizing pass does with each kept entry.
+ */
+typedef enum {
+	MTX_EMIT_COO,      /* Store (i,j) in the entry's reserved COO slot */
+	MTX_EMIT_DEGREE,   /* Count the entry in its column */
+	MTX_EMIT_SCATTER,  /* Store i at the column's next free CSC slot */
+	MTX_EMIT_EDGES     /* Pass batches of entries to a callback */
+} mtx_emit_t;
+
+/**
+ * @struct mtx_job_t
+ * @brief State shared by the parser threads.
+ */
+typedef struct {
+	const MtxFile *mf;     /* File being parsed */
+	unsigned int n_threads;/* Number of chunks/threads */
+	unsigned int max_threads;/* Chunks the arrays below have room for */
+	const char **bounds;   /* Chunk boundaries (n_threads + 1 entries) */
+	size_t *first;         /* Per chunk: entry lines, then first entry index */
+	size_t *written;       /* Per chunk: entries produced */
+	size_t *lines;         /* Per chunk: entry lines tokenized */
+	mtx_emit_t mode;       /* Output of the tokenizing pass */
+	csc_idx_t *coo_i;      /* MTX_EMIT_COO: output row indices */
+	csc_idx_t *coo_j;      /* MTX_EMIT_COO: output column indices */
+	csc_ptr_t *col_ptr;    /* MTX_EMIT_DEGREE/SCATTER: per-column counters */
+	csc_idx_t *row_idx;    /* MTX_EMIT_SCATTER: output row indices */
+	mtx_edge_fn edge_fn;   /* MTX_EMIT_EDGES: receives every batch */
+	void *edge_ctx;        /* MTX_EMIT_EDGES: first argument of edge_fn */
+	size_t mult;           /* Output slots reserved per entry (2 if mirrored) */
+	size_t limit;          /* Entry index at which a chunk stops tokenizing */
+	int error;             /* Set when any thread finds a malformed entry */
+} mtx_job_t;
+
+/**
+ * @brief Pass 1: counts the entry lines of one chunk.
+ *
+ * Blank lines and `%` comment lines are not entries.
+ */
+static void
+count_worker(void *arg, unsigned int tid, unsigned int n_threads __attribute__((unused)))
+{
+	mtx_job_t *job = arg;
+	const char *p = job->bounds[tid];
+	const char *end = job->bounds[tid + 1];
+	size_t lines = 0;
+
+	while (p < end) {
+		p = skip_blanks(p, end);
+		if (p == end)
+			break;
+		if (*p != '\n' && *p != '%')
+			lines++;
+		p = next_line(p, end);
+	}
+
+	job->first[tid] = lines;
+}
+
+/** Entries buffered per thread before a degree/scatter/edge flush */
+#define MTX_BATCH 1024
+
+/**
+ * @struct mtx_batch_t
+ * @brief Per-thread staging buffer for the CSC passes.
+ *
+ * Column updates land at random addresses; applying them from a tight
+ * loop over a small buffer, instead of between tokenizer steps, lets the
+ * cache misses overlap.
+ */
+typedef struct {
+	csc_idx_t i[MTX_BATCH];
+	csc_idx_t j[MTX_BATCH];
+	size_t n;
+} mtx_batch_t;
+
+/**
+ * @brief Applies the buffered entries to the column counters.
+ *
+ * With a single thread the counters are private and updated with plain
+ * increments; locked increments would serialize the misses again.
+ */
+static void
+flush(mtx_job_t *job, mtx_batch_t *b)
+{
+	csc_ptr_t *col_ptr = job->col_ptr;
+	csc_idx_t *row_idx = job->row_idx;
+	int shared = job->n_threads > 1;
+
+	if (job->mode == MTX_EMIT_EDGES) {
+		job->edge_fn(job->edge_ctx, b->i, b->j, b->n);
+	} else if (job->mode == MTX_EMIT_DEGREE) {
+		if (shared)
+			for (size_t e = 0; e < b->n; e++)
+				__atomic_fetch_add(&col_ptr[b->j[e]], 1, __ATOMIC_RELAXED);
+		else
+			for (size_t e = 0; e < b->n; e++)
+				col_ptr[b->j[e]]++;
+	} else {
+		if (shared)
+			for (size_t e = 0; e < b->n; e++)
+				row_idx[__atomic_fetch_add(&col_ptr[b->j[e]], 1, __ATOMIC_RELAXED)] = b->i[e];
+		else
+			for (size_t e = 0; e < b->n; e++)
+				row_idx[col_ptr[b->j[e]]++] = b->i[e];
+	}
+
+	b->n = 0;
+}
+
+/**
+ * @brief Hands one kept 0-based entry (i,j) to the current pass.
+ */
+static inline void
+emit(mtx_job_t *job, mtx_batch_t *b, size_t out, csc_idx_t i, csc_idx_t j)
+{
+	if (job->mode == MTX_EMIT_COO) {
+		job->coo_i[out] = i;
+		job->coo_j[out] = j;
+		return;
+	}
+
+	b->i[b->n] = i;
+	b->j[b->n] = j;
+	if (++b->n == MTX_BATCH)
+		flush(job, b);
+}
+
+/**
+ * @brief Pass 2: tokenizes one chunk and emits its entries.
+ */
+static void
+parse_worker(void *arg, unsigned int tid, unsigned int n_threads __attribute__((unused)))
+{
+	mtx_job_t *job = arg;
+	const MtxFile *mf = job->mf;
+	const char *p = job->bounds[tid];
+	const char *end = job->bounds[tid + 1];
+	size_t k = job->first[tid];
+	size_t out = k * job->mult;
+	const size_t out_begin = out;
+	mtx_batch_t batch;
+
+	batch.n = 0;
+
+	while (p < end && k < job->limit) {
+		p = skip_blanks(p, end);
+		if (p == end)
+			break;
+		if (*p == '\n' || *p == '%') {
+			p = next_line(p, end);
+			continue;
+		}
+
+		size_t i = 0, j = 0;
+		int nonzero;
+
+		if (!scan_entry(mf, &p, end, &i, &j, &nonzero)) {
+			__atomic_store_n(&job->error, 1, __ATOMIC_RELAXED);
+			break;
+		}
+
+		if (!mf->is_coordinate) {
+			/* Dense arrays are stored column-major */
+			i = k % mf->nrows + 1;
+			j = k / mf->nrows + 1;
+		}
+
+		if (nonzero) {
+			emit(job, &batch, out++, (csc_idx_t)(i - 1), (csc_idx_t)(j - 1));
+
+			if (mf->symmetric && i != j)
+				emit(job, &batch, out++, (csc_idx_t)(j - 1), (csc_idx_t)(i - 1));
+		}
+
+		k++;
+		p = next_line(p, end);
+	}
+
+	if (batch.n)
+		flush(job, &batch);
+
+	job->written[tid] = out - out_begin;
+	job->lines[tid] = k - job->first[tid];
+}
+
+/**
+ * @brief Allocates the chunk bookkeeping of a job for up to @p n_threads chunks.
+ *
+ * @return 0 on success, -1 on error (reported)
+ */
+static int
+job_alloc(mtx_job_t *job, const MtxFile *mf, unsigned int n_threads)
+{
+	if (n_threads == 0)
+		n_threads = 1;
+
+	memset(job, 0, sizeof(*job));
+	job->mf = mf;
+	job->max_threads = n_threads;
+	job->mult = mf->symmetric ? 2 : 1;
+	job->limit = mf->nnz;
+	job->bounds  = malloc((n_threads + 1) * sizeof(*job->bounds));
+	job->first   = malloc(n_threads * sizeof(size_t));
+	job->written = malloc(n_threads * sizeof(size_t));
+	job->lines   = malloc(n_threads * sizeof(size_t));
+
+	if (!job->bounds || !job->first || !job->written || !job->lines) {
+		print_error(__func__, "malloc failed", errno);
+		return -1;
+	}
+
+	if (mf->nrows > CSC_IDX_MAX || mf->ncols > CSC_IDX_MAX ||
+	    mf->nnz > CSC_PTR_MAX / job->mult)
+	{
+		print_error(__func__, "matrix exceeds the index width of this build (see make INDEX=)", 0);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Splits [@p body, @p end) into line-aligned chunks.
+ */
+static void
+job_bounds(mtx_job_t *job, const char *body, const char *end)
+{
+	size_t body_len = (size_t)(end - body);
+	unsigned int n_threads = job->max_threads;
+
+	/* Keep chunks large enough that thread start-up does not dominate */
+	if (body_len / n_threads < (1u << 16))
+		n_threads = (unsigned int)(body_len >> 16) + 1;
+	job->n_threads = n_threads;
+
+	/* Line-aligned chunk boundaries */
+	job->bounds[0] = body;
+	job->bounds[n_threads] = end;
+	for (unsigned int t = 1; t < n_threads; t++) {
+		const char *b = body + par_block_begin(body_len, n_threads, t);
+		if (b[-1] != '\n')
+			b = next_line(b, end);
+		job->bounds[t] = b > job->bounds[t - 1] ? b : job->bounds[t - 1];
+	}
+}
+
+/**
+ * @brief Splits [@p body, @p end) into chunks and locates each chunk's
+ *        first entry.
+ *
+ * @param base Global index of the first entry line in @p body
+ * @return Number of entry lines in [@p body, @p end)
+ */
+static size_t
+job_split(mtx_job_t *job, const char *body, const char *end, size_t base)
+{
+	job_bounds(job, body, end);
+
+	/* Pass 1: entry lines per chunk, turned into first entry indices */
+	par_run(job->n_threads, count_worker, job);
+
+	size_t total = 0;
+	for (unsigned int t = 0; t < job->n_threads; t++) {
+		size_t lines = job->first[t];
+		job->first[t] = base + total;
+		total += lines;
+	}
+
+	return total;
+}
+
+/**
+ * @brief Splits the whole body of a mapped file into chunks.
+ *
+ * @return 0 on success, -1 on error (reported)
+ */
+static int
+job_init(mtx_job_t *job, const MtxFile *mf, unsigned int n_threads)
+{
+	if (job_alloc(job, mf, n_threads) != 0)
+		return -1;
+
+	if (job_split(job, mf->body, mf->map + mf->size, 0) < mf->nnz) {
+		print_error(__func__, "bad coordinate entry", 0);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Runs the tokenizing pass in the job's current mode.
+ *
+ * @return Number of entries emitted, or (size_t)-1 on a malformed entry
+ */
+static size_t
+job_parse(mtx_job_t *job)
+{
+	job->error = 0;
+	par_run(job->n_threads, parse_worker, job);
+
+	if (job->error) {
+		print_error(__func__, "bad coordinate entry", 0);
+		return (size_t)-1;
+	}
+
+	size_t n = 0;
+	for (unsigned int t = 0; t < job->n_threads; t++)
+		n += job->written[t];
+	return n;
+}
+
+/**
+ * @brief Closes the gaps left by dropped entries, preserving file order.
+ *
+ * @param n Entries already in place before the job's first chunk
+ * @return Entries in place after the job's last chunk
+ */
+static size_t
+job_compact(mtx_job_t *job, size_t n)
+{
+	for (unsigned int t = 0; t < job->n_threads; t++) {
+		size_t src = job->first[t] * job->mult;
+		if (src != n && job->written[t]) {
+			memmove(job->coo_i + n, job->coo_i + src, job->written[t] * sizeof(csc_idx_t));
+			memmove(job->coo_j + n, job->coo_j + src, job->written[t] * sizeof(csc_idx_t));
+		}
+		n += job->written[t];
+	}
+
+	return n;
+}
+
+/**
+ * @brief Releases the chunk bookkeeping of a job.
+ */
+static void
+job_free(mtx_job_t *job)
+{
+	free(job->bounds);
+	free(job->first);
+	free(job->written);
+	free(job->lines);
+}
+
+/**
+ * @brief Tokenizes [@p body, @p end) in MTX_EMIT_EDGES mode.
+ *
+ * Coordinate entries carry their own indices, so the chunks skip the
+ * counting pass, start from entry 0 and tokenize every line they hold;
+ * array entries take their position from their index and still need it.
+ *
+ * @param base Global index of the first entry line in @p body
+ * @return Number of entry lines tokenized, or (size_t)-1 on a malformed entry
+ */
+static size_t
+job_parse_edges(mtx_job_t *job, const char *body, const char *end, size_t base)
+{
+	if (job->mf->is_coordinate) {
+		job_bounds(job, body, end);
+		memset(job->first, 0, job->n_threads * sizeof(size_t));
+		job->limit = SIZE_MAX;
+	} else {
+		job_split(job, body, end, base);
+	}
+
+	if (job_parse(job) == (size_t)-1)
+		return (size_t)-1;
+
+	size_t lines = 0;
+	for (unsigned int t = 0; t < job->n_threads; t++)
+		lines += job->lines[t];
+	return lines;
+}
+
+/**
+ * @brief Tokenizes a streamed file block by block into COO arrays.
+ *
+ * @return 0 on success, -1 on error (reported)
+ */
+static int
+read_coo_stream(const MtxFile *mf, unsigned int n_threads,
+                csc_idx_t **coo_i, csc_idx_t **coo_j, size_t *count)
+{
+	mtx_job_t job;
+
+	if (job_alloc(&job, mf, n_threads) != 0)
+		goto fail;
+
+	size_t max_nnz = mf->nnz * job.mult;
+	job.mode  = MTX_EMIT_COO;
+	job.coo_i = malloc((max_nnz + 1) * sizeof(csc_idx_t));
+	job.coo_j = malloc((max_nnz + 1) * sizeof(csc_idx_t));
+
+	if (!job.coo_i || !job.coo_j) {
+		print_error(__func__, "malloc failed", errno);
+		goto fail;
+	}
+
+	/* The rest of the first block, then every following block; trailing
+	 * blocks past the last entry are never waited for. */
+	const char *body = mf->body;
+	const char *end = mf->map + mf->size;
+	size_t k = 0, n = 0;
+
+	for (;;) {
+		if (body < end) {
+			size_t lines = job_split(&job, body, end, k);
+			if (job_parse(&job) == (size_t)-1)
+				goto fail;
+			n = job_compact(&job, n);
+			k += lines;
+		}
+
+		if (k >= mf->nnz)
+			break;
+
+		size_t len;
+		int ret = instream_next(mf->stream, &body, &len);
+		if (ret < 0)
+			goto fail;
+		if (ret == 0)
+			break;
+		end = body + len;
+	}
+
+	if (k < mf->nnz) {
+		print_error(__func__, "bad coordinate entry", 0);
+		goto fail;
+	}
+
+	job_free(&job);
+
+	*coo_i = job.coo_i;
+	*coo_j = job.coo_j;
+	*count = n;
+	return 0;
+
+fail:
+	job_free(&job);
+	free(job.coo_i);
+	free(job.coo_j);
+	return -1;
+}
+
+/**
+ * @brief Parses the banner and size line at the start of [@p begin, @p end).
+ *
+ * Fills in the format fields, sizes and body of @p mf.
+ *
+ * @return 0 on success, -1 on error (reported)
+ */
+static int
+parse_header(MtxFile *mf, const char *begin, const char *end)
+{
+	/* --- Banner -------------------------------------------------------- */
+	const char *p = begin;
+	const char *w[5];
+	size_t len[5];
+
+	for (int k = 0; k < 5; k++)
+		len[k] = next_word(&p, end, &w[k]);
+
+	if (!word_is(w[0], len[0], "%%matrixmarket") || !word_is(w[1], len[1], "matrix") ||
+	    !len[2] || !len[3] || !len[4])
+	{
+		print_error(__func__, "invalid MatrixMarket header", 0);
+		return -1;
+	}
+
+	mf->is_coordinate = word_is(w[2], len[2], "coordinate");
+	mf->is_pattern    = word_is(w[3], len[3], "pattern");
+	mf->is_complex    = word_is(w[3], len[3], "complex");
+
+	int symmetric = word_is(w[4], len[4], "symmetric");
+	int skew      = word_is(w[4], len[4], "skew-symmetric");
+	int hermitian = word_is(w[4], len[4], "hermitian");
+	int general   = word_is(w[4], len[4], "general");
+
+	if (!general && !symmetric && !skew && !hermitian) {
+		print_error(__func__, "unsupported symmetry", 0);
+		return -1;
+	}
+
+	mf->symmetric = symmetric && mf->is_coordinate;
+
+	/* --- Sizes --------------------------------------------------------- */
+	p = next_line(p, end);
+	for (;;) {
+		p = skip_blanks(p, end);
+		if (p == end || (*p != '\n' && *p != '%'))
+			break;
+		p = next_line(p, end);
+	}
+
+	if (mf->is_coordinate) {
+		if (!scan_index(&p, end, &mf->nrows) || !scan_index(&p, end, &mf->ncols) ||
+		    !scan_index(&p, end, &mf->nnz))
+		{
+			print_error(__func__, "invalid size line", 0);
+			return -1;
+		}
+	} else {
+		if (!scan_index(&p, end, &mf->nrows) || !scan_index(&p, end, &mf->ncols)) {
+			print_error(__func__, "invalid array size line", 0);
+			return -1;
+		}
+		mf->nnz = mf->nrows * mf->ncols; /* zeroes are filtered later */
+	}
+
+	mf->body = next_line(p, end);
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+/**
+ * @copydoc mtx_open()
+ */
+int
+mtx_open(const char *filename, MtxFile *mf)
+{
+	memset(mf, 0, sizeof(*mf));
+
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		print_error(__func__, "failed to open .mtx file", errno);
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		print_error(__func__, "fstat() failed", errno);
+		close(fd);
+		return -1;
+	}
+
+	if (st.st_size == 0) {
+		print_error(__func__, "invalid MatrixMarket header", 0);
+		close(fd);
+		return -1;
+	}
+
+	mf->size = (size_t)st.st_size;
+	mf->map = mmap(NULL, mf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mf->map == MAP_FAILED) {
+		print_error(__func__, "mmap() failed", errno);
+		mf->map = NULL;
+		return -1;
+	}
+
+	posix_madvise(mf->map, mf->size, POSIX_MADV_SEQUENTIAL);
+
+	if (parse_header(mf, mf->map, mf->map + mf->size) != 0) {
+		mtx_close(mf);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @copydoc mtx_open_stream()
+ */
+int
+mtx_open_stream(InStream *in, MtxFile *mf)
+{
+	const char *data;
+	size_t len;
+
+	memset(mf, 0, sizeof(*mf));
+	mf->stream = in;
+
+	int ret = instream_next(in, &data, &len);
+	if (ret < 0)
+		return -1;
+	if (ret == 0) {
+		print_error(__func__, "invalid MatrixMarket header", 0);
+		return -1;
+	}
+
+	/* The first block holds the header: it ends on a line boundary and is
+	 * far larger than any banner and comment block seen in practice. */
+	mf->map  = (char *)data;
+	mf->size = len;
+
+	if (parse_header(mf, data, data + len) != 0) {
+		mtx_close(mf);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @copydoc mtx_close()
+ */
+void
+mtx_close(MtxFile *mf)
+{
+	if (mf->map && !mf->stream)
+		munmap(mf->map, mf->size);
+	mf->map = NULL;
+	mf->body = NULL;
+	mf->stream = NULL;
+}
+
+/**
+ * @copydoc mtx_read_coo()
+ */
+int
+mtx_read_coo(const MtxFile *mf, unsigned int n_threads,
+             csc_idx_t **coo_i, csc_idx_t **coo_j, size_t *count)
+{
+	mtx_job_t job;
+
+	if (mf->stream)
+		return read_coo_stream(mf, n_threads, coo_i, coo_j, count);
+
+	if (job_init(&job, mf, n_threads) != 0)
+		goto fail;
+
+	size_t max_nnz = mf->nnz * job.mult;
+	job.mode  = MTX_EMIT_COO;
+	job.coo_i = malloc((max_nnz + 1) * sizeof(csc_idx_t));
+	job.coo_j = malloc((max_nnz + 1) * sizeof(csc_idx_t));
+
+	if (!job.coo_i || !job.coo_j) {
+		print_error(__func__, "malloc failed", errno);
+		goto fail;
+	}
+
+	/* Pass 2: tokenize into reserved slots */
+	if (job_parse(&job) == (size_t)-1)
+		goto fail;
+
+	size_t n = job_compact(&job, 0);
+
+	job_free(&job);
+
+	*coo_i = job.coo_i;
+	*coo_j = job.coo_j;
+	*count = n;
+	return 0;
+
+fail:
+	job_free(&job);
+	free(job.coo_i);
+	free(job.coo_j);
+	return -1;
+}
+
+/**
+ * @copydoc mtx_read_csc()
+ */
+int
+mtx_read_csc(const MtxFile *mf, unsigned int n_threads,
+             csc_ptr_t **col_ptr, csc_idx_t **row_idx, size_t *count)
+{
+	mtx_job_t job;
+
+	if (mf->stream) {
+		print_error(__func__, "two-pass loading needs an uncompressed file", 0);
+		return -1;
+	}
+
+	if (job_init(&job, mf, n_threads) != 0)
+		goto fail;
+
+	job.col_ptr = calloc(mf->ncols + 1, sizeof(csc_ptr_t));
+	if (!job.col_ptr) {
+		print_error(__func__, "malloc failed", errno);
+		goto fail;
+	}
+
+	/* Pass 2: column degrees */
+	job.mode = MTX_EMIT_DEGREE;
+	size_t n = job_parse(&job);
+	if (n == (size_t)-1)
+		goto fail;
+
+	/* Exclusive scan: col_ptr[j] becomes the first slot of column j */
+	csc_ptr_t sum = 0;
+	for (size_t j = 0; j <= mf->ncols; j++) {
+		csc_ptr_t deg = job.col_ptr[j];
+		job.col_ptr[j] = sum;
+		sum += deg;
+	}
+
+	job.row_idx = malloc((n + 1) * sizeof(csc_idx_t));
+	if (!job.row_idx) {
+		print_error(__func__, "malloc failed", errno);
+		goto fail;
+	}
+
+	/* Pass 3: scatter rows, advancing col_ptr[j] to the end of column j */
+	job.mode = MTX_EMIT_SCATTER;
+	if (job_parse(&job) == (size_t)-1)
+		goto fail;
+
+	/* End of column j is the start of column j + 1: shift back by one */
+	memmove(job.col_ptr + 1, job.col_ptr, mf->ncols * sizeof(csc_ptr_t));
+	job.col_ptr[0] = 0;
+
+	job_free(&job);
+
+	*col_ptr = job.col_ptr;
+	*row_idx = job.row_idx;
+	*count = n;
+	return 0;
+
+fail:
+	job_free(&job);
+	free(job.col_ptr);
+	free(job.row_idx);
+	return -1;
+}
+
+/**
+ * @copydoc mtx_read_edges()
+ */
+int
+mtx_read_edges(const MtxFile *mf, unsigned int n_threads,
+               mtx_edge_fn fn, void *ctx, size_t *count)
+{
+	mtx_job_t job;
+
+	if (job_alloc(&job, mf, n_threads) != 0)
+		goto fail;
+
+	job.mode     = MTX_EMIT_EDGES;
+	job.edge_fn  = fn;
+	job.edge_ctx = ctx;
+
+	/* Mapped files are a single block; streams are read block by block */
+	const char *body = mf->body;
+	const char *end = mf->map + mf->size;
+	size_t k = 0, n = 0;
+
+	for (;;) {
+		if (body < end) {
+			size_t lines = job_parse_edges(&job, body, end, k);
+			if (lines == (size_t)-1)
+				goto fail;
+			k += lines;
+
+			size_t written = 0;
+			for (unsigned int t = 0; t < job.n_threads; t++)
+				written += job.written[t];
+			n += written;
+		}
+
+		/* Entries already handed out cannot be taken back */
+		if (k > mf->nnz) {
+			print_error(__func__, "more entries than the size line declares", 0);
+			goto fail;
+		}
+
+		if (k == mf->nnz || !mf->stream)
+			break;
+
+		size_t len;
+		int ret = instream_next(mf->stream, &body, &len);
+		if (ret < 0)
+			goto fail;
+		if (ret == 0)
+			break;
+		end = body + len;
+	}
+
+	if (k < mf->nnz) {
+		print_error(__func__, "bad coordinate entry", 0);
+		goto fail;
+	}
+
+	job_free(&job);
+	*count = n;
+	return 0;
+
+fail:
+	job_free(&job);
+	return -1;
+}
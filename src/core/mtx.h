@@ -0,0 +1,144 @@
+/**
+ * @file mtx.h
+ * @brief Memory-mapped, multi-threaded Matrix Market (.mtx) reader.
+ *
+ * The file is mapped read-only, its header and size line are parsed
+ * serially, and the body is split into line-aligned chunks that are
+ * tokenized in parallel by a hand-written integer/float scanner.
+ *
+ * Compressed files are read through an InStream instead (see instream.h):
+ * each decompressed block is tokenized in parallel while the decompressor
+ * thread produces the next one.
+ *
+ * mtx_read_edges() streams the entries to a callback instead of storing
+ * them, for consumers that never need the matrix (see streamcc.h).
+ */
+
+#ifndef MTX_H
+#define MTX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "instream.h"
+#include "matrix.h"
+
+/**
+ * @struct MtxFile
+ * @brief A mapped Matrix Market file with its parsed banner and size line.
+ */
+typedef struct {
+	char *map;          /**< Mapped file contents (first block of a stream) */
+	size_t size;        /**< File size in bytes (first block size of a stream) */
+	InStream *stream;   /**< Source of the remaining blocks, NULL for mapped files */
+	const char *body;   /**< First byte after the size line */
+	int is_coordinate;  /**< 1 for `coordinate`, 0 for `array` */
+	int is_pattern;     /**< Entries carry no value */
+	int is_complex;     /**< Entries carry a real and an imaginary part */
+	int symmetric;      /**< `symmetric` header: mirror off-diagonal entries */
+	size_t nrows;       /**< Number of rows */
+	size_t ncols;       /**< Number of columns */
+	size_t nnz;         /**< Entries stored in the file (nrows * ncols for arrays) */
+} MtxFile;
+
+/**
+ * @brief Receives a batch of 0-based entries (rows[e], cols[e]).
+ *
+ * Called concurrently from every parser thread; the arrays are only valid
+ * during the call.
+ */
+typedef void (*mtx_edge_fn)(void *ctx, const csc_idx_t *rows,
+                            const csc_idx_t *cols, size_t n);
+
+/**
+ * @brief Maps a .mtx file and parses its banner and size line.
+ *
+ * @param filename Path to the .mtx file
+ * @param mf Output descriptor
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mtx_open(const char *filename, MtxFile *mf);
+
+/**
+ * @brief Parses the banner and size line from the first block of a stream.
+ *
+ * The stream stays owned by the caller and must outlive @p mf. Only
+ * mtx_read_coo() and mtx_read_edges() accept the resulting descriptor.
+ *
+ * @param in Open decompressing stream
+ * @param mf Output descriptor
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mtx_open_stream(InStream *in, MtxFile *mf);
+
+/**
+ * @brief Unmaps a file opened with mtx_open(). Safe on a zeroed descriptor.
+ */
+void mtx_close(MtxFile *mf);
+
+/**
+ * @brief Tokenizes all entries into 0-based COO arrays in parallel.
+ *
+ * Produces the same entry order as a serial scan of the file: explicit
+ * zeros are dropped and, for `symmetric` files, every off-diagonal entry
+ * (i,j) is immediately followed by its mirror (j,i).
+ *
+ * Streamed files are consumed block by block; the stream cannot be read
+ * again afterwards.
+ *
+ * @param mf Opened file
+ * @param n_threads Number of parser threads
+ * @param coo_i Output: newly allocated row indices
+ * @param coo_j Output: newly allocated column indices
+ * @param count Output: number of entries written
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mtx_read_coo(const MtxFile *mf, unsigned int n_threads,
+                 csc_idx_t **coo_i, csc_idx_t **coo_j, size_t *count);
+
+/**
+ * @brief Builds CSC arrays directly from the file in two tokenizing passes.
+ *
+ * The first pass counts the entries of every column, the second scatters
+ * row indices straight into their final slots, so no COO staging arrays
+ * are needed and peak memory equals the size of the resulting matrix.
+ * Each file entry is tokenized twice in exchange.
+ *
+ * The set of entries is the same as with mtx_read_coo(), but with more
+ * than one thread the order of rows within a column is unspecified.
+ * Streamed files are rejected, since they cannot be read twice.
+ *
+ * @param mf Opened file
+ * @param n_threads Number of parser threads
+ * @param col_ptr Output: newly allocated column pointers (ncols + 1)
+ * @param row_idx Output: newly allocated row indices
+ * @param count Output: number of entries
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mtx_read_csc(const MtxFile *mf, unsigned int n_threads,
+                 csc_ptr_t **col_ptr, csc_idx_t **row_idx, size_t *count);
+
+/**
+ * @brief Tokenizes all entries and hands them to @p fn, storing nothing.
+ *
+ * The set of entries is the same as with mtx_read_coo(), including the
+ * mirrors of `symmetric` files, but it arrives in batches of unspecified
+ * order and memory use does not grow with the file. Coordinate files are
+ * read in a single pass. Works on mapped and streamed files alike; a
+ * streamed file cannot be read again afterwards.
+ *
+ * Entries are handed out while the file is read, so a file that turns out
+ * to be malformed (including one with more entries than its size line
+ * declares) fails after some entries were already delivered.
+ *
+ * @param mf Opened file
+ * @param n_threads Number of parser threads
+ * @param fn Callback receiving every batch (see mtx_edge_fn)
+ * @param ctx First argument of @p fn
+ * @param count Output: number of entries delivered
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int mtx_read_edges(const MtxFile *mf, unsigned int n_threads,
+                   mtx_edge_fn fn, void *ctx, size_t *count);
+
+#endif /* MTX_H */
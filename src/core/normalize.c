@@ -0,0 +1,205 @@
+/**
+ * @file normalize.c
+ * @brief Canonical form of CSC matrices: sorted, unique, loop-free rows.
+ *
+ * Pass 1 sorts every column in place and compacts its kept rows to the
+ * front of the column's old range. A prefix sum over the kept counts
+ * gives the new column pointers, and pass 2 copies every column to its
+ * new offset in a fresh row_idx. Compacting across columns in place would
+ * let one thread's writes overrun another thread's unread columns, so it
+ * is done serially, and only where a fresh array cannot be used: for
+ * matrices backed by a .csc mapping, or when it cannot be allocated.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "normalize.h"
+#include "mem.h"
+#include "packed.h"
+#include "parallel.h"
+#include "error.h"
+#include "timer.h"
+
+/**
+ * @struct norm_job_t
+ * @brief State shared by the normalization threads.
+ */
+typedef struct {
+	CSCBinaryMatrix *m;   /* Matrix being normalized */
+	csc_ptr_t *new_ptr;   /* Pass 1: kept rows of column j at j + 1; then new col_ptr */
+	csc_idx_t *row_idx;   /* Pass 2 output */
+	size_t *duplicates;   /* Per thread: repeated entries dropped */
+	size_t *self_loops;   /* Per thread: diagonal entries dropped */
+} norm_job_t;
+
+/**
+ * @brief First column of thread @p tid's share, balanced by entries.
+ */
+static size_t
+col_split(const csc_ptr_t *col_ptr, size_t ncols, unsigned int n_threads, unsigned int tid)
+{
+	if (tid == n_threads)
+		return ncols;
+
+	size_t target = par_block_begin(col_ptr[ncols], n_threads, tid);
+	size_t lo = 0, hi = ncols;
+
+	/* First column whose entries start at or after target */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (col_ptr[mid] < target)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * @brief Pass 1: sorts and compacts one block of columns in place.
+ */
+static void
+compact_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	norm_job_t *job = arg;
+	CSCBinaryMatrix *m = job->m;
+	size_t begin = col_split(m->col_ptr, m->ncols, n_threads, tid);
+	size_t end   = col_split(m->col_ptr, m->ncols, n_threads, tid + 1);
+	size_t duplicates = 0, self_loops = 0;
+
+	for (size_t j = begin; j < end; j++) {
+		csc_idx_t *rows = m->row_idx + m->col_ptr[j];
+		size_t deg = m->col_ptr[j + 1] - m->col_ptr[j];
+
+		for (size_t e = 1; e < deg; e++) {
+			if (rows[e] < rows[e - 1]) {
+				qsort(rows, deg, sizeof(csc_idx_t), csc_idx_cmp);
+				break;
+			}
+		}
+
+		size_t kept = 0;
+		for (size_t e = 0; e < deg; e++) {
+			if (rows[e] == j)
+				self_loops++;
+			else if (kept > 0 && rows[kept - 1] == rows[e])
+				duplicates++;
+			else
+				rows[kept++] = rows[e];
+		}
+
+		job->new_ptr[j + 1] = kept;
+	}
+
+	job->duplicates[tid] = duplicates;
+	job->self_loops[tid] = self_loops;
+}
+
+/**
+ * @brief Pass 2: copies one block of compacted columns to their new offsets.
+ */
+static void
+move_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	norm_job_t *job = arg;
+	const CSCBinaryMatrix *m = job->m;
+	size_t begin = col_split(job->new_ptr, m->ncols, n_threads, tid);
+	size_t end   = col_split(job->new_ptr, m->ncols, n_threads, tid + 1);
+
+	for (size_t j = begin; j < end; j++)
+		memcpy(job->row_idx + job->new_ptr[j], m->row_idx + m->col_ptr[j],
+		       (job->new_ptr[j + 1] - job->new_ptr[j]) * sizeof(csc_idx_t));
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc csc_normalize_matrix()
+ */
+int
+csc_normalize_matrix(CSCBinaryMatrix *m, unsigned int n_threads)
+{
+	if (m->normalized)
+		return 0;
+
+	double t0 = now_sec();
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+	if (n_threads > m->ncols)
+		n_threads = m->ncols ? (unsigned int)m->ncols : 1;
+
+	norm_job_t job = { .m = m };
+	job.new_ptr    = malloc((m->ncols + 1) * sizeof(csc_ptr_t));
+	job.duplicates = malloc(n_threads * sizeof(size_t));
+	job.self_loops = malloc(n_threads * sizeof(size_t));
+
+	if (!job.new_ptr || !job.duplicates || !job.self_loops)
+		goto oom;
+
+	/* Pass 1: sort and compact every column */
+	par_run(n_threads, compact_worker, &job);
+
+	size_t duplicates = 0, self_loops = 0;
+	for (unsigned int t = 0; t < n_threads; t++) {
+		duplicates += job.duplicates[t];
+		self_loops += job.self_loops[t];
+	}
+
+	job.new_ptr[0] = 0;
+	for (size_t j = 0; j < m->ncols; j++)
+		job.new_ptr[j + 1] += job.new_ptr[j];
+
+	if (duplicates + self_loops > 0) {
+		size_t nnz = job.new_ptr[m->ncols];
+
+		if (!m->map_base)
+			job.row_idx = mem_alloc((nnz + 1) * sizeof(csc_idx_t), &m->mem, CSC_ACCESS_SEQUENTIAL);
+
+		if (job.row_idx) {
+			/* Pass 2: move the columns to their new offsets */
+			par_run(n_threads, move_worker, &job);
+			mem_free(m->row_idx, &m->mem);
+			m->row_idx = job.row_idx;
+		} else {
+			/* Columns only move left, so increasing order is safe */
+			for (size_t j = 0; j < m->ncols; j++)
+				memmove(m->row_idx + job.new_ptr[j], m->row_idx + m->col_ptr[j],
+				        (job.new_ptr[j + 1] - job.new_ptr[j]) * sizeof(csc_idx_t));
+		}
+
+		memcpy(m->col_ptr, job.new_ptr, (m->ncols + 1) * sizeof(csc_ptr_t));
+		m->nnz = nnz;
+	}
+
+	free(job.new_ptr);
+	free(job.duplicates);
+	free(job.self_loops);
+
+	m->normalized = 1;
+	m->load.duplicates_removed += duplicates;
+	m->load.self_loops_removed += self_loops;
+
+	int err = 0;
+	if (m->packed && duplicates + self_loops > 0) {
+		csc_packed_free(m->packed);
+		m->packed = NULL;
+		err = csc_pack_matrix(m, n_threads);
+	}
+
+	m->load.normalize_time_s += now_sec() - t0;
+	return err;
+
+oom:
+	print_error(__func__, "malloc failed", ENOMEM);
+	free(job.new_ptr);
+	free(job.duplicates);
+	free(job.self_loops);
+	return -1;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file normalize.h
+ * @brief Canonical form of CSC matrices: sorted, unique, loop-free rows.
+ *
+ * The loaders keep what the input holds: rows in file order within a
+ * column, repeated (i,j) entries and diagonal entries. None of these
+ * change the components, but every one costs the kernels a union or a
+ * label comparison. Normalization sorts the rows of every column and
+ * drops duplicates and self-loops, which leaves strictly increasing
+ * columns: the precondition of merge-based kernels and of gap encoding
+ * (see packed.h).
+ */
+
+#ifndef NORMALIZE_H
+#define NORMALIZE_H
+
+#include "matrix.h"
+
+/**
+ * @brief Normalizes a matrix in place and marks it as normalized.
+ *
+ * Columns are sorted and compacted in parallel, then moved to their new
+ * offsets in a second parallel pass (only when entries were removed; see
+ * normalize.c for when this step runs serially in place).
+ * The removed entries are counted in m->load and the time spent is
+ * recorded in m->load.normalize_time_s. Compressed row indices, if any,
+ * are rebuilt. Already normalized matrices are left untouched.
+ *
+ * @param m Matrix to normalize
+ * @param n_threads Number of threads (0 uses every online CPU)
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int csc_normalize_matrix(CSCBinaryMatrix *m, unsigned int n_threads);
+
+#endif /* NORMALIZE_H */
@@ -0,0 +1,224 @@
+/**
+ * @file packed.c
+ * @brief Compressed (delta + varint) CSC row indices.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "packed.h"
+#include "parallel.h"
+#include "error.h"
+#include "timer.h"
+
+/**
+ * @struct pack_job_t
+ * @brief State shared by the encoding threads.
+ */
+typedef struct {
+	const CSCBinaryMatrix *m; /* Matrix being compressed */
+	CSCPacked *pk;            /* Output */
+	int encode;               /* 0: size pass, 1: encoding pass */
+	int error;                /* Set when a scratch allocation fails */
+	int overflow;             /* Set when a column's stream exceeds CSC_PTR_MAX */
+} pack_job_t;
+
+/**
+ * @brief Number of bytes of the varint encoding of @p v.
+ */
+static inline size_t
+varint_size(csc_idx_t v)
+{
+	size_t n = 1;
+
+	while (v >= 0x80) {
+		v >>= 7;
+		n++;
+	}
+	return n;
+}
+
+/**
+ * @brief Writes the varint encoding of @p v and returns the next byte.
+ */
+static inline uint8_t *
+varint_put(uint8_t *p, csc_idx_t v)
+{
+	while (v >= 0x80) {
+		*p++ = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (uint8_t)v;
+	return p;
+}
+
+/**
+ * @brief First column of thread @p tid's share, balanced by entries.
+ */
+static size_t
+col_split(const CSCBinaryMatrix *m, unsigned int n_threads, unsigned int tid)
+{
+	if (tid == n_threads)
+		return m->ncols;
+
+	size_t target = par_block_begin(m->nnz, n_threads, tid);
+	size_t lo = 0, hi = m->ncols;
+
+	/* First column whose entries start at or after target */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (m->col_ptr[mid] < target)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * @brief Sizes (pass 1) or encodes (pass 2) one block of columns.
+ *
+ * Pass 1 stores the encoded length of column j in col_off[j + 1]; pass 2
+ * runs after the prefix sum and writes the bytes at col_off[j].
+ */
+static void
+pack_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	pack_job_t *job = arg;
+	const CSCBinaryMatrix *m = job->m;
+	CSCPacked *pk = job->pk;
+	size_t begin = col_split(m, n_threads, tid);
+	size_t end   = col_split(m, n_threads, tid + 1);
+	csc_idx_t *scratch = NULL;
+	size_t cap = 0;
+
+	for (size_t j = begin; j < end; j++) {
+		const csc_idx_t *rows = m->row_idx + m->col_ptr[j];
+		size_t deg = m->col_ptr[j + 1] - m->col_ptr[j];
+
+		/* Gaps must be non-negative: sort a copy of unsorted columns */
+		for (size_t e = 1; e < deg && !m->normalized; e++) {
+			if (rows[e] < rows[e - 1]) {
+				if (deg > cap) {
+					free(scratch);
+					cap = deg;
+					scratch = malloc(cap * sizeof(csc_idx_t));
+					if (!scratch) {
+						__atomic_store_n(&job->error, 1, __ATOMIC_RELAXED);
+						return;
+					}
+				}
+				memcpy(scratch, rows, deg * sizeof(csc_idx_t));
+				qsort(scratch, deg, sizeof(csc_idx_t), csc_idx_cmp);
+				rows = scratch;
+				break;
+			}
+		}
+
+		csc_idx_t prev = 0;
+
+		if (job->encode) {
+			uint8_t *p = pk->data + pk->col_off[j];
+			for (size_t e = 0; e < deg; e++) {
+				p = varint_put(p, rows[e] - prev);
+				prev = rows[e];
+			}
+		} else {
+			size_t bytes = 0;
+			for (size_t e = 0; e < deg; e++) {
+				bytes += varint_size(rows[e] - prev);
+				prev = rows[e];
+			}
+			if (bytes > CSC_PTR_MAX)
+				__atomic_store_n(&job->overflow, 1, __ATOMIC_RELAXED);
+			pk->col_off[j + 1] = (csc_ptr_t)bytes;
+		}
+	}
+
+	free(scratch);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc csc_pack_matrix()
+ */
+int
+csc_pack_matrix(CSCBinaryMatrix *m, unsigned int n_threads)
+{
+	double t0 = now_sec();
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+	if (n_threads > m->ncols)
+		n_threads = m->ncols ? (unsigned int)m->ncols : 1;
+
+	CSCPacked *pk = calloc(1, sizeof(CSCPacked));
+	if (!pk || !(pk->col_off = malloc((m->ncols + 1) * sizeof(csc_ptr_t)))) {
+		print_error(__func__, "malloc failed", errno);
+		free(pk);
+		return -1;
+	}
+	pk->ncols = m->ncols;
+
+	pack_job_t job = { .m = m, .pk = pk };
+
+	/* Pass 1: encoded length of every column */
+	par_run(n_threads, pack_worker, &job);
+	if (job.error)
+		goto oom;
+
+	uint64_t total = 0;
+	pk->col_off[0] = 0;
+	for (size_t j = 0; j < m->ncols && !job.overflow; j++) {
+		total += pk->col_off[j + 1];
+		if (total > CSC_PTR_MAX)
+			job.overflow = 1;
+		pk->col_off[j + 1] = (csc_ptr_t)total;
+	}
+	if (job.overflow) {
+		print_error(__func__, "compressed index exceeds the pointer width of this build (see make INDEX=)", 0);
+		csc_packed_free(pk);
+		return -1;
+	}
+	pk->data_bytes = total;
+
+	/* +1: malloc(0) may return NULL for an empty matrix */
+	pk->data = malloc(pk->data_bytes + 1);
+	if (!pk->data)
+		goto oom;
+
+	/* Pass 2: encode */
+	job.encode = 1;
+	par_run(n_threads, pack_worker, &job);
+	if (job.error)
+		goto oom;
+
+	csc_packed_free(m->packed);
+	m->packed = pk;
+	m->load.pack_time_s += now_sec() - t0;
+	return 0;
+
+oom:
+	print_error(__func__, "malloc failed", ENOMEM);
+	csc_packed_free(pk);
+	return -1;
+}
+
+/**
+ * @copydoc csc_packed_free()
+ */
+void
+csc_packed_free(CSCPacked *pk)
+{
+	if (!pk)
+		return;
+	free(pk->col_off);
+	free(pk->data);
+	free(pk);
+}
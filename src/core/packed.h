@@ -0,0 +1,104 @@
+/**
+ * @file packed.h
+ * @brief Compressed (delta + varint) CSC row indices.
+ *
+ * The rows of every column are sorted and stored as gaps from the previous
+ * row (the first one from 0), each gap as a little-endian base-128 varint:
+ * seven payload bits per byte, high bit set on every byte but the last.
+ * Neighbouring rows of real graphs are close together, so most gaps fit
+ * in one or two bytes instead of four.
+ *
+ * The kernels decode columns on the fly with csc_packed_col() and
+ * csc_packed_next(), trading a few instructions per edge for fewer bytes
+ * streamed from memory.
+ */
+
+#ifndef PACKED_H
+#define PACKED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "matrix.h"
+
+/**
+ * @struct CSCPacked
+ * @brief Varint-coded row indices of a CSC matrix.
+ */
+typedef struct CSCPacked {
+	size_t ncols;       /**< Number of columns */
+	csc_ptr_t *col_off; /**< Byte offset of each column's stream (ncols + 1) */
+	uint8_t *data;      /**< Concatenated column streams */
+	size_t data_bytes;  /**< Length of @p data */
+} CSCPacked;
+
+/**
+ * @struct CSCPackedIter
+ * @brief Decoding cursor over one column of a CSCPacked.
+ */
+typedef struct {
+	const uint8_t *p;    /**< Next byte to decode */
+	const uint8_t *end;  /**< End of the column's stream */
+	csc_idx_t row;       /**< Last decoded row */
+} CSCPackedIter;
+
+/**
+ * @brief Positions @p it at the start of column @p col.
+ */
+static inline void
+csc_packed_col(const CSCPacked *pk, size_t col, CSCPackedIter *it)
+{
+	it->p   = pk->data + pk->col_off[col];
+	it->end = pk->data + pk->col_off[col + 1];
+	it->row = 0;
+}
+
+/**
+ * @brief Decodes the next row of the column.
+ *
+ * @param it Column cursor
+ * @param row Output: next row index
+ * @return 1 if a row was decoded, 0 at the end of the column
+ */
+static inline int
+csc_packed_next(CSCPackedIter *it, csc_idx_t *row)
+{
+	if (it->p == it->end)
+		return 0;
+
+	csc_idx_t b = *it->p++;
+	csc_idx_t gap = b & 0x7f;
+
+	for (unsigned int shift = 7; b & 0x80; shift += 7) {
+		b = *it->p++;
+		gap |= (b & 0x7f) << shift;
+	}
+
+	*row = it->row += gap;
+	return 1;
+}
+
+/**
+ * @brief Builds the compressed row indices of @p m and attaches them as
+ *        m->packed.
+ *
+ * The plain arrays are left untouched, since normalization and reordering
+ * rebuild the matrix from them; once those are done, csc_mem_release_rows()
+ * gives back row_idx. Columns are encoded in parallel; unsorted columns
+ * are sorted in a per-thread scratch buffer first.
+ *
+ * The stream must fit csc_ptr_t offsets; with 32-bit pointers a matrix
+ * whose encoding exceeds 4 GiB needs make INDEX=64ptr.
+ *
+ * @param m Matrix to compress
+ * @param n_threads Number of threads (0 uses every online CPU)
+ * @return 0 on success, -1 on error (reported through print_error())
+ */
+int csc_pack_matrix(CSCBinaryMatrix *m, unsigned int n_threads);
+
+/**
+ * @brief Frees a CSCPacked. Safe to call with NULL.
+ */
+void csc_packed_free(CSCPacked *pk);
+
+#endif /* PACKED_H */
@@ -0,0 +1,88 @@
+/**
+ * @file parallel.c
+ * @brief Pthreads-based fork-join helpers for the core module.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+/**
+ * @struct par_thread_t
+ * @brief Per-thread arguments of a parallel region.
+ */
+typedef struct {
+	par_func_t fn;          /* Region body */
+	void *arg;              /* Shared user data */
+	unsigned int tid;       /* Thread index */
+	unsigned int n_threads; /* Number of threads in the region */
+} par_thread_t;
+
+/**
+ * @brief pthread entry point: unpacks the arguments and runs the body.
+ */
+static void *
+par_trampoline(void *arg)
+{
+	par_thread_t *t = arg;
+	t->fn(t->arg, t->tid, t->n_threads);
+	return NULL;
+}
+
+/**
+ * @copydoc par_run()
+ */
+void
+par_run(unsigned int n_threads, par_func_t fn, void *arg)
+{
+	if (n_threads <= 1) {
+		fn(arg, 0, 1);
+		return;
+	}
+
+	pthread_t *threads = malloc(n_threads * sizeof(pthread_t));
+	par_thread_t *targs = malloc(n_threads * sizeof(par_thread_t));
+	unsigned char *spawned = calloc(n_threads, 1);
+
+	if (!threads || !targs || !spawned) {
+		/* Out of memory: run every share on the calling thread */
+		for (unsigned int i = 0; i < n_threads; i++)
+			fn(arg, i, n_threads);
+		free(threads);
+		free(targs);
+		free(spawned);
+		return;
+	}
+
+	for (unsigned int i = 1; i < n_threads; i++) {
+		targs[i] = (par_thread_t){ fn, arg, i, n_threads };
+		spawned[i] = (pthread_create(&threads[i], NULL, par_trampoline, &targs[i]) == 0);
+	}
+
+	fn(arg, 0, n_threads);
+
+	for (unsigned int i = 1; i < n_threads; i++) {
+		if (spawned[i])
+			pthread_join(threads[i], NULL);
+		else
+			fn(arg, i, n_threads);
+	}
+
+	free(threads);
+	free(targs);
+	free(spawned);
+}
+
+/**
+ * @copydoc par_num_cpus()
+ */
+unsigned int
+par_num_cpus(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (unsigned int)n : 1;
+}
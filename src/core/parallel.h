@@ -0,0 +1,60 @@
+/**
+ * @file parallel.h
+ * @brief Minimal fork-join helpers shared by the matrix loaders.
+ *
+ * The core module is linked into every implementation (including the
+ * sequential one), so it cannot depend on OpenMP or OpenCilk. These helpers
+ * provide a small Pthreads-based parallel region that the loaders and
+ * preprocessing stages use for their embarrassingly parallel passes.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Body of a parallel region.
+ *
+ * @param arg User data shared by all threads
+ * @param tid Index of the calling thread in [0, n_threads)
+ * @param n_threads Total number of threads in the region
+ */
+typedef void (*par_func_t)(void *arg, unsigned int tid, unsigned int n_threads);
+
+/**
+ * @brief Runs @p fn on @p n_threads threads and waits for all of them.
+ *
+ * Thread 0 runs on the calling thread. If a worker thread cannot be created,
+ * its share of the work is executed by the calling thread instead, so the
+ * region always completes. For the same reason, bodies must not wait on
+ * each other (no barriers inside a region); split such work into several
+ * consecutive regions instead.
+ *
+ * @param n_threads Number of threads (0 is treated as 1)
+ * @param fn Function executed by every thread
+ * @param arg User data passed to @p fn
+ */
+void par_run(unsigned int n_threads, par_func_t fn, void *arg);
+
+/**
+ * @brief Returns the number of online processors (at least 1).
+ */
+unsigned int par_num_cpus(void);
+
+/**
+ * @brief Splits [0, n) into @p parts contiguous blocks and returns the
+ *        first index of block @p i.
+ *
+ * Block boundaries are balanced so sizes differ by at most one.
+ */
+static inline size_t
+par_block_begin(size_t n, unsigned int parts, unsigned int i)
+{
+	size_t base = n / parts;
+	size_t rem  = n % parts;
+
+	return i * base + (i < rem ? i : rem);
+}
+
+#endif /* PARALLEL_H */
@@ -0,0 +1,664 @@
+/**
+ * @file reorder.c
+ * @brief Vertex reordering of square CSC matrices for label locality.
+ *
+ * Every ordering produces inv[new] = old. The matrix is then rebuilt
+ * column by column: new column c is old column inv[c] with every row
+ * mapped through perm[old] = new and sorted.
+ *
+ * Degrees count both directions of every stored entry (its column and
+ * its row), without self-loops, so they are the undirected degrees for
+ * general, symmetric and half-stored inputs alike.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "reorder.h"
+#include "mem.h"
+#include "packed.h"
+#include "parallel.h"
+#include "error.h"
+#include "timer.h"
+
+#define GORDER_WINDOW  5    /**< Last placed vertices that score candidates */
+#define GORDER_HUB     64   /**< Common neighbours through larger vertices are ignored */
+#define GORDER_BUCKETS 256  /**< Score buckets; higher scores share the last one */
+
+#define NIL CSC_IDX_MAX     /**< End of a bucket list */
+
+/* ------------------------------------------------------------------------- */
+/*                                  Helpers                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Sorts a short run of row indices (qsort() for long ones).
+ */
+static void
+sort_rows(csc_idx_t *rows, size_t n)
+{
+	if (n > 32) {
+		qsort(rows, n, sizeof(csc_idx_t), csc_idx_cmp);
+		return;
+	}
+
+	for (size_t a = 1; a < n; a++) {
+		csc_idx_t v = rows[a];
+		size_t b = a;
+		while (b > 0 && rows[b - 1] > v) {
+			rows[b] = rows[b - 1];
+			b--;
+		}
+		rows[b] = v;
+	}
+}
+
+/**
+ * @brief First column of thread @p tid's share, balanced by entries.
+ */
+static size_t
+col_split(const csc_ptr_t *col_ptr, size_t ncols, unsigned int n_threads, unsigned int tid)
+{
+	if (tid == n_threads)
+		return ncols;
+
+	size_t target = par_block_begin(col_ptr[ncols], n_threads, tid);
+	size_t lo = 0, hi = ncols;
+
+	/* First column whose entries start at or after target */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (col_ptr[mid] < target)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * @brief Counting sort of the vertices by degree, ties by vertex index.
+ *
+ * @param n Number of vertices
+ * @param deg Degree of every vertex
+ * @param descending 1 for the highest degree first
+ * @param out Output: the n vertices in order
+ * @return 0 on success, -1 if out of memory
+ */
+static int
+sort_by_degree(size_t n, const csc_ptr_t *deg, int descending, csc_idx_t *out)
+{
+	csc_ptr_t max_deg = 0;
+	for (size_t v = 0; v < n; v++)
+		if (deg[v] > max_deg)
+			max_deg = deg[v];
+
+	size_t *start = calloc((size_t)max_deg + 2, sizeof(size_t));
+	if (!start)
+		return -1;
+
+	for (size_t v = 0; v < n; v++)
+		start[(descending ? max_deg - deg[v] : deg[v]) + 1]++;
+	for (size_t d = 1; d <= max_deg + 1; d++)
+		start[d] += start[d - 1];
+	for (size_t v = 0; v < n; v++)
+		out[start[descending ? max_deg - deg[v] : deg[v]]++] = (csc_idx_t)v;
+
+	free(start);
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                             Degrees and Adjacency                         */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @struct degree_job_t
+ * @brief State shared by the degree counting threads.
+ */
+typedef struct {
+	const CSCBinaryMatrix *m; /* Matrix being reordered */
+	csc_ptr_t *deg;           /* Output: undirected degree of every vertex */
+} degree_job_t;
+
+/**
+ * @brief Counts both endpoints of the entries of one block of columns.
+ *
+ * Row counters are shared between threads; with a single thread they are
+ * updated with plain increments.
+ */
+static void
+degree_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	degree_job_t *job = arg;
+	const CSCBinaryMatrix *m = job->m;
+	size_t begin = col_split(m->col_ptr, m->ncols, n_threads, tid);
+	size_t end   = col_split(m->col_ptr, m->ncols, n_threads, tid + 1);
+	int shared = n_threads > 1;
+
+	for (size_t j = begin; j < end; j++) {
+		csc_ptr_t own = 0;
+
+		for (csc_ptr_t e = m->col_ptr[j]; e < m->col_ptr[j + 1]; e++) {
+			csc_idx_t i = m->row_idx[e];
+			if (i == j)
+				continue;
+			own++;
+			if (shared)
+				__atomic_fetch_add(&job->deg[i], 1, __ATOMIC_RELAXED);
+			else
+				job->deg[i]++;
+		}
+
+		if (shared)
+			__atomic_fetch_add(&job->deg[j], own, __ATOMIC_RELAXED);
+		else
+			job->deg[j] += own;
+	}
+}
+
+/**
+ * @struct adj_t
+ * @brief Undirected adjacency: every stored entry in both directions.
+ */
+typedef struct {
+	csc_ptr_t *ptr;  /* First neighbour of every vertex (n + 1) */
+	csc_idx_t *idx;  /* Neighbours; symmetric inputs list each one twice */
+} adj_t;
+
+/**
+ * @brief Builds the undirected adjacency of @p m from its degrees.
+ *
+ * Filled serially so the neighbour order, and with it the Gorder
+ * tie-breaking, does not depend on the thread count.
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int
+build_adj(const CSCBinaryMatrix *m, const csc_ptr_t *deg, adj_t *g)
+{
+	size_t n = m->ncols;
+
+	g->ptr = malloc((n + 1) * sizeof(csc_ptr_t));
+	csc_ptr_t *cur = malloc((n + 1) * sizeof(csc_ptr_t));
+	if (!g->ptr || !cur) {
+		free(cur);
+		return -1;
+	}
+
+	g->ptr[0] = 0;
+	for (size_t v = 0; v < n; v++)
+		g->ptr[v + 1] = g->ptr[v] + deg[v];
+
+	g->idx = malloc((g->ptr[n] + 1) * sizeof(csc_idx_t));
+	if (!g->idx) {
+		free(cur);
+		return -1;
+	}
+
+	memcpy(cur, g->ptr, n * sizeof(csc_ptr_t));
+	for (size_t j = 0; j < n; j++) {
+		for (csc_ptr_t e = m->col_ptr[j]; e < m->col_ptr[j + 1]; e++) {
+			csc_idx_t i = m->row_idx[e];
+			if (i == j)
+				continue;
+			g->idx[cur[i]++] = (csc_idx_t)j;
+			g->idx[cur[j]++] = i;
+		}
+	}
+
+	free(cur);
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                 Orderings                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @struct deg_key_t
+ * @brief Sort key of the Cuthill-McKee neighbour order.
+ */
+typedef struct {
+	csc_ptr_t deg;
+	csc_idx_t v;
+} deg_key_t;
+
+/**
+ * @brief Orders keys by degree, then by vertex index.
+ */
+static int
+cmp_key(const void *a, const void *b)
+{
+	const deg_key_t *x = a, *y = b;
+
+	if (x->deg != y->deg)
+		return (x->deg > y->deg) - (x->deg < y->deg);
+	return (x->v > y->v) - (x->v < y->v);
+}
+
+/**
+ * @brief Reverse Cuthill-McKee.
+ *
+ * Components are started from their lowest-degree vertex (a cheap
+ * stand-in for a pseudo-peripheral one); the vertices discovered from
+ * each dequeued vertex are appended in increasing degree.
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int
+order_rcm(size_t n, const adj_t *g, const csc_ptr_t *deg, csc_idx_t *inv)
+{
+	csc_ptr_t max_deg = 0;
+	for (size_t v = 0; v < n; v++)
+		if (deg[v] > max_deg)
+			max_deg = deg[v];
+
+	csc_idx_t *starts = malloc((n + 1) * sizeof(csc_idx_t));
+	uint8_t *seen = calloc(n + 1, 1);
+	deg_key_t *keys = malloc(((size_t)max_deg + 1) * sizeof(deg_key_t));
+	int ret = -1;
+
+	if (!starts || !seen || !keys || sort_by_degree(n, deg, 0, starts) != 0)
+		goto out;
+
+	size_t tail = 0;
+	for (size_t s = 0; s < n; s++) {
+		csc_idx_t root = starts[s];
+		if (seen[root])
+			continue;
+
+		seen[root] = 1;
+		inv[tail++] = root;
+
+		for (size_t head = tail - 1; head < tail; head++) {
+			csc_idx_t v = inv[head];
+			size_t k = 0;
+
+			for (csc_ptr_t e = g->ptr[v]; e < g->ptr[v + 1]; e++) {
+				csc_idx_t w = g->idx[e];
+				if (seen[w])
+					continue;
+				seen[w] = 1;
+				keys[k].deg = deg[w];
+				keys[k].v = w;
+				k++;
+			}
+
+			qsort(keys, k, sizeof(deg_key_t), cmp_key);
+			for (size_t a = 0; a < k; a++)
+				inv[tail++] = keys[a].v;
+		}
+	}
+
+	/* Reverse */
+	for (size_t a = 0, b = n; a + 1 < b; a++, b--) {
+		csc_idx_t t = inv[a];
+		inv[a] = inv[b - 1];
+		inv[b - 1] = t;
+	}
+	ret = 0;
+
+out:
+	free(starts);
+	free(seen);
+	free(keys);
+	return ret;
+}
+
+/**
+ * @struct gorder_heap_t
+ * @brief Unplaced vertices bucketed by score, for O(1) +-1 updates.
+ */
+typedef struct {
+	csc_ptr_t *score;                  /* Score of every vertex */
+	csc_idx_t *next;                   /* Next vertex in the same bucket */
+	csc_idx_t *prev;                   /* Previous vertex in the same bucket */
+	uint8_t *placed;                   /* Vertex already has its new index */
+	csc_idx_t head[GORDER_BUCKETS];    /* First vertex of every bucket */
+	unsigned int top;                  /* No bucket above this one is non-empty */
+} gorder_heap_t;
+
+/**
+ * @brief Bucket of a score.
+ */
+static inline unsigned int
+bucket(csc_ptr_t score)
+{
+	return score < GORDER_BUCKETS ? (unsigned int)score : GORDER_BUCKETS - 1;
+}
+
+/**
+ * @brief Inserts @p v at the head of the bucket of its score.
+ */
+static inline void
+heap_link(gorder_heap_t *h, csc_idx_t v)
+{
+	unsigned int b = bucket(h->score[v]);
+
+	h->prev[v] = NIL;
+	h->next[v] = h->head[b];
+	if (h->head[b] != NIL)
+		h->prev[h->head[b]] = v;
+	h->head[b] = v;
+	if (b > h->top)
+		h->top = b;
+}
+
+/**
+ * @brief Removes @p v from the bucket of its score.
+ */
+static inline void
+heap_unlink(gorder_heap_t *h, csc_idx_t v)
+{
+	if (h->prev[v] != NIL)
+		h->next[h->prev[v]] = h->next[v];
+	else
+		h->head[bucket(h->score[v])] = h->next[v];
+	if (h->next[v] != NIL)
+		h->prev[h->next[v]] = h->prev[v];
+}
+
+/**
+ * @brief Adds @p delta (+1 or -1) to the score of an unplaced vertex.
+ */
+static inline void
+heap_bump(gorder_heap_t *h, csc_idx_t v, int delta)
+{
+	if (h->placed[v])
+		return;
+
+	heap_unlink(h, v);
+	h->score[v] += delta > 0 ? 1 : (csc_ptr_t)-1;
+	heap_link(h, v);
+}
+
+/**
+ * @brief Adds the contribution of a window vertex @p u to the scores of
+ *        its neighbours and of its neighbours' neighbours.
+ */
+static void
+gorder_update(gorder_heap_t *h, const adj_t *g, const csc_ptr_t *deg, csc_idx_t u, int delta)
+{
+	for (csc_ptr_t e = g->ptr[u]; e < g->ptr[u + 1]; e++) {
+		csc_idx_t x = g->idx[e];
+
+		heap_bump(h, x, delta);
+
+		if (deg[x] > GORDER_HUB)
+			continue;
+		for (csc_ptr_t f = g->ptr[x]; f < g->ptr[x + 1]; f++)
+			if (g->idx[f] != u)
+				heap_bump(h, g->idx[f], delta);
+	}
+}
+
+/**
+ * @brief Gorder-style greedy ordering.
+ *
+ * The score of a candidate is the number of edges and common neighbours
+ * it shares with the last GORDER_WINDOW placed vertices; the best one is
+ * placed next. With no candidate left, the highest-degree unplaced vertex
+ * starts a new run.
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int
+order_gorder(size_t n, const adj_t *g, const csc_ptr_t *deg, csc_idx_t *inv)
+{
+	gorder_heap_t h;
+	csc_idx_t *by_deg = malloc((n + 1) * sizeof(csc_idx_t));
+	int ret = -1;
+
+	h.score  = calloc(n + 1, sizeof(csc_ptr_t));
+	h.next   = malloc((n + 1) * sizeof(csc_idx_t));
+	h.prev   = malloc((n + 1) * sizeof(csc_idx_t));
+	h.placed = calloc(n + 1, 1);
+	h.top    = 0;
+	for (unsigned int b = 0; b < GORDER_BUCKETS; b++)
+		h.head[b] = NIL;
+
+	if (!by_deg || !h.score || !h.next || !h.prev || !h.placed ||
+	    sort_by_degree(n, deg, 0, by_deg) != 0)
+		goto out;
+
+	/* Linked in increasing degree: the highest degree ends up first */
+	for (size_t k = 0; k < n; k++)
+		heap_link(&h, by_deg[k]);
+
+	for (size_t k = 0; k < n; k++) {
+		while (h.top > 0 && h.head[h.top] == NIL)
+			h.top--;
+
+		csc_idx_t v = h.head[h.top];
+		heap_unlink(&h, v);
+		h.placed[v] = 1;
+		inv[k] = v;
+
+		gorder_update(&h, g, deg, v, +1);
+		if (k >= GORDER_WINDOW)
+			gorder_update(&h, g, deg, inv[k - GORDER_WINDOW], -1);
+	}
+	ret = 0;
+
+out:
+	free(by_deg);
+	free(h.score);
+	free(h.next);
+	free(h.prev);
+	free(h.placed);
+	return ret;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Permutation                                */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @struct permute_job_t
+ * @brief State shared by the threads rebuilding the matrix.
+ */
+typedef struct {
+	const CSCBinaryMatrix *m; /* Matrix in the old numbering */
+	const csc_idx_t *perm;    /* perm[old] = new */
+	const csc_idx_t *inv;     /* inv[new] = old */
+	const csc_ptr_t *col_ptr; /* New column pointers */
+	csc_idx_t *row_idx;       /* Output: new row indices */
+} permute_job_t;
+
+/**
+ * @brief Fills one block of new columns with renumbered, sorted rows.
+ *
+ * Under CSC_NUMA_LOCAL the thread is pinned like thread @p tid of
+ * csc_mem_place(), so the new row_idx keeps that placement.
+ */
+static void
+permute_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	permute_job_t *job = arg;
+	const CSCBinaryMatrix *m = job->m;
+	size_t begin = col_split(job->col_ptr, m->ncols, n_threads, tid);
+	size_t end   = col_split(job->col_ptr, m->ncols, n_threads, tid + 1);
+
+	if (m->mem.numa == CSC_NUMA_LOCAL)
+		mem_pin_thread(tid);
+
+	for (size_t c = begin; c < end; c++) {
+		csc_idx_t v = job->inv[c];
+		const csc_idx_t *src = m->row_idx + m->col_ptr[v];
+		csc_idx_t *dst = job->row_idx + job->col_ptr[c];
+		size_t deg = job->col_ptr[c + 1] - job->col_ptr[c];
+
+		for (size_t e = 0; e < deg; e++)
+			dst[e] = job->perm[src[e]];
+		sort_rows(dst, deg);
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc csc_order_name()
+ */
+const char *
+csc_order_name(CSCOrder order)
+{
+	switch (order) {
+	case CSC_ORDER_NONE:   return "none";
+	case CSC_ORDER_DEGREE: return "degree";
+	case CSC_ORDER_RCM:    return "rcm";
+	case CSC_ORDER_GORDER: return "gorder";
+	}
+	return "unknown";
+}
+
+/**
+ * @copydoc csc_reorder_matrix()
+ */
+int
+csc_reorder_matrix(CSCBinaryMatrix *m, CSCOrder order, unsigned int n_threads)
+{
+	if (order == CSC_ORDER_NONE)
+		return 0;
+
+	if (m->nrows != m->ncols) {
+		print_error(__func__, "reordering needs a square matrix", 0);
+		return -1;
+	}
+
+	if (order != CSC_ORDER_DEGREE && m->nnz > CSC_PTR_MAX / 2) {
+		print_error(__func__, "matrix exceeds the index width of this build (see make INDEX=)", 0);
+		return -1;
+	}
+
+	double t0 = now_sec();
+	size_t n = m->ncols;
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+	if (n_threads > n)
+		n_threads = n ? (unsigned int)n : 1;
+
+	csc_ptr_t *deg = calloc(n + 1, sizeof(csc_ptr_t));
+	csc_idx_t *inv = malloc((n + 1) * sizeof(csc_idx_t));
+	csc_idx_t *perm = malloc((n + 1) * sizeof(csc_idx_t));
+	csc_ptr_t *col_ptr = NULL;
+	csc_idx_t *row_idx = NULL;
+	adj_t g = { NULL, NULL };
+	int err = -1;
+
+	if (!deg || !inv || !perm)
+		goto oom;
+
+	degree_job_t dj = { .m = m, .deg = deg };
+	par_run(n_threads, degree_worker, &dj);
+
+	switch (order) {
+	case CSC_ORDER_DEGREE:
+		err = sort_by_degree(n, deg, 1, inv);
+		break;
+	case CSC_ORDER_RCM:
+		err = build_adj(m, deg, &g) || order_rcm(n, &g, deg, inv);
+		break;
+	case CSC_ORDER_GORDER:
+		err = build_adj(m, deg, &g) || order_gorder(n, &g, deg, inv);
+		break;
+	default:
+		print_error(__func__, "unknown vertex ordering", 0);
+		goto fail;
+	}
+
+	free(g.ptr);
+	free(g.idx);
+	g.ptr = NULL;
+	g.idx = NULL;
+
+	if (err)
+		goto oom;
+
+	for (size_t k = 0; k < n; k++)
+		perm[inv[k]] = (csc_idx_t)k;
+
+	/* New column c is old column inv[c] */
+	col_ptr = mem_alloc((n + 1) * sizeof(csc_ptr_t), &m->mem, CSC_ACCESS_SEQUENTIAL);
+	row_idx = mem_alloc((m->nnz + 1) * sizeof(csc_idx_t), &m->mem, CSC_ACCESS_SEQUENTIAL);
+	if (!col_ptr || !row_idx)
+		goto oom;
+
+	col_ptr[0] = 0;
+	for (size_t c = 0; c < n; c++)
+		col_ptr[c + 1] = col_ptr[c] + (m->col_ptr[inv[c] + 1] - m->col_ptr[inv[c]]);
+
+	permute_job_t pj = {
+		.m = m, .perm = perm, .inv = inv, .col_ptr = col_ptr, .row_idx = row_idx
+	};
+	par_run(n_threads, permute_worker, &pj);
+	if (m->mem.numa == CSC_NUMA_LOCAL)
+		mem_unpin_thread();
+
+	/* Swap in the new arrays */
+	if (m->map_base) {
+		munmap(m->map_base, m->map_size);
+		m->map_base = NULL;
+		m->map_size = 0;
+	} else {
+		mem_free(m->col_ptr, &m->mem);
+		mem_free(m->row_idx, &m->mem);
+	}
+	m->col_ptr = col_ptr;
+	m->row_idx = row_idx;
+
+	if (m->perm) {
+		for (size_t v = 0; v < n; v++)
+			m->perm[v] = perm[m->perm[v]];
+		free(perm);
+	} else {
+		m->perm = perm;
+	}
+	free(deg);
+	free(inv);
+
+	err = 0;
+	if (m->packed) {
+		csc_packed_free(m->packed);
+		m->packed = NULL;
+		err = csc_pack_matrix(m, n_threads);
+	}
+
+	m->load.reorder_time_s += now_sec() - t0;
+	return err;
+
+oom:
+	print_error(__func__, "malloc failed", ENOMEM);
+fail:
+	free(g.ptr);
+	free(g.idx);
+	free(deg);
+	free(inv);
+	free(perm);
+	mem_free(col_ptr, &m->mem);
+	mem_free(row_idx, &m->mem);
+	return -1;
+}
+
+/**
+ * @copydoc csc_unpermute()
+ */
+void
+csc_unpermute(const CSCBinaryMatrix *m, const csc_idx_t *in, csc_idx_t *out)
+{
+	if (!m->perm) {
+		memcpy(out, in, m->nrows * sizeof(csc_idx_t));
+		return;
+	}
+
+	for (size_t v = 0; v < m->nrows; v++)
+		out[v] = in[m->perm[v]];
+}
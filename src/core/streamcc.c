@@ -0,0 +1,218 @@
+/**
+ * @file streamcc.c
+ * @brief Connected components counted straight from a .mtx edge stream.
+ *
+ * The union-find is lock-free so the parser threads never wait on each
+ * other: roots are linked with a compare-and-swap, always the larger index
+ * below the smaller, and finds halve the path as they walk it. Parents only
+ * ever move to smaller indices, so a stale read sees an ancestor and at
+ * worst costs a retry.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "streamcc.h"
+#include "instream.h"
+#include "mtx.h"
+#include "parallel.h"
+#include "error.h"
+#include "timer.h"
+
+/**
+ * @struct stream_job_t
+ * @brief State shared by the parser threads and the counting pass.
+ */
+typedef struct {
+	csc_idx_t *parent;  /* Union-find forest over the vertices */
+	size_t n;           /* Number of vertices */
+	size_t *roots;      /* Per thread: roots found by count_worker() */
+} stream_job_t;
+
+/**
+ * @brief Finds the root of @p x, pointing every visited vertex at its
+ *        grandparent (path halving).
+ *
+ * Only non-roots are rewritten, and a non-root never becomes a root
+ * again, so the halving stores cannot undo a link.
+ */
+static inline csc_idx_t
+find_halve(csc_idx_t *parent, csc_idx_t x)
+{
+	csc_idx_t p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+
+	while (p != x) {
+		csc_idx_t gp = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+		if (gp != p)
+			__atomic_store_n(&parent[x], gp, __ATOMIC_RELAXED);
+		x = p;
+		p = gp;
+	}
+
+	return x;
+}
+
+/**
+ * @brief Unites the sets of @p a and @p b (Rem-style: the larger root is
+ *        linked below the smaller one).
+ */
+static inline void
+union_rem(csc_idx_t *parent, csc_idx_t a, csc_idx_t b)
+{
+	for (;;) {
+		a = find_halve(parent, a);
+		b = find_halve(parent, b);
+
+		if (a == b)
+			return;
+
+		if (a < b) {
+			csc_idx_t t = a;
+			a = b;
+			b = t;
+		}
+
+		/* Fails only if another thread linked a first: retry from there */
+		csc_idx_t expected = a;
+		if (__atomic_compare_exchange_n(&parent[a], &expected, b, 0,
+		                                __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return;
+	}
+}
+
+/**
+ * @brief mtx_edge_fn: unions one batch of entries.
+ */
+static void
+union_batch(void *ctx, const csc_idx_t *rows, const csc_idx_t *cols, size_t n)
+{
+	stream_job_t *job = ctx;
+
+	for (size_t e = 0; e < n; e++)
+		if (rows[e] != cols[e])
+			union_rem(job->parent, rows[e], cols[e]);
+}
+
+/**
+ * @brief Makes every vertex of one block its own root.
+ */
+static void
+init_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	stream_job_t *job = arg;
+	size_t begin = par_block_begin(job->n, n_threads, tid);
+	size_t end   = par_block_begin(job->n, n_threads, tid + 1);
+
+	for (size_t v = begin; v < end; v++)
+		job->parent[v] = (csc_idx_t)v;
+}
+
+/**
+ * @brief Counts the roots of one block.
+ */
+static void
+count_worker(void *arg, unsigned int tid, unsigned int n_threads)
+{
+	stream_job_t *job = arg;
+	size_t begin = par_block_begin(job->n, n_threads, tid);
+	size_t end   = par_block_begin(job->n, n_threads, tid + 1);
+	size_t roots = 0;
+
+	for (size_t v = begin; v < end; v++)
+		roots += (job->parent[v] == v);
+
+	job->roots[tid] = roots;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                Public API                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @copydoc streamcc_count()
+ */
+long
+streamcc_count(const char *filename, unsigned int n_threads, StreamCCStats *stats)
+{
+	MtxFile mf;
+	InStream *in = NULL;
+	InStreamFormat fmt = instream_format(filename);
+	stream_job_t job = { 0 };
+	long components = -1;
+	size_t edges = 0;
+
+	const char *dot = strrchr(filename, '.');
+	if (fmt == INSTREAM_NONE && (!dot || strcasecmp(dot, ".mtx") != 0)) {
+		print_error(__func__, "edge streaming needs a .mtx input (possibly compressed)", 0);
+		return -1;
+	}
+
+	if (n_threads == 0)
+		n_threads = par_num_cpus();
+
+	unsigned int parse_threads = n_threads;
+	double t0 = now_sec();
+
+	if (fmt != INSTREAM_NONE) {
+		in = instream_open(filename, fmt);
+		if (!in)
+			return -1;
+		if (mtx_open_stream(in, &mf) != 0) {
+			instream_close(in);
+			return -1;
+		}
+		/* The decompressor thread takes one of the threads */
+		parse_threads = n_threads > 1 ? n_threads - 1 : 1;
+	} else if (mtx_open(filename, &mf) != 0) {
+		return -1;
+	}
+
+	/* A union is undirected: mirroring would only repeat it */
+	mf.symmetric = 0;
+
+	double t1 = now_sec();
+
+	job.n = mf.nrows > mf.ncols ? mf.nrows : mf.ncols;
+	if (job.n > CSC_IDX_MAX) {
+		print_error(__func__, "matrix exceeds the index width of this build (see make INDEX=)", 0);
+		goto out;
+	}
+
+	job.parent = malloc((job.n + 1) * sizeof(csc_idx_t));
+	job.roots  = malloc(n_threads * sizeof(size_t));
+	if (!job.parent || !job.roots) {
+		print_error(__func__, "malloc failed", errno);
+		goto out;
+	}
+
+	par_run(n_threads, init_worker, &job);
+
+	if (mtx_read_edges(&mf, parse_threads, union_batch, &job, &edges) != 0)
+		goto out;
+
+	par_run(n_threads, count_worker, &job);
+
+	components = 0;
+	for (unsigned int t = 0; t < n_threads; t++)
+		components += (long)job.roots[t];
+
+	if (stats) {
+		stats->nrows = mf.nrows;
+		stats->ncols = mf.ncols;
+		stats->edges = edges;
+		stats->input_bytes = in ? instream_bytes(in) : mf.size;
+		stats->io_time_s = t1 - t0;
+		stats->stream_time_s = now_sec() - t1;
+	}
+
+out:
+	mtx_close(&mf);
+	instream_close(in);
+	free(job.parent);
+	free(job.roots);
+	return components;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file streamcc.h
+ * @brief Connected components counted straight from a .mtx edge stream.
+ *
+ * Counting components does not need the matrix: union-find only keeps a
+ * parent per vertex. Here the parser threads of mtx_read_edges() union
+ * every entry as soon as it is tokenized, while the rest of the file is
+ * still being read. Memory is O(vertices) instead of O(edges), on top of
+ * the file mapping (paged in and out by the kernel) or the decompressor's
+ * buffers, and a run takes about as long as parsing the file.
+ */
+
+#ifndef STREAMCC_H
+#define STREAMCC_H
+
+#include <stddef.h>
+
+/**
+ * @struct StreamCCStats
+ * @brief Measurements of one streaming run.
+ */
+typedef struct {
+	size_t nrows;         /**< Rows declared by the size line */
+	size_t ncols;         /**< Columns declared by the size line */
+	size_t edges;         /**< Entries unioned (explicit zeros dropped, never mirrored) */
+	size_t input_bytes;   /**< Size of the parsed input in bytes (decompressed for .gz/.xz/.zst) */
+	double io_time_s;     /**< Wall time spent opening the file and reading its header */
+	double stream_time_s; /**< Wall time spent tokenizing and unioning the entries */
+} StreamCCStats;
+
+/**
+ * @brief Counts the connected components of a .mtx file without building it.
+ *
+ * Accepts plain and compressed Matrix Market files (see instream.h).
+ * Vertices are 0 .. max(nrows, ncols) - 1. The mirrors of `symmetric`
+ * files are skipped, since a union is undirected anyway.
+ *
+ * @param filename Path to the .mtx file, possibly compressed
+ * @param n_threads Number of threads (0 uses every online CPU); compressed
+ *        inputs give one of them to the decompressor
+ * @param stats Output: measurements of the run (may be NULL)
+ * @return Number of connected components, or -1 on error (reported
+ *         through print_error())
+ */
+long streamcc_count(const char *filename, unsigned int n_threads, StreamCCStats *stats);
+
+#endif /* STREAMCC_H */
@@ -18,11 +18,13 @@
  * - USE_PTHREADS
  * - USE_CILK
  *
- * Usage: ./connected_components [-t n_threads] [-n n_trials] ./data_filepath
+ * Usage: ./connected_components [-t n_threads] [-n n_trials] [-v variant] [-l load_mode] [-c] [-s] [-d] [-e] [-m MiB] [-r order] [-p policy] [-g pages] [-o labels] ./data_filepath
  */
 
 #include "connected_components.h"
 #include "matrix.h"
+#include "mem.h"
+#include "packed.h"
 #include "error.h"
 #include "benchmark.h"
 #include "args.h"
@@ -46,50 +48,89 @@ main(int argc, char *argv[])
 {
 	CSCBinaryMatrix *matrix;
 	Benchmark *benchmark = NULL;
-	char *filepath;
-	unsigned int n_trials;
-	unsigned int n_threads;
-	unsigned int algorithm_variant;
+	Args args;
 	int ret = 0;
-	int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const unsigned int);
 
 	/* Initialize program name for error reporting */
 	set_program_name(argv[0]);
 
 	/* Parse command line arguments */
-	if (parseargs(argc, argv, &n_threads, &n_trials, &algorithm_variant, &filepath)) {
+	if (parseargs(argc, argv, &args)) {
 		return 1;
 	}
+
+	/* Edge streaming: union-find runs inside the parser, no matrix is built */
+	if (args.stream) {
+		benchmark = benchmark_init(IMPLEMENTATION_NAME, args.filepath, args.n_trials, args.n_threads, 1, NULL);
+		if (!benchmark)
+			return 1;
+
+		ret = benchmark_stream(args.filepath, benchmark);
+		if (ret == 0)
+			benchmark_print(benchmark);
+		benchmark_free(benchmark);
+		return ret;
+	}
+
+	/* Out-of-core: only the labels and two blocks of the .csc file are resident */
+	if (args.memory_mb) {
+		benchmark = benchmark_init(IMPLEMENTATION_NAME, args.filepath, args.n_trials, args.n_threads, args.algorithm_variant, NULL);
+		if (!benchmark)
+			return 1;
+
+		ret = benchmark_external(args.filepath, args.memory_mb, benchmark);
+		if (ret == 0)
+			benchmark_print(benchmark);
+		benchmark_free(benchmark);
+		return ret;
+	}
 	
 	/* Load the sparse matrix */
-	matrix = csc_load_matrix(filepath);
+	CSCLoadOptions load_opts = {
+		.n_threads = args.n_threads,
+		.build = args.build_mode,
+		.half = args.half,
+		.normalize = args.normalize,
+		.mem = { .numa = args.numa, .huge = args.huge }
+	};
+
+	matrix = csc_load_matrix_opts(args.filepath, &load_opts);
 	if (!matrix)
 		return 1;
 
+	/* Optionally switch the kernels to compressed row indices */
+	if (args.compress && csc_pack_matrix(matrix, args.n_threads) != 0) {
+		csc_free_matrix(matrix);
+		return 1;
+	}
+
 	/* Initialize benchmarking structure */
-	benchmark = benchmark_init(IMPLEMENTATION_NAME, filepath, n_trials, n_threads, algorithm_variant, matrix);
+	benchmark = benchmark_init(IMPLEMENTATION_NAME, args.filepath, args.n_trials, args.n_threads, args.algorithm_variant, matrix);
 	if (!benchmark) {
 		csc_free_matrix(matrix);
 		return 1;
 	}
 
-	/* Implementation is selected by the preproccesor.
-	 * (definitions made through compiler flags)
-	 */
-	#if defined(USE_OPENMP)
-	cc_func = cc_openmp;
-	#elif defined(USE_PTHREADS)
-	cc_func = cc_pthreads;
-	#elif defined(USE_CILK)
-	cc_func = cc_cilk;
-	#elif defined(USE_SEQUENTIAL)
-	cc_func = cc_sequential;
-	#endif
-
-	/* Actually run the benchmark */
-	ret = benchmark_cc(cc_func, matrix, benchmark);
-
-	benchmark_print(benchmark);
+	/* Optionally renumber the vertices, timing the input numbering first */
+	if (args.order != CSC_ORDER_NONE)
+		ret = benchmark_reorder(matrix, args.order, benchmark);
+
+	/* Compressed kernels no longer need the plain row indices */
+	if (ret == 0 && matrix->packed)
+		csc_mem_release_rows(matrix);
+
+	/* Actually run the benchmark: the linked implementation's cc_plan_*()
+	 * (selected by the preprocessor, through compiler flags) */
+	if (ret == 0)
+		ret = benchmark_cc(matrix, benchmark);
+
+	/* Optionally write the component of every vertex */
+	if (ret == 0 && args.labels_path)
+		ret = benchmark_labels(matrix, args.labels_path, benchmark);
+
+	/* A failed run leaves the results unset */
+	if (ret == 0)
+		benchmark_print(benchmark);
 
 	/* Cleanup */
 	benchmark_free(benchmark);
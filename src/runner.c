@@ -31,10 +31,16 @@ typedef struct {
 
 /**
  * @brief Executes a single benchmark binary and captures its output.
+ *
+ * The implementations accept the same options as the runner, so the
+ * runner's own command line is forwarded unchanged (argv[0] aside).
+ *
+ * @param binary Path to the implementation binary
+ * @param child_argv Argument vector for the child; argv[0] is overwritten
+ * @param output Output: captured stdout/stderr (caller frees)
  */
 static int
-run_benchmark(const char *binary, const char *matrix_file,
-              int threads, int trials, int algorithm_variant, char **output)
+run_benchmark(const char *binary, char *child_argv[], char **output)
 {
 	int pipe_fd[2];
 	if (pipe(pipe_fd) == -1) {
@@ -57,12 +63,8 @@ run_benchmark(const char *binary, const char *matrix_file,
 		dup2(pipe_fd[1], STDERR_FILENO);
 		close(pipe_fd[1]);
 
-		char threads_str[16], trials_str[16], variant_str[16];
-		snprintf(threads_str, sizeof(threads_str), "%d", threads);
-		snprintf(trials_str, sizeof(trials_str), "%d", trials);
-		snprintf(variant_str, sizeof(variant_str), "%u", algorithm_variant);
-
-		execl(binary, binary, "-t", threads_str, "-n", trials_str, "-v", variant_str, matrix_file, NULL);
+		child_argv[0] = (char *)binary;
+		execv(binary, child_argv);
 		exit(1);
 	}
 
@@ -191,14 +193,15 @@ main(int argc, char *argv[])
 {
 	set_program_name(argv[0]);
 
-	char *matrix_file = NULL;
-	unsigned int threads;
-	unsigned int trials;
-	unsigned int algorithm_variant;
+	Args args;
 
-	int parse_status = parseargs(argc, argv, &threads, &trials, &algorithm_variant, &matrix_file);
+	int parse_status = parseargs(argc, argv, &args);
 	if (parse_status != 0) return parse_status == -1 ? 0 : 1;
 
+	char *matrix_file = args.filepath;
+	unsigned int threads = args.n_threads;
+	unsigned int trials = args.n_trials;
+
 	if (threads <= 0 || trials <= 0) {
 		print_error(__func__, "threads and trials must be positive integers", 0);
 		return 1;
@@ -233,8 +236,7 @@ main(int argc, char *argv[])
 
 		fprintf(stderr, "[%s] Running...\n", results[i].name);
 		
-		int ret = run_benchmark(results[i].binary_path, matrix_file,
-		                        threads, trials, algorithm_variant, &results[i].output);
+		int ret = run_benchmark(results[i].binary_path, argv, &results[i].output);
 		
 		if (ret == 0) {
 			// Parse the output
@@ -262,6 +264,7 @@ main(int argc, char *argv[])
 
 	for (int i = 0; i < MAX_RESULTS; i++) {
 		if (results[i].output) free(results[i].output);
+		if (results[i].success) free_benchmark_data(&results[i].data);
 	}
 
 	return 0;
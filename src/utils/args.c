@@ -19,6 +19,23 @@
 
 extern const char *program_name;
 
+/*
+ * Variants of the linked implementation, bit v set for variant v. Selected
+ * by the same flags that pick the implementation (see main.c); the runner
+ * links none and passes -v on to every binary.
+ */
+#if defined(USE_OPENMP)
+	#define SUPPORTED_VARIANTS 0x7Fu   /* 0-6 */
+#elif defined(USE_PTHREADS)
+	#define SUPPORTED_VARIANTS 0x7Bu   /* 0, 1, 3-6 */
+#elif defined(USE_CILK)
+	#define SUPPORTED_VARIANTS 0x6Fu   /* 0-3, 5, 6 */
+#elif defined(USE_SEQUENTIAL)
+	#define SUPPORTED_VARIANTS 0x23u   /* 0, 1, 5 */
+#else
+	#define SUPPORTED_VARIANTS 0x7Fu
+#endif
+
 /**
  * @brief Checks if a string represents an unsigned integer.
  *
@@ -51,7 +68,36 @@ usage(void) {
 		"Options:\n"
 		"  -t <threads>       Number of threads to use (default: 8)\n"
 		"  -n <trials>        Number of benchmark trials (default: 3)\n"
-		"  -v <variant>       Algorithm variant (0=standard, 1=optimized, default: 0)\n"
+		"  -v <variant>       Algorithm variant (default: 0):\n"
+		"                       0  label propagation\n"
+		"                       1  union-find (Rem's algorithm)\n"
+		"                       2  Afforest: sampled union-find (OpenMP, OpenCilk)\n"
+		"                       3  FastSV: hooking and shortcutting (parallel backends)\n"
+		"                       4  Multistep: BFS, then union-find (OpenMP, Pthreads)\n"
+		"                       5  frontier label propagation: active columns only\n"
+		"                       6  label propagation with pointer jumping (parallel backends)\n"
+		"  -l <mode>          .mtx load mode (default: coo):\n"
+		"                       coo      stage COO arrays, then convert (fastest)\n"
+		"                       twopass  count degrees, then scatter (lowest memory)\n"
+		"  -c                 Compress row indices (delta + varint) and decode on the fly\n"
+		"  -s                 Keep one triangle of symmetric .mtx inputs (half storage)\n"
+		"  -d                 Normalize: sort rows, drop duplicate entries and self-loops\n"
+		"  -e                 Edge streaming: union-find while parsing a .mtx file,\n"
+		"                     without building the matrix (O(vertices) memory)\n"
+		"  -m <MiB>           Out-of-core: stream a .csc file in blocks, keeping the\n"
+		"                     labels and two blocks within <MiB> of memory\n"
+		"  -r <order>         Renumber vertices before the trials (default: none):\n"
+		"                       degree   descending degree (cheapest)\n"
+		"                       rcm      reverse Cuthill-McKee\n"
+		"                       gorder   Gorder-style neighbourhood greedy (costliest)\n"
+		"  -p <policy>        NUMA placement of the label and CSC arrays (default: none):\n"
+		"                       local       first-touched by the threads that use them\n"
+		"                       interleave  pages spread over every node\n"
+		"  -g <pages>         Page size of the label and CSC arrays (default: none):\n"
+		"                       thp      2 MB-aligned, transparent huge pages\n"
+		"                       hugetlb  hugetlbfs pool, thp when it is empty\n"
+		"  -o <file>          Write the component of every vertex to <file>, one\n"
+		"                     label (smallest vertex of the component) per line\n"
 		"  -h                 Show this help message and exit\n\n"
 		"Arguments:\n"
 		"  matrix_file Path to the input matrix file (Matlab Matrix format)\n\n"
@@ -65,24 +111,31 @@ usage(void) {
  * @copydoc parseargs()
  */
 int
-parseargs(int argc, char *argv[],
-          unsigned int *n_threads,
-          unsigned int *n_trials,
-          unsigned int *algorithm_variant,
-          char **filepath)
+parseargs(int argc, char *argv[], Args *args)
 {
-	*n_threads = 8;
-	*n_trials = 3;
-	*algorithm_variant = 0;
-	*filepath = NULL;
+	args->n_threads = 8;
+	args->n_trials = 3;
+	args->algorithm_variant = 0;
+	args->build_mode = CSC_BUILD_COO;
+	args->compress = 0;
+	args->half = 0;
+	args->normalize = 0;
+	args->stream = 0;
+	args->memory_mb = 0;
+	args->order = CSC_ORDER_NONE;
+	args->numa = CSC_NUMA_NONE;
+	args->huge = CSC_HUGE_NONE;
+	args->labels_path = NULL;
+	args->filepath = NULL;
 
 	opterr = 0;
 
 	int opt;
-	while ((opt = getopt(argc, argv, "+t:n:v:h")) != -1) {
+	while ((opt = getopt(argc, argv, "+t:n:v:l:r:m:p:g:o:csdeh")) != -1) {
 		switch (opt) {
 		case 't':
-		case 'n': {
+		case 'n':
+		case 'm': {
 			if (!optarg || !isuint(optarg)) {
 				char err[128];
 				snprintf(err, sizeof(err), "invalid or missing argument for -%c", opt);
@@ -93,39 +146,123 @@ parseargs(int argc, char *argv[],
 			int val = atoi(optarg);
 			if (!val) {
 				char err[128];
-				snprintf(err, sizeof(err), "%s must be > 0", (opt == 't') ? "threads" : "trials");
+				snprintf(err, sizeof(err), "%s must be > 0",
+				         (opt == 't') ? "threads" : (opt == 'n') ? "trials" : "memory budget");
 				print_error(__func__, err, 0);
 				usage();
 				return 1;
 			}
-			if (opt == 't') *n_threads = val;
-			else *n_trials = val;
+			if (opt == 't') args->n_threads = val;
+			else if (opt == 'n') args->n_trials = val;
+			else args->memory_mb = val;
 			break;
 		}
 		case 'h':
 			usage();
 			return -1;
-		
+
+		case 'c':
+			args->compress = 1;
+			break;
+
+		case 's':
+			args->half = 1;
+			break;
+
+		case 'd':
+			args->normalize = 1;
+			break;
+
+		case 'e':
+			args->stream = 1;
+			break;
+
 		case 'v': {
 			if (!optarg || !isuint(optarg)) {
-				print_error(__func__, "invalid argument for -v (must be 0 or 1)", 0);
+				print_error(__func__, "invalid argument for -v (must be 0 to 6)", 0);
 				usage();
 				return 1;
 			}
 			int val = atoi(optarg);
-			if (val < 0 || val > 1) {
-				print_error(__func__, "variant must be 0 or 1", 0);
+			if (val < 0 || val > 6) {
+				print_error(__func__, "variant must be 0 to 6", 0);
+				usage();
+				return 1;
+			}
+			if (!(SUPPORTED_VARIANTS >> val & 1)) {
+				print_error(__func__, "variant not supported by this implementation", 0);
 				usage();
 				return 1;
 			}
-			*algorithm_variant = (unsigned int)val;
+			args->algorithm_variant = (unsigned int)val;
 			break;
 		}
 
+		case 'l':
+			if (strcmp(optarg, "coo") == 0) {
+				args->build_mode = CSC_BUILD_COO;
+			} else if (strcmp(optarg, "twopass") == 0) {
+				args->build_mode = CSC_BUILD_TWO_PASS;
+			} else {
+				print_error(__func__, "load mode must be coo or twopass", 0);
+				usage();
+				return 1;
+			}
+			break;
+
+		case 'r':
+			if (strcmp(optarg, "none") == 0) {
+				args->order = CSC_ORDER_NONE;
+			} else if (strcmp(optarg, "degree") == 0) {
+				args->order = CSC_ORDER_DEGREE;
+			} else if (strcmp(optarg, "rcm") == 0) {
+				args->order = CSC_ORDER_RCM;
+			} else if (strcmp(optarg, "gorder") == 0) {
+				args->order = CSC_ORDER_GORDER;
+			} else {
+				print_error(__func__, "ordering must be none, degree, rcm or gorder", 0);
+				usage();
+				return 1;
+			}
+			break;
+
+		case 'p':
+			if (strcmp(optarg, "none") == 0) {
+				args->numa = CSC_NUMA_NONE;
+			} else if (strcmp(optarg, "local") == 0) {
+				args->numa = CSC_NUMA_LOCAL;
+			} else if (strcmp(optarg, "interleave") == 0) {
+				args->numa = CSC_NUMA_INTERLEAVE;
+			} else {
+				print_error(__func__, "NUMA policy must be none, local or interleave", 0);
+				usage();
+				return 1;
+			}
+			break;
+
+		case 'g':
+			if (strcmp(optarg, "none") == 0) {
+				args->huge = CSC_HUGE_NONE;
+			} else if (strcmp(optarg, "thp") == 0) {
+				args->huge = CSC_HUGE_THP;
+			} else if (strcmp(optarg, "hugetlb") == 0) {
+				args->huge = CSC_HUGE_HUGETLB;
+			} else {
+				print_error(__func__, "page policy must be none, thp or hugetlb", 0);
+				usage();
+				return 1;
+			}
+			break;
+
+		case 'o':
+			args->labels_path = optarg;
+			break;
+
 		case '?':
 		default: {
 			char err[128];
-			if (optopt == 't' || optopt == 'n')
+			if (optopt == 't' || optopt == 'n' || optopt == 'v' || optopt == 'l' ||
+			    optopt == 'r' || optopt == 'm' || optopt == 'p' || optopt == 'g' || optopt == 'o')
 				snprintf(err, sizeof(err), "missing argument for -%c", optopt);
 			else
 				snprintf(err, sizeof(err), "unknown option '-%c'", optopt ? optopt : '?');
@@ -136,11 +273,38 @@ parseargs(int argc, char *argv[],
 		}
 	}
 
+	/* Streaming never builds the matrix these options work on */
+	if (args->stream && (args->compress || args->normalize || args->order != CSC_ORDER_NONE)) {
+		print_error(__func__, "-e cannot be combined with -c, -d or -r", 0);
+		usage();
+		return 1;
+	}
+
+	/* Neither does the out-of-core run, which reads the .csc file as stored */
+	if (args->memory_mb && (args->stream || args->compress || args->normalize ||
+	                        args->order != CSC_ORDER_NONE)) {
+		print_error(__func__, "-m cannot be combined with -e, -c, -d or -r", 0);
+		usage();
+		return 1;
+	}
+	if (args->memory_mb && args->algorithm_variant > 1) {
+		print_error(__func__, "-m supports variants 0 and 1 only", 0);
+		usage();
+		return 1;
+	}
+
+	/* Labels come from the kernels, which neither run */
+	if (args->labels_path && (args->stream || args->memory_mb)) {
+		print_error(__func__, "-o cannot be combined with -e or -m", 0);
+		usage();
+		return 1;
+	}
+
 	if (optind < argc) {
-		*filepath = argv[optind];
-		if (access(*filepath, R_OK) != 0) {
+		args->filepath = argv[optind];
+		if (access(args->filepath, R_OK) != 0) {
 			char err[256];
-			snprintf(err, sizeof(err), "cannot access file: \"%s\"", *filepath);
+			snprintf(err, sizeof(err), "cannot access file: \"%s\"", args->filepath);
 			print_error(__func__, err, errno);
 			usage();
 			return 1;
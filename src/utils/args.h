@@ -10,13 +10,51 @@
 #ifndef ARGS_H
 #define ARGS_H
 
+#include "matrix.h"
+#include "mem.h"
+#include "reorder.h"
+
+/**
+ * @struct Args
+ * @brief Parsed command-line options.
+ */
+typedef struct {
+	unsigned int n_threads;         /**< Number of threads */
+	unsigned int n_trials;          /**< Number of benchmark trials */
+	unsigned int algorithm_variant; /**< Algorithm variant */
+	CSCBuildMode build_mode;        /**< CSC construction strategy for .mtx inputs */
+	int compress;                   /**< Run the kernels on varint-compressed row indices */
+	int half;                       /**< Keep one triangle of symmetric inputs */
+	int normalize;                  /**< Sort rows, drop duplicates and self-loops */
+	int stream;                     /**< Count components while parsing, without a matrix */
+	unsigned int memory_mb;         /**< Out-of-core memory budget in MiB (0: load the matrix) */
+	CSCOrder order;                 /**< Vertex ordering applied before the trials */
+	CSCNumaPolicy numa;             /**< Placement of the label and CSC arrays */
+	CSCHugePolicy huge;             /**< Page size of the label and CSC arrays */
+	char *labels_path;              /**< Where to write per-vertex labels (NULL: nowhere) */
+	char *filepath;                 /**< Path to the input matrix file */
+} Args;
+
 /**
  * @brief Parses command-line arguments.
  *
  * Supported options:
  *   -t <threads>   Number of threads (default: 8)
  *   -n <trials>    Number of trials (default: 3)
- *   -v <variant>   Algorithm variant: 0=standard, 1=optimized (default: 0)
+ *   -v <variant>   Algorithm variant: 0=label propagation, 1=union-find,
+ *                  2=Afforest, 3=FastSV, 4=Multistep,
+ *                  5=frontier label propagation, 6=pointer-jumping label
+ *                  propagation (default: 0)
+ *   -l <mode>      .mtx load mode: coo or twopass (default: coo)
+ *   -c             Compress row indices (delta + varint) before running
+ *   -s             Keep one triangle of symmetric .mtx inputs
+ *   -d             Sort rows, drop duplicate entries and self-loops
+ *   -e             Edge streaming: union-find fed by the .mtx parser
+ *   -m <MiB>       Out-of-core run on a .csc file within a memory budget
+ *   -r <order>     Vertex ordering: none, degree, rcm or gorder (default: none)
+ *   -p <policy>    NUMA placement: none, local or interleave (default: none)
+ *   -g <pages>     Page size: none, thp or hugetlb (default: none)
+ *   -o <file>      Write per-vertex component labels to a file
  *   -h             Show usage and exit
  *
  * Arguments:
@@ -26,12 +64,9 @@
  *
  * @param argc Argument count
  * @param argv Argument vector
- * @param n_threads Output: number of threads
- * @param n_trials Output: number of trials
- * @param algorithm_variant Output: variant of algorithm
- * @param filepath Output: path to matrix file
+ * @param args Output: parsed options
  * @return 0 on success, -1 if help requested, 1 on error
  */
-int parseargs(int argc, char *argv[], unsigned int *n_threads, unsigned int *n_trials, unsigned int *algorithm_variant, char **filepath);
+int parseargs(int argc, char *argv[], Args *args);
 
 #endif /* ARGS_H */
@@ -17,22 +17,17 @@
 #include "error.h"
 #include "benchmark.h"
 #include "json.h"
+#include "mem.h"
+#include "connected_components.h"
+#include "packed.h"
+#include "streamcc.h"
+#include "extcc.h"
+#include "timer.h"
 
 /* ------------------------------------------------------------------------- */
 /*                            Static Helper Functions                        */
 /* ------------------------------------------------------------------------- */
 
-/**
- * @brief Returns current monotonic time in seconds.
- */
-static double
-now_sec(void)
-{
-	struct timespec t;
-	clock_gettime(CLOCK_MONOTONIC, &t);
-	return t.tv_sec + t.tv_nsec / 1e9;
-}
-
 /**
  * @brief Comparison function for sorting doubles.
  */
@@ -182,14 +177,55 @@ benchmark_init(const char *name,
 		return NULL;
 	}
 
-	// Add matrix info
-	b->matrix_info.cols = mat->ncols;
-	b->matrix_info.rows = mat->nrows;
-	b->matrix_info.nnz = mat->nnz;
+	// Add matrix info (left zero without a matrix, see benchmark_stream())
+	memset(&b->matrix_info, 0, sizeof(b->matrix_info));
+	memset(&b->result.timing, 0, sizeof(b->result.timing));
+	memset(b->result.component_size_histogram, 0, sizeof(b->result.component_size_histogram));
+	b->result.largest_component = 0;
+	b->result.n_size_buckets = 0;
+	b->result.rounds = 0;
+	b->result.shortcut_rounds = 0;
+	b->result.fallback = 0;
+	snprintf(b->matrix_info.reorder, sizeof(b->matrix_info.reorder), "%s", csc_order_name(CSC_ORDER_NONE));
+	snprintf(b->matrix_info.numa, sizeof(b->matrix_info.numa), "%s",
+	         csc_numa_name(mat ? mat->mem.numa : CSC_NUMA_NONE));
+	b->matrix_info.numa_nodes = mem_numa_nodes();
+	snprintf(b->matrix_info.huge_pages, sizeof(b->matrix_info.huge_pages), "%s",
+	         csc_huge_name(mat ? mem_huge_in_effect(mat->row_idx, &mat->mem) : CSC_HUGE_NONE));
 	strncpy(b->matrix_info.path, filepath, sizeof(b->matrix_info.path));
 	b->matrix_info.path[sizeof(b->matrix_info.path) - 1] = '\0';
 
+	if (mat) {
+		double to_csc_s = mat->load.parse_time_s + mat->load.build_time_s;
+
+		b->matrix_info.cols = mat->ncols;
+		b->matrix_info.rows = mat->nrows;
+		b->matrix_info.nnz = mat->nnz;
+		b->matrix_info.parse_mb_per_s = (to_csc_s > 0)
+			? mat->load.input_bytes / 1e6 / to_csc_s
+			: 0.0;
+		b->matrix_info.index_mb = ((mat->ncols + 1) * sizeof(csc_ptr_t) + mat->nnz * sizeof(csc_idx_t)) / 1e6;
+		b->matrix_info.packed_index_mb = mat->packed
+			? ((mat->ncols + 1) * sizeof(csc_ptr_t) + mat->packed->data_bytes) / 1e6
+			: 0.0;
+		b->matrix_info.half_storage = mat->half ? 1 : 0;
+		b->matrix_info.normalized = mat->normalized ? 1 : 0;
+		b->matrix_info.mirrored = mat->mirrored ? 1 : 0;
+		b->matrix_info.duplicates_removed = mat->load.duplicates_removed;
+		b->matrix_info.self_loops_removed = mat->load.self_loops_removed;
+		b->matrix_info.normalize_time_s = mat->load.normalize_time_s;
+
+		b->result.timing.load_time_s      = mat->load.load_time_s;
+		b->result.timing.io_time_s        = mat->load.io_time_s;
+		b->result.timing.parse_time_s     = mat->load.parse_time_s;
+		b->result.timing.build_time_s     = mat->load.build_time_s;
+		b->result.timing.normalize_time_s = mat->load.normalize_time_s;
+		b->result.timing.pack_time_s      = mat->load.pack_time_s;
+		b->result.timing.place_time_s     = mat->load.place_time_s;
+	}
+
 	// Add benchmark info
+	memset(&b->benchmark_info, 0, sizeof(b->benchmark_info));
 	b->benchmark_info.threads = n_threads;
 	b->benchmark_info.trials  = n_trials;
 
@@ -207,6 +243,8 @@ benchmark_init(const char *name,
 		benchmark_free(b);
 		return NULL;
 	}
+	b->result.timing.trial_times_s = b->times;
+	b->result.timing.n_trial_times = n_trials;
 
 	return b;
 }
@@ -226,22 +264,91 @@ benchmark_free(Benchmark *b)
  * @copydoc benchmark_cc()
  */
 int
-benchmark_cc(int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const unsigned int),
-             const CSCBinaryMatrix *m,
-             Benchmark *b)
+benchmark_cc(const CSCBinaryMatrix *m, Benchmark *b)
 {
 	long result;
+	int ret = 0;
 
-	result = cc_func(m, b->benchmark_info.threads, b->result.algorithm_variant); /* warm-up run */
+	double plan_start = now_sec();
+	CCPlan *plan = cc_plan_create(m, b->benchmark_info.threads, b->result.algorithm_variant);
+	b->result.timing.plan_time_s = now_sec() - plan_start;
+
+	if (!plan)
+		return 1;
+
+	double warmup_start = now_sec();
+	result = cc_plan_execute(plan); /* warm-up run */
+	b->result.timing.warmup_time_s = now_sec() - warmup_start;
+
+	if (result < 0) {
+		cc_plan_destroy(plan);
+		return 1;
+	}
+
+	b->result.connected_components = result;
+
+	for (unsigned int i = 0; i < b->benchmark_info.trials; i++) {
+		double start_time = now_sec();
+		result = cc_plan_execute(plan);
+		b->times[i] = now_sec() - start_time;
+
+		if (result < 0) {
+			ret = 1;
+			break;
+		}
+
+		if (result != b->result.connected_components) {
+			printf("[%s] Components between retries don't match\n", b->result.algorithm);
+			ret = 2;
+			break;
+		}
+	}
+
+	/* Every run is finalized the same way; keep the last run's sizes */
+	const CCSummary *sum = cc_plan_summary(plan);
+	b->result.largest_component = sum->largest;
+	b->result.rounds = sum->rounds;
+	b->result.shortcut_rounds = sum->shortcut_rounds;
+	b->result.fallback = sum->fallback;
+	b->result.n_size_buckets = 0;
+	for (unsigned int i = 0; i < CC_SIZE_BUCKETS; i++) {
+		b->result.component_size_histogram[i] = sum->size_histogram[i];
+		if (sum->size_histogram[i])
+			b->result.n_size_buckets = i + 1;
+	}
+
+	cc_plan_destroy(plan);
+	return ret;
+}
+
+/**
+ * @copydoc benchmark_stream()
+ */
+int
+benchmark_stream(const char *path, Benchmark *b)
+{
+	StreamCCStats st;
+	long result;
+
+	double warmup_start = now_sec();
+	result = streamcc_count(path, b->benchmark_info.threads, &st); /* warm-up run */
+	b->result.timing.warmup_time_s = now_sec() - warmup_start;
 
 	if (result < 0)
 		return 1;
 
 	b->result.connected_components = result;
+	b->result.rounds = 1;
+	b->matrix_info.rows = st.nrows;
+	b->matrix_info.cols = st.ncols;
+	b->matrix_info.nnz  = st.edges;
+	b->matrix_info.parse_mb_per_s = (st.stream_time_s > 0)
+		? st.input_bytes / 1e6 / st.stream_time_s
+		: 0.0;
 
 	for (unsigned int i = 0; i < b->benchmark_info.trials; i++) {
 		double start_time = now_sec();
-		result = cc_func(m, b->benchmark_info.threads, b->result.algorithm_variant);
+		result = streamcc_count(path, b->benchmark_info.threads, NULL);
 		b->times[i] = now_sec() - start_time;
 
 		if (result < 0)
@@ -256,6 +363,141 @@ benchmark_cc(int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const un
 	return 0;
 }
 
+/**
+ * @copydoc benchmark_external()
+ */
+int
+benchmark_external(const char *path, unsigned int budget_mb, Benchmark *b)
+{
+	size_t budget = (size_t)budget_mb << 20;
+	ExtCCStats st;
+	long result;
+
+	b->benchmark_info.memory_budget_mb = budget_mb;
+
+	double warmup_start = now_sec();
+	result = extcc_count(path, b->result.algorithm_variant, budget,
+	                     b->benchmark_info.threads, &st); /* warm-up run */
+	b->result.timing.warmup_time_s = now_sec() - warmup_start;
+
+	if (result < 0)
+		return 1;
+
+	b->result.connected_components = result;
+	b->matrix_info.rows = st.nrows;
+	b->matrix_info.cols = st.ncols;
+	b->matrix_info.nnz  = st.nnz;
+	b->matrix_info.index_mb = ((st.ncols + 1) * sizeof(csc_ptr_t) + st.nnz * sizeof(csc_idx_t)) / 1e6;
+	b->benchmark_info.resident_mb = st.resident_bytes / 1e6;
+	b->benchmark_info.passes = st.passes;
+	b->result.rounds = st.passes;
+	b->benchmark_info.io_wait_time_s = st.wait_time_s;
+
+	for (unsigned int i = 0; i < b->benchmark_info.trials; i++) {
+		double start_time = now_sec();
+		result = extcc_count(path, b->result.algorithm_variant, budget,
+		                     b->benchmark_info.threads, NULL);
+		b->times[i] = now_sec() - start_time;
+
+		if (result < 0)
+			return 1;
+
+		if (result != b->result.connected_components) {
+			printf("[%s] Components between retries don't match\n", b->result.algorithm);
+			return 2;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @copydoc benchmark_reorder()
+ */
+int
+benchmark_reorder(CSCBinaryMatrix *m,
+                  CSCOrder order,
+                  Benchmark *b)
+{
+	int ret = benchmark_cc(m, b);
+	if (ret)
+		return ret;
+
+	calculate_time_statistics(b);
+	b->matrix_info.unordered_median_s = b->result.stats.median_time_s;
+
+	if (csc_reorder_matrix(m, order, b->benchmark_info.threads) != 0)
+		return 1;
+
+	snprintf(b->matrix_info.reorder, sizeof(b->matrix_info.reorder), "%s", csc_order_name(order));
+	b->matrix_info.reorder_time_s = m->load.reorder_time_s;
+	b->result.timing.reorder_time_s = m->load.reorder_time_s;
+	b->matrix_info.packed_index_mb = m->packed
+		? ((m->ncols + 1) * sizeof(csc_ptr_t) + m->packed->data_bytes) / 1e6
+		: 0.0;
+
+	return 0;
+}
+
+/**
+ * @copydoc benchmark_labels()
+ */
+int
+benchmark_labels(const CSCBinaryMatrix *m, const char *path, Benchmark *b)
+{
+	size_t n = m->nrows ? m->nrows : 1;
+	csc_idx_t *labels = malloc(n * sizeof(csc_idx_t));
+	csc_idx_t *out = m->perm ? malloc(n * sizeof(csc_idx_t)) : labels;
+	FILE *f = NULL;
+	int ret = 1;
+
+	if (!labels || !out) {
+		print_error(__func__, "malloc() failed", errno);
+		goto out;
+	}
+
+	long count = cc_labels(m, b->benchmark_info.threads, b->result.algorithm_variant, labels);
+	if (count < 0)
+		goto out;
+
+	if (count != b->result.connected_components) {
+		printf("[%s] Components of the labels don't match the trials\n", b->result.algorithm);
+		ret = 2;
+		goto out;
+	}
+
+	/* Line v is input vertex v, labelled with the smallest input vertex of
+	 * its component; labels becomes the first input vertex seen per label */
+	if (m->perm) {
+		csc_unpermute(m, labels, out);
+		memset(labels, 0xff, m->nrows * sizeof(csc_idx_t));
+		for (size_t v = 0; v < m->nrows; v++) {
+			if (labels[out[v]] == (csc_idx_t)-1)
+				labels[out[v]] = v;
+			out[v] = labels[out[v]];
+		}
+	}
+
+	f = fopen(path, "w");
+	if (!f) {
+		print_error(__func__, "failed to open labels file", errno);
+		goto out;
+	}
+	for (size_t v = 0; v < m->nrows; v++)
+		fprintf(f, "%llu\n", (unsigned long long)out[v]);
+	ret = 0;
+
+out:
+	if (f && fclose(f) != 0) {
+		print_error(__func__, "failed to write labels file", errno);
+		ret = 1;
+	}
+	if (out != labels)
+		free(out);
+	free(labels);
+	return ret;
+}
+
 /**
  * @copydoc benchmark_print()
  */
@@ -270,6 +512,25 @@ benchmark_print(Benchmark *b)
 	get_cpu_info(b);
 	get_memory_info(b);
 	b->result.throughput_edges_per_sec = b->matrix_info.nnz / b->result.stats.mean_time_s;
+	b->result.round_edges_per_sec = b->result.rounds * b->result.throughput_edges_per_sec;
+
+	/* One load-and-solve run: what a user without warm trials would see */
+	Timing *t = &b->result.timing;
+	t->compute_time_s = 0.0;
+	for (unsigned int i = 0; i < b->benchmark_info.trials; i++)
+		t->compute_time_s += b->times[i];
+	t->preprocess_time_s = t->normalize_time_s + t->pack_time_s + t->place_time_s + t->reorder_time_s;
+	t->end_to_end_time_s = t->load_time_s + t->preprocess_time_s + t->plan_time_s + b->result.stats.median_time_s;
+	b->result.end_to_end_edges_per_sec = (t->end_to_end_time_s > 0)
+		? b->matrix_info.nnz / t->end_to_end_time_s
+		: 0.0;
+
+	/* Reordering pays off once the per-run gain has covered its cost */
+	if (b->matrix_info.unordered_median_s > 0) {
+		double gain = b->matrix_info.unordered_median_s - b->result.stats.median_time_s;
+		b->matrix_info.reorder_speedup = b->matrix_info.unordered_median_s / b->result.stats.median_time_s;
+		b->matrix_info.reorder_break_even = (gain > 0) ? b->matrix_info.reorder_time_s / gain : -1.0;
+	}
 	get_peak_rss_mb(b);
 
 	printf("{\n");
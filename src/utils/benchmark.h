@@ -11,6 +11,8 @@
 #define BENCHMARK_H
 
 #include "matrix.h"
+#include "reorder.h"
+#include "connected_components.h"
 
 /**
  * @struct Statistics
@@ -27,6 +29,32 @@ typedef struct {
 	double max_time_s;     /**< Maximum execution time in seconds */
 } Statistics;
 
+/**
+ * @struct Timing
+ * @brief Where the wall time of a run went, from the input file to the last trial
+ *
+ * Load and preprocessing times are taken from the matrix's CSCLoadStats.
+ * Phases a run did not go through are reported as 0.
+ */
+typedef struct {
+	double load_time_s;       /**< Whole load (I/O, parse, COO → CSC and allocation) */
+	double io_time_s;         /**< Opening/mapping the file and reading its header */
+	double parse_time_s;      /**< Tokenizing or decoding the entries */
+	double build_time_s;      /**< Converting COO staging arrays to CSC */
+	double normalize_time_s;  /**< Sorting rows, dropping duplicates and self-loops */
+	double pack_time_s;       /**< Compressing row indices */
+	double place_time_s;      /**< Moving the arrays to pages allocated under -p/-g */
+	double reorder_time_s;    /**< Renumbering vertices (trials on the input numbering excluded) */
+	double preprocess_time_s; /**< normalize + pack + place + reorder */
+	double plan_time_s;       /**< Allocating and pre-faulting the kernel buffers (cc_plan_create()) */
+	double warmup_time_s;     /**< Warm-up run before the timed trials */
+	double compute_time_s;    /**< Sum of the timed trials */
+	double end_to_end_time_s; /**< load + preprocess + plan + median trial: one load-and-solve run */
+	double *trial_times_s;    /**< Time of every trial (borrowed from Benchmark::times, or
+	                               allocated by parse_benchmark_data()) */
+	unsigned int n_trial_times; /**< Number of entries in trial_times_s */
+} Timing;
+
 /**
  * @struct Result
  * @brief Complete benchmark result for a single algorithm
@@ -37,8 +65,19 @@ typedef struct {
 	char algorithm[32];                  /**< Algorithm name (e.g., "Sequential", "OpenMP") */
 	unsigned int algorithm_variant;      /**< Algorithm variant (0: original, 1: optimized) */
 	unsigned int connected_components;   /**< Number of connected components found */
+	size_t largest_component;            /**< Vertices in the largest component (0 if not measured) */
+	size_t component_size_histogram[CC_SIZE_BUCKETS]; /**< [i]: components of 2^i to 2^(i+1) - 1 vertices */
+	unsigned int n_size_buckets;         /**< Buckets up to the last non-empty one */
+	unsigned int rounds;                 /**< Passes of the kernel over the edges (0 if not measured) */
+	unsigned int shortcut_rounds;        /**< Pointer-jumping passes over the labels (0 if none) */
+	unsigned int fallback;               /**< 1 if the variant skipped its mirrored-edge path
+	                                          (see CCSummary) */
 	Statistics stats;                    /**< Timing statistics */
+	Timing timing;                       /**< Load, preprocessing and compute breakdown */
 	double throughput_edges_per_sec;     /**< Processing throughput in edges per second */
+	double end_to_end_edges_per_sec;     /**< nnz over timing.end_to_end_time_s */
+	double round_edges_per_sec;          /**< rounds * nnz over the mean trial time: edge
+	                                          throughput of one pass */
 	double memory_peak_mb;               /**< Peak memory usage in megabytes */
 	double speedup;                      /**< Speedup relative to sequential baseline */
 	double efficiency;                   /**< Parallel efficiency (speedup / threads) */
@@ -68,9 +107,27 @@ typedef struct {
  */
 typedef struct {
 	char path[256];     /**< File path to the matrix */
-	unsigned int rows;  /**< Number of rows in the matrix */
-	unsigned int cols;  /**< Number of columns in the matrix */
-	unsigned int nnz;   /**< Number of non-zero elements (edges in graph) */
+	size_t rows;        /**< Number of rows in the matrix */
+	size_t cols;        /**< Number of columns in the matrix */
+	size_t nnz;         /**< Number of non-zero elements (edges in graph) */
+	double parse_mb_per_s; /**< Loader throughput from input file to CSC (parse + build) */
+	double index_mb;       /**< Size of col_ptr + row_idx in megabytes */
+	double packed_index_mb;/**< Size of the compressed row indices (0 if not compressed) */
+	unsigned int half_storage; /**< 1 if only one triangle of a symmetric matrix is stored */
+	unsigned int normalized;   /**< 1 if rows are sorted, unique and loop-free (see normalize.h) */
+	unsigned int mirrored;     /**< 1 if every off-diagonal entry is stored in both columns
+	                                by construction (expanded symmetric input) */
+	size_t duplicates_removed; /**< Repeated entries dropped by normalization */
+	size_t self_loops_removed; /**< Diagonal entries dropped by normalization */
+	double normalize_time_s;   /**< Time spent normalizing */
+	char numa[16];             /**< Placement of the arrays: none, local or interleave (see mem.h) */
+	unsigned int numa_nodes;   /**< Online NUMA nodes */
+	char huge_pages[16];       /**< Page size row_idx got: none, thp or hugetlb (see mem.h) */
+	char reorder[16];          /**< Vertex ordering applied before the trials ("none" if not reordered) */
+	double reorder_time_s;     /**< Time spent computing and applying the ordering */
+	double unordered_median_s; /**< Median kernel time on the input numbering (0 if not reordered) */
+	double reorder_speedup;    /**< unordered_median_s over the median kernel time after reordering */
+	double reorder_break_even; /**< Kernel runs needed to amortize reorder_time_s (-1 if never) */
 } MatrixInfo;
 
 /**
@@ -82,6 +139,10 @@ typedef struct {
 typedef struct {
 	unsigned int threads;  /**< Number of threads used for parallel execution */
 	unsigned int trials;   /**< Number of benchmark trials performed */
+	unsigned int memory_budget_mb; /**< Out-of-core memory budget in MiB (0: matrix in memory) */
+	double resident_mb;    /**< Out-of-core: labels plus both block buffers */
+	unsigned int passes;   /**< Out-of-core: passes over the file per run */
+	double io_wait_time_s; /**< Out-of-core: warm-up time spent waiting for blocks */
 } BenchmarkInfo;
 
 /**
@@ -105,7 +166,9 @@ typedef struct {
  * @param filepath Path to the dataset file.
  * @param n_trials Number of trials to run.
  * @param n_threads Number of threads used in the algorithm.
- * @param mat Pointer to the CSCBinaryMatrix used as input.
+ * @param mat Pointer to the CSCBinaryMatrix used as input, or NULL when no
+ *            matrix is built (the matrix info is then filled in by
+ *            benchmark_stream() or benchmark_external()).
  *
  * @return Pointer to a newly allocated Benchmark structure, or `NULL` on failure.
  */
@@ -126,10 +189,14 @@ void benchmark_free(Benchmark *b);
 /**
  * @brief Runs a connected components benchmark.
  *
- * Executes the provided connected components function multiple times,
- * measuring execution time per trial and verifying consistency of results.
+ * Prepares one plan of the linked implementation (see
+ * connected_components.h) and executes it multiple times, measuring
+ * execution time per trial and verifying consistency of results. The
+ * buffers and workers are set up once, outside the timed trials, and
+ * reported as timing.plan_time_s. The largest component, the size
+ * histogram and the round count of the last run (cc_plan_summary()) are
+ * stored in the result.
  *
- * @param cc_func Pointer to the connected components function to benchmark.
  * @param m Input CSCBinaryMatrix.
  * @param b Benchmark object containing configuration and result storage.
  *
@@ -138,7 +205,84 @@ void benchmark_free(Benchmark *b);
  * - `1` on algorithm failure or invalid data,
  * - `2` if results differ between trials.
  */
-int benchmark_cc(int (*cc_func)(const CSCBinaryMatrix*, const unsigned int, const unsigned int), const CSCBinaryMatrix *m, Benchmark *b);
+int benchmark_cc(const CSCBinaryMatrix *m, Benchmark *b);
+
+/**
+ * @brief Runs the edge-streaming connected components benchmark.
+ *
+ * Every trial counts the components of @p path with streamcc_count(),
+ * reading and parsing the whole file again without building a matrix,
+ * so the trial times cover the complete load-and-solve run. The warm-up
+ * run fills in the matrix dimensions and nnz.
+ *
+ * @param path Path to the .mtx file, possibly compressed.
+ * @param b Benchmark object created without a matrix.
+ *
+ * @return
+ * - `0` on success,
+ * - `1` on read or parse failure,
+ * - `2` if results differ between trials.
+ */
+int benchmark_stream(const char *path, Benchmark *b);
+
+/**
+ * @brief Runs the out-of-core connected components benchmark.
+ *
+ * Every trial counts the components of the .csc file @p path with
+ * extcc_count(), keeping no more than @p budget_mb MiB in memory, so the
+ * trial times include reading the file. The warm-up run fills in the
+ * matrix dimensions and the out-of-core fields of the benchmark info.
+ *
+ * @param path Path to the .csc file.
+ * @param budget_mb Memory budget in MiB.
+ * @param b Benchmark object created without a matrix.
+ *
+ * @return
+ * - `0` on success,
+ * - `1` on read failure or a budget too small for the labels,
+ * - `2` if results differ between trials.
+ */
+int benchmark_external(const char *path, unsigned int budget_mb, Benchmark *b);
+
+/**
+ * @brief Reorders the matrix vertices, measuring what it costs and gains.
+ *
+ * Runs the trials on the input numbering first and keeps their median as
+ * the baseline, then applies @p order with csc_reorder_matrix(). The
+ * following benchmark_cc() call measures the reordered kernel, and
+ * benchmark_print() reports the speedup and after how many kernel runs
+ * the reordering has paid for itself.
+ *
+ * @param m Input CSCBinaryMatrix, renumbered in place.
+ * @param order Vertex ordering to apply.
+ * @param b Benchmark object containing configuration and result storage.
+ *
+ * @return
+ * - `0` on success,
+ * - `1` on algorithm or reordering failure,
+ * - `2` if results differ between trials.
+ */
+int benchmark_reorder(CSCBinaryMatrix *m, CSCOrder order, Benchmark *b);
+
+/**
+ * @brief Writes the component of every vertex to a text file.
+ *
+ * Labels the vertices with cc_labels() using the benchmark's threads and
+ * variant, maps them back to the input numbering if the matrix was
+ * reordered, and writes one label per line: line v holds the smallest
+ * input vertex (0-based) of input vertex v's component, whatever the
+ * ordering and variant.
+ *
+ * @param m Input CSCBinaryMatrix.
+ * @param path Output file.
+ * @param b Benchmark object whose configuration is used.
+ *
+ * @return
+ * - `0` on success,
+ * - `1` on algorithm or write failure,
+ * - `2` if the labels disagree with the component count of the trials.
+ */
+int benchmark_labels(const CSCBinaryMatrix *m, const char *path, Benchmark *b);
 
 /**
  * @brief Prints benchmark results in structured JSON format.
@@ -112,6 +112,92 @@ parse_uint(const char **p, unsigned int *value)
 	return 1;
 }
 
+/**
+ * @brief Parse a JSON unsigned integer value that may exceed 32 bits.
+ * @param p Pointer to JSON stream
+ * @param value Output parsed integer
+ * @return 1 on success, 0 on parse error
+ */
+static int
+parse_size(const char **p, size_t *value)
+{
+	skip_whitespace(p);
+	char *end;
+	unsigned long long val = strtoull(*p, &end, 10);
+	if (end == *p) return 0;
+	*value = (size_t)val;
+	*p = end;
+	return 1;
+}
+
+/**
+ * @brief Parse a JSON array of numbers into a newly allocated array.
+ * @param p Pointer to JSON stream
+ * @param values Output: allocated array (caller frees; NULL when empty)
+ * @param count Output: number of parsed values
+ * @return 1 on success, 0 on parse or allocation error
+ */
+static int
+parse_double_array(const char **p, double **values, unsigned int *count)
+{
+	*values = NULL;
+	*count = 0;
+	if (!expect_char(p, '[')) return 0;
+	if (expect_char(p, ']')) return 1;
+
+	unsigned int cap = 0;
+	do {
+		if (*count == cap) {
+			cap = cap ? 2 * cap : 16;
+			double *grown = realloc(*values, cap * sizeof(double));
+			if (!grown) {
+				free(*values);
+				*values = NULL;
+				return 0;
+			}
+			*values = grown;
+		}
+		if (!parse_double(p, &(*values)[*count])) {
+			free(*values);
+			*values = NULL;
+			return 0;
+		}
+		(*count)++;
+	} while (expect_char(p, ','));
+
+	if (!expect_char(p, ']')) {
+		free(*values);
+		*values = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Parse a JSON array of unsigned integers into a fixed-size array.
+ * @param p Pointer to JSON stream
+ * @param values Output array of @p cap entries (entries past the parsed ones are zeroed)
+ * @param cap Capacity of @p values
+ * @param count Output: number of parsed values
+ * @return 1 on success, 0 on parse error or more than @p cap values
+ */
+static int
+parse_size_array(const char **p, size_t *values, unsigned int cap, unsigned int *count)
+{
+	memset(values, 0, cap * sizeof(*values));
+	*count = 0;
+	if (!expect_char(p, '[')) return 0;
+	if (expect_char(p, ']')) return 1;
+
+	do {
+		if (*count == cap) return 0;
+		if (!parse_size(p, &values[*count])) return 0;
+		(*count)++;
+	} while (expect_char(p, ','));
+
+	return expect_char(p, ']');
+}
+
 /**
  * @brief Locate a JSON key and position the pointer after the colon.
  * 
@@ -181,11 +267,45 @@ parse_matrix_info(const char *json, MatrixInfo *info)
 	
 	if (find_key(&p, "path") && !parse_string(&p, info->path, sizeof(info->path)))
 		return 0;
-	if (find_key(&p, "rows") && !parse_uint(&p, &info->rows))
+	if (find_key(&p, "rows") && !parse_size(&p, &info->rows))
+		return 0;
+	if (find_key(&p, "cols") && !parse_size(&p, &info->cols))
+		return 0;
+	if (find_key(&p, "nnz") && !parse_size(&p, &info->nnz))
+		return 0;
+	if (find_key(&p, "parse_throughput_mb_s") && !parse_double(&p, &info->parse_mb_per_s))
+		return 0;
+	if (find_key(&p, "index_mb") && !parse_double(&p, &info->index_mb))
+		return 0;
+	if (find_key(&p, "packed_index_mb") && !parse_double(&p, &info->packed_index_mb))
 		return 0;
-	if (find_key(&p, "cols") && !parse_uint(&p, &info->cols))
+	if (find_key(&p, "half_storage") && !parse_uint(&p, &info->half_storage))
 		return 0;
-	if (find_key(&p, "nnz") && !parse_uint(&p, &info->nnz))
+	if (find_key(&p, "normalized") && !parse_uint(&p, &info->normalized))
+		return 0;
+	if (find_key(&p, "mirrored") && !parse_uint(&p, &info->mirrored))
+		return 0;
+	if (find_key(&p, "duplicates_removed") && !parse_size(&p, &info->duplicates_removed))
+		return 0;
+	if (find_key(&p, "self_loops_removed") && !parse_size(&p, &info->self_loops_removed))
+		return 0;
+	if (find_key(&p, "normalize_time_s") && !parse_double(&p, &info->normalize_time_s))
+		return 0;
+	if (find_key(&p, "numa") && !parse_string(&p, info->numa, sizeof(info->numa)))
+		return 0;
+	if (find_key(&p, "numa_nodes") && !parse_uint(&p, &info->numa_nodes))
+		return 0;
+	if (find_key(&p, "huge_pages") && !parse_string(&p, info->huge_pages, sizeof(info->huge_pages)))
+		return 0;
+	if (find_key(&p, "reorder") && !parse_string(&p, info->reorder, sizeof(info->reorder)))
+		return 0;
+	if (find_key(&p, "reorder_time_s") && !parse_double(&p, &info->reorder_time_s))
+		return 0;
+	if (find_key(&p, "unordered_median_time_s") && !parse_double(&p, &info->unordered_median_s))
+		return 0;
+	if (find_key(&p, "reorder_speedup") && !parse_double(&p, &info->reorder_speedup))
+		return 0;
+	if (find_key(&p, "reorder_break_even_runs") && !parse_double(&p, &info->reorder_break_even))
 		return 0;
 	
 	return 1;
@@ -201,6 +321,7 @@ static int
 parse_benchmark_info(const char *json, BenchmarkInfo *info)
 {
 	const char *p = json;
+	memset(info, 0, sizeof(*info));
 	if (!find_key(&p, "benchmark_info")) return 0;
 	if (!expect_char(&p, '{')) return 0;
 	
@@ -208,6 +329,14 @@ parse_benchmark_info(const char *json, BenchmarkInfo *info)
 		return 0;
 	if (find_key(&p, "trials") && !parse_uint(&p, &info->trials))
 		return 0;
+	if (find_key(&p, "memory_budget_mb") && !parse_uint(&p, &info->memory_budget_mb))
+		return 0;
+	if (find_key(&p, "resident_mb") && !parse_double(&p, &info->resident_mb))
+		return 0;
+	if (find_key(&p, "passes") && !parse_uint(&p, &info->passes))
+		return 0;
+	if (find_key(&p, "io_wait_time_s") && !parse_double(&p, &info->io_wait_time_s))
+		return 0;
 	
 	return 1;
 }
@@ -238,6 +367,51 @@ parse_statistics(const char **p, Statistics *stats)
 	return 1;
 }
 
+/**
+ * @brief Parse the "timing" JSON object.
+ * @param p Pointer to JSON stream
+ * @param timing Output timing structure (trial_times_s is allocated)
+ * @return 1 on success, 0 on failure
+ */
+static int
+parse_timing(const char **p, Timing *timing)
+{
+	if (!find_key(p, "timing")) return 0;
+	if (!expect_char(p, '{')) return 0;
+
+	if (find_key(p, "load_time_s") && !parse_double(p, &timing->load_time_s))
+		return 0;
+	if (find_key(p, "io_time_s") && !parse_double(p, &timing->io_time_s))
+		return 0;
+	if (find_key(p, "parse_time_s") && !parse_double(p, &timing->parse_time_s))
+		return 0;
+	if (find_key(p, "build_time_s") && !parse_double(p, &timing->build_time_s))
+		return 0;
+	if (find_key(p, "normalize_time_s") && !parse_double(p, &timing->normalize_time_s))
+		return 0;
+	if (find_key(p, "pack_time_s") && !parse_double(p, &timing->pack_time_s))
+		return 0;
+	if (find_key(p, "place_time_s") && !parse_double(p, &timing->place_time_s))
+		return 0;
+	if (find_key(p, "reorder_time_s") && !parse_double(p, &timing->reorder_time_s))
+		return 0;
+	if (find_key(p, "preprocess_time_s") && !parse_double(p, &timing->preprocess_time_s))
+		return 0;
+	if (find_key(p, "plan_time_s") && !parse_double(p, &timing->plan_time_s))
+		return 0;
+	if (find_key(p, "warmup_time_s") && !parse_double(p, &timing->warmup_time_s))
+		return 0;
+	if (find_key(p, "compute_time_s") && !parse_double(p, &timing->compute_time_s))
+		return 0;
+	if (find_key(p, "end_to_end_time_s") && !parse_double(p, &timing->end_to_end_time_s))
+		return 0;
+	if (find_key(p, "trial_times_s") &&
+	    !parse_double_array(p, &timing->trial_times_s, &timing->n_trial_times))
+		return 0;
+
+	return 1;
+}
+
 /**
  * @brief Parse a single algorithm result object.
  * @param json Input JSON string
@@ -248,6 +422,7 @@ static int
 parse_result(const char *json, Result *result)
 {
 	const char *p = json;
+	memset(&result->timing, 0, sizeof(result->timing));
 	if (!find_key(&p, "results")) return 0;
 	if (!expect_char(&p, '[')) return 0;
 	if (!expect_char(&p, '{')) return 0;
@@ -260,10 +435,27 @@ parse_result(const char *json, Result *result)
 		return 0;
 	if (find_key(&p, "connected_components") && !parse_uint(&p, &result->connected_components))
 		return 0;
+	if (find_key(&p, "largest_component") && !parse_size(&p, &result->largest_component))
+		return 0;
+	if (find_key(&p, "component_size_histogram") &&
+	    !parse_size_array(&p, result->component_size_histogram, CC_SIZE_BUCKETS, &result->n_size_buckets))
+		return 0;
+	if (find_key(&p, "rounds") && !parse_uint(&p, &result->rounds))
+		return 0;
+	if (find_key(&p, "shortcut_rounds") && !parse_uint(&p, &result->shortcut_rounds))
+		return 0;
+	if (find_key(&p, "fallback") && !parse_uint(&p, &result->fallback))
+		return 0;
 	if (!parse_statistics(&p, &result->stats))
 		return 0;
+	if (!parse_timing(&p, &result->timing))
+		return 0;
 	if (find_key(&p, "throughput_edges_per_sec") && !parse_double(&p, &result->throughput_edges_per_sec))
 		return 0;
+	if (find_key(&p, "end_to_end_edges_per_sec") && !parse_double(&p, &result->end_to_end_edges_per_sec))
+		return 0;
+	if (find_key(&p, "round_edges_per_sec") && !parse_double(&p, &result->round_edges_per_sec))
+		return 0;
 	if (find_key(&p, "memory_peak_mb") && !parse_double(&p, &result->memory_peak_mb))
 		return 0;
 	
@@ -292,12 +484,26 @@ parse_benchmark_data(const char *json, BenchmarkData *data)
 	if (!parse_sys_info(json, &data->sys_info)) return 0;
 	if (!parse_matrix_info(json, &data->matrix_info)) return 0;
 	if (!parse_benchmark_info(json, &data->benchmark_info)) return 0;
-	if (!parse_result(json, &data->result)) return 0;
+	if (!parse_result(json, &data->result)) {
+		free_benchmark_data(data);
+		return 0;
+	}
 	
 	data->valid = 1;
 	return 1;
 }
 
+/**
+ * @brief Release the memory parse_benchmark_data() allocated.
+ */
+void
+free_benchmark_data(BenchmarkData *data)
+{
+	free(data->result.timing.trial_times_s);
+	data->result.timing.trial_times_s = NULL;
+	data->result.timing.n_trial_times = 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /*                           JSON Print Helpers                              */
 /* ------------------------------------------------------------------------- */
@@ -324,9 +530,26 @@ print_matrix_info(const MatrixInfo *info, int indent_level)
 {
 	printf("%*s\"matrix_info\": {\n", indent_level, "");
 	printf("%*s\"path\": \"%s\",\n", indent_level + 2, "", info->path);
-	printf("%*s\"rows\": %u,\n", indent_level + 2, "", info->rows);
-	printf("%*s\"cols\": %u,\n", indent_level + 2, "", info->cols);
-	printf("%*s\"nnz\": %u\n", indent_level + 2, "", info->nnz);
+	printf("%*s\"rows\": %zu,\n", indent_level + 2, "", info->rows);
+	printf("%*s\"cols\": %zu,\n", indent_level + 2, "", info->cols);
+	printf("%*s\"nnz\": %zu,\n", indent_level + 2, "", info->nnz);
+	printf("%*s\"parse_throughput_mb_s\": %.2f,\n", indent_level + 2, "", info->parse_mb_per_s);
+	printf("%*s\"index_mb\": %.2f,\n", indent_level + 2, "", info->index_mb);
+	printf("%*s\"packed_index_mb\": %.2f,\n", indent_level + 2, "", info->packed_index_mb);
+	printf("%*s\"half_storage\": %u,\n", indent_level + 2, "", info->half_storage);
+	printf("%*s\"normalized\": %u,\n", indent_level + 2, "", info->normalized);
+	printf("%*s\"mirrored\": %u,\n", indent_level + 2, "", info->mirrored);
+	printf("%*s\"duplicates_removed\": %zu,\n", indent_level + 2, "", info->duplicates_removed);
+	printf("%*s\"self_loops_removed\": %zu,\n", indent_level + 2, "", info->self_loops_removed);
+	printf("%*s\"normalize_time_s\": %.6f,\n", indent_level + 2, "", info->normalize_time_s);
+	printf("%*s\"numa\": \"%s\",\n", indent_level + 2, "", info->numa);
+	printf("%*s\"numa_nodes\": %u,\n", indent_level + 2, "", info->numa_nodes);
+	printf("%*s\"huge_pages\": \"%s\",\n", indent_level + 2, "", info->huge_pages);
+	printf("%*s\"reorder\": \"%s\",\n", indent_level + 2, "", info->reorder);
+	printf("%*s\"reorder_time_s\": %.6f,\n", indent_level + 2, "", info->reorder_time_s);
+	printf("%*s\"unordered_median_time_s\": %.6f,\n", indent_level + 2, "", info->unordered_median_s);
+	printf("%*s\"reorder_speedup\": %.4f,\n", indent_level + 2, "", info->reorder_speedup);
+	printf("%*s\"reorder_break_even_runs\": %.2f\n", indent_level + 2, "", info->reorder_break_even);
 	printf("%*s}", indent_level, "");
 }
 
@@ -338,7 +561,38 @@ print_benchmark_info(const BenchmarkInfo *info, int indent_level)
 {
 	printf("%*s\"benchmark_info\": {\n", indent_level, "");
 	printf("%*s\"threads\": %u,\n", indent_level + 2, "", info->threads);
-	printf("%*s\"trials\": %u\n", indent_level + 2, "", info->trials);
+	printf("%*s\"trials\": %u,\n", indent_level + 2, "", info->trials);
+	printf("%*s\"memory_budget_mb\": %u,\n", indent_level + 2, "", info->memory_budget_mb);
+	printf("%*s\"resident_mb\": %.3f,\n", indent_level + 2, "", info->resident_mb);
+	printf("%*s\"passes\": %u,\n", indent_level + 2, "", info->passes);
+	printf("%*s\"io_wait_time_s\": %.6f\n", indent_level + 2, "", info->io_wait_time_s);
+	printf("%*s}", indent_level, "");
+}
+
+/**
+ * @brief Print the load, preprocessing and compute breakdown as formatted JSON.
+ */
+static void
+print_timing(const Timing *t, int indent_level)
+{
+	printf("%*s\"timing\": {\n", indent_level, "");
+	printf("%*s\"load_time_s\": %.6f,\n", indent_level + 2, "", t->load_time_s);
+	printf("%*s\"io_time_s\": %.6f,\n", indent_level + 2, "", t->io_time_s);
+	printf("%*s\"parse_time_s\": %.6f,\n", indent_level + 2, "", t->parse_time_s);
+	printf("%*s\"build_time_s\": %.6f,\n", indent_level + 2, "", t->build_time_s);
+	printf("%*s\"normalize_time_s\": %.6f,\n", indent_level + 2, "", t->normalize_time_s);
+	printf("%*s\"pack_time_s\": %.6f,\n", indent_level + 2, "", t->pack_time_s);
+	printf("%*s\"place_time_s\": %.6f,\n", indent_level + 2, "", t->place_time_s);
+	printf("%*s\"reorder_time_s\": %.6f,\n", indent_level + 2, "", t->reorder_time_s);
+	printf("%*s\"preprocess_time_s\": %.6f,\n", indent_level + 2, "", t->preprocess_time_s);
+	printf("%*s\"plan_time_s\": %.6f,\n", indent_level + 2, "", t->plan_time_s);
+	printf("%*s\"warmup_time_s\": %.6f,\n", indent_level + 2, "", t->warmup_time_s);
+	printf("%*s\"compute_time_s\": %.6f,\n", indent_level + 2, "", t->compute_time_s);
+	printf("%*s\"end_to_end_time_s\": %.6f,\n", indent_level + 2, "", t->end_to_end_time_s);
+	printf("%*s\"trial_times_s\": [", indent_level + 2, "");
+	for (unsigned int i = 0; i < t->n_trial_times; i++)
+		printf("%s%.6f", i ? ", " : "", t->trial_times_s[i]);
+	printf("]\n");
 	printf("%*s}", indent_level, "");
 }
 
@@ -352,6 +606,14 @@ print_result(const Result *result, int indent_level)
 	printf("%*s\"algorithm\": \"%s\",\n", indent_level + 2, "", result->algorithm);
 	printf("%*s\"algorithm_variant\": %u,\n", indent_level + 2, "", result->algorithm_variant);
 	printf("%*s\"connected_components\": %u,\n", indent_level + 2, "", result->connected_components);
+	printf("%*s\"largest_component\": %zu,\n", indent_level + 2, "", result->largest_component);
+	printf("%*s\"component_size_histogram\": [", indent_level + 2, "");
+	for (unsigned int i = 0; i < result->n_size_buckets; i++)
+		printf("%s%zu", i ? ", " : "", result->component_size_histogram[i]);
+	printf("],\n");
+	printf("%*s\"rounds\": %u,\n", indent_level + 2, "", result->rounds);
+	printf("%*s\"shortcut_rounds\": %u,\n", indent_level + 2, "", result->shortcut_rounds);
+	printf("%*s\"fallback\": %u,\n", indent_level + 2, "", result->fallback);
 	printf("%*s\"statistics\": {\n", indent_level + 2, "");
 	printf("%*s\"mean_time_s\": %.6f,\n", indent_level + 4, "", result->stats.mean_time_s);
 	printf("%*s\"std_dev_s\": %.6f,\n", indent_level + 4, "", result->stats.std_dev_s);
@@ -359,7 +621,11 @@ print_result(const Result *result, int indent_level)
 	printf("%*s\"min_time_s\": %.6f,\n", indent_level + 4, "", result->stats.min_time_s);
 	printf("%*s\"max_time_s\": %.6f\n", indent_level + 4, "", result->stats.max_time_s);
 	printf("%*s},\n", indent_level + 2, "");
+	print_timing(&result->timing, indent_level + 2);
+	printf(",\n");
 	printf("%*s\"throughput_edges_per_sec\": %.2f,\n", indent_level + 2, "", result->throughput_edges_per_sec);
+	printf("%*s\"end_to_end_edges_per_sec\": %.2f,\n", indent_level + 2, "", result->end_to_end_edges_per_sec);
+	printf("%*s\"round_edges_per_sec\": %.2f,\n", indent_level + 2, "", result->round_edges_per_sec);
 	printf("%*s\"memory_peak_mb\": %.2f", indent_level + 2, "", result->memory_peak_mb);
 	
 	if (result->has_metrics) {
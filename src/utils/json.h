@@ -47,6 +47,13 @@ typedef struct {
  */
 int parse_benchmark_data(const char *json, BenchmarkData *data);
 
+/**
+ * @brief Release the memory parse_benchmark_data() allocated
+ *
+ * @param data Parsed benchmark data (the structure itself is not freed)
+ */
+void free_benchmark_data(BenchmarkData *data);
+
 /**
  * @brief Print system information as formatted JSON
  * 
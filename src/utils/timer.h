@@ -0,0 +1,22 @@
+/**
+ * @file timer.h
+ * @brief Monotonic wall-clock timing shared by the loaders and benchmarks.
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <time.h>
+
+/**
+ * @brief Returns current monotonic time in seconds.
+ */
+static inline double
+now_sec(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+#endif /* TIMER_H */